@@ -1,6 +1,23 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "benchmark/benchmark.h"
 #include "util/unify.hpp"
 
+// Directory holding the corpora; overridden by UNIFY_TEST_DATA in the
+// environment.
+#ifndef UNIFY_TEST_DATA
+#define UNIFY_TEST_DATA "test_data"
+#endif
+
 static void BM_UniFyParse(benchmark::State& state)
 {
     using   U8ToU16 = util::UniFy<char16_t, char8_t>;
@@ -20,4 +37,383 @@ static void BM_UniFyParse(benchmark::State& state)
 // Register the function as a benchmark
 BENCHMARK(BM_UniFyParse);
 
-BENCHMARK_MAIN();
+////////////////////////////////////////////////////////////////
+// Every (Dest, Src) pair in all four byte order combinations,
+// over every file in test_data/ and over synthetic text from
+// 16 B to 64 MB, e.g.
+//
+//     UniFy/u16be<-u8le/file:kermit.txt
+//     UniFy/u32le<-u16be/size/1048576
+//
+// Inputs are prepared outside the timed loop: a file is decoded
+// leniently (malformed sequences become U+FFFD, so every input is
+// valid and converted in full) and re-encoded as Src. Sizes are
+// those of the input in bytes. The byte order flags make no
+// difference to UTF-8, but are run anyway so that every pair has
+// the same four variants.
+////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+constexpr char32_t      k_Replacement   = 0xFFFD;
+constexpr std::size_t   k_Min_Synthetic = 16;
+constexpr std::size_t   k_Max_Synthetic = std::size_t(64) << 20;
+
+template<typename Type>
+constexpr const char* k_Name            = "u32";
+
+template<>
+constexpr const char* k_Name<char8_t>   = "u8";
+
+template<>
+constexpr const char* k_Name<char16_t>  = "u16";
+
+// Code points of text, one per well-formed sequence and one
+// U+FFFD per maximal malformed subpart.
+std::vector<char32_t> decode(std::string_view text)
+{
+    std::vector<char32_t>   code_points;
+    std::size_t             index   = 0;
+
+    code_points.reserve(text.size());
+
+    while (index < text.size())
+    {
+        std::uint8_t    lead    = static_cast<std::uint8_t>(text[index]);
+        std::size_t     length  = (lead < 0x80) ? 1 : (lead >= 0xC2 && lead < 0xE0) ? 2 : (lead >= 0xE0 && lead < 0xF0) ? 3 : (lead >= 0xF0 && lead < 0xF5) ? 4 : 0;
+        char32_t        value   = (length == 1) ? lead : (length == 2) ? (lead & 0x1F) : (length == 3) ? (lead & 0x0F) : (lead & 0x07);
+        std::size_t     taken   = 1;
+
+        for (; length > 1 && taken < length && index + taken < text.size(); ++taken)
+        {
+            std::uint8_t    next    = static_cast<std::uint8_t>(text[index + taken]);
+            std::uint8_t    low     = (taken == 1 && lead == 0xE0) ? 0xA0 : (taken == 1 && lead == 0xF0) ? 0x90 : 0x80;
+            std::uint8_t    high    = (taken == 1 && lead == 0xED) ? 0x9F : (taken == 1 && lead == 0xF4) ? 0x8F : 0xBF;
+
+            if (next < low || next > high)
+                break;
+
+            value   = (value << 6) | (next & 0x3F);
+        }
+
+        code_points.push_back((length != 0 && taken == length) ? value : k_Replacement);
+        index  += taken;
+    }
+
+    return code_points;
+}
+
+template<typename Type>
+Type to_order(Type unit, bool big_endian)
+{
+    if constexpr (sizeof(Type) > 1)
+    {
+        if (big_endian != (std::endian::native == std::endian::big))
+        {
+            auto value  = static_cast<std::conditional_t<sizeof(Type) == 2, std::uint16_t, std::uint32_t>>(unit);
+
+            if constexpr (sizeof(Type) == 2)
+                return static_cast<Type>(__builtin_bswap16(value));
+            else
+                return static_cast<Type>(__builtin_bswap32(value));
+        }
+    }
+
+    return unit;
+}
+
+// Appends code_point as Type units; returns the number of them.
+template<typename Type>
+std::size_t encode(std::vector<Type>& output, char32_t code_point, bool big_endian)
+{
+    Type        units[4];
+    std::size_t count   = 0;
+
+    if constexpr (sizeof(Type) == 1)
+    {
+        if (code_point < 0x80)
+        {
+            units[count++]  = static_cast<Type>(code_point);
+        }
+        else if (code_point < 0x800)
+        {
+            units[count++]  = static_cast<Type>(0xC0 | (code_point >> 6));
+            units[count++]  = static_cast<Type>(0x80 | (code_point & 0x3F));
+        }
+        else if (code_point < 0x10000)
+        {
+            units[count++]  = static_cast<Type>(0xE0 | (code_point >> 12));
+            units[count++]  = static_cast<Type>(0x80 | ((code_point >> 6) & 0x3F));
+            units[count++]  = static_cast<Type>(0x80 | (code_point & 0x3F));
+        }
+        else
+        {
+            units[count++]  = static_cast<Type>(0xF0 | (code_point >> 18));
+            units[count++]  = static_cast<Type>(0x80 | ((code_point >> 12) & 0x3F));
+            units[count++]  = static_cast<Type>(0x80 | ((code_point >> 6) & 0x3F));
+            units[count++]  = static_cast<Type>(0x80 | (code_point & 0x3F));
+        }
+    }
+    else if constexpr (sizeof(Type) == 2)
+    {
+        if (code_point < 0x10000)
+        {
+            units[count++]  = static_cast<Type>(code_point);
+        }
+        else
+        {
+            units[count++]  = static_cast<Type>(0xD800 + ((code_point - 0x10000) >> 10));
+            units[count++]  = static_cast<Type>(0xDC00 + ((code_point - 0x10000) & 0x3FF));
+        }
+    }
+    else
+    {
+        units[count++]  = static_cast<Type>(code_point);
+    }
+
+    for (std::size_t index = 0; index < count; ++index)
+        output.push_back(to_order(units[index], big_endian));
+
+    return count;
+}
+
+struct Input
+{
+    std::vector<char8_t>    u8_;
+    std::vector<char16_t>   u16_;
+    std::vector<char32_t>   u32_;
+    std::int64_t            code_points_;
+};
+
+template<typename Type>
+const std::vector<Type>& units(const Input& input)
+{
+    if constexpr (sizeof(Type) == 1)
+        return input.u8_;
+    else if constexpr (sizeof(Type) == 2)
+        return input.u16_;
+    else
+        return input.u32_;
+}
+
+template<typename Type>
+std::vector<Type>& units(Input& input)
+{
+    if constexpr (sizeof(Type) == 1)
+        return input.u8_;
+    else if constexpr (sizeof(Type) == 2)
+        return input.u16_;
+    else
+        return input.u32_;
+}
+
+template<typename Type>
+Input from_code_points(const std::vector<char32_t>& code_points, bool big_endian)
+{
+    Input   input;
+
+    for (char32_t code_point : code_points)
+        encode(units<Type>(input), code_point, big_endian);
+
+    input.code_points_  = static_cast<std::int64_t>(code_points.size());
+
+    return input;
+}
+
+// size bytes of text mixing one to four byte sequences, in runs
+// the way real text mixes scripts; topped up with ASCII so that
+// the size is exact.
+template<typename Type>
+Input synthetic(std::size_t size, bool big_endian)
+{
+    static constexpr char32_t   k_Runs[][4] =
+    {
+        { U'a', U'r', U'g', U' ' },             // Latin
+        { U'п', U'р', U'и', U'в' },             // Cyrillic, two bytes
+        { U'ह', U'ि', U'न', U'्' },             // Devanagari, three bytes
+        { U'日', U'本', U'語', U'。' },          // CJK, three bytes
+        { U'😀', U'𝄞', U'🙂', U'𐍈' }           // four bytes, surrogate pairs
+    };
+
+    Input               input;
+    std::vector<Type>&  output  = units<Type>(input);
+    std::size_t         length  = size / sizeof(Type);
+    std::uint32_t       state   = 2463534242u;
+
+    input.code_points_  = 0;
+    output.reserve(length);
+
+    while (output.size() + 4 <= length)
+    {
+        state  ^= state << 13;
+        state  ^= state >> 17;
+        state  ^= state << 5;
+
+        const char32_t* run = k_Runs[state % std::size(k_Runs)];
+
+        for (std::size_t index = 0; index < 8 && output.size() + 4 <= length; ++index, ++input.code_points_)
+            encode(output, run[index % 4], big_endian);
+    }
+
+    while (output.size() < length)
+    {
+        encode(output, U' ', big_endian);
+        ++input.code_points_;
+    }
+
+    return input;
+}
+
+template<typename Dest, typename Src, bool t_Big_Dest, bool t_Big_Src>
+void transcode(benchmark::State& state, const Input& input)
+{
+    using Transcoder    = util::UniFy<Dest, Src, t_Big_Dest, t_Big_Src>;
+
+    const std::vector<Src>& source  = units<Src>(input);
+    const std::int64_t      size    = static_cast<std::int64_t>(source.size());
+
+    // UniFy works in place on the input widened to UTF-32.
+    std::vector<char32_t>   output(source.size() + 1);
+    Dest*                   destination = reinterpret_cast<Dest*>(output.data());
+
+    for (auto _ : state)
+    {
+        auto [written, consumed] = Transcoder::transcode(destination, source.data(), size);
+
+        benchmark::DoNotOptimize(written);
+        benchmark::ClobberMemory();
+
+        if (consumed != size)
+        {
+            state.SkipWithError("input not consumed in full");
+            return;
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * size * static_cast<std::int64_t>(sizeof(Src)));
+    state.SetItemsProcessed(state.iterations() * input.code_points_);
+    state.counters["code_points/s"]     = benchmark::Counter(static_cast<double>(input.code_points_), benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["input_bytes"]       = benchmark::Counter(static_cast<double>(size * static_cast<std::int64_t>(sizeof(Src))));
+}
+
+std::string name(const char* dest, bool big_dest, const char* src, bool big_src)
+{
+    return std::string("UniFy/") + dest + (big_dest ? "be" : "le") + "<-" + src + (big_src ? "be" : "le");
+}
+
+std::vector<std::filesystem::path> corpus_files()
+{
+    const char*                         directory   = std::getenv("UNIFY_TEST_DATA");
+    std::vector<std::filesystem::path>  files;
+    std::error_code                     error;
+
+    for (auto& entry : std::filesystem::directory_iterator(directory ? directory : UNIFY_TEST_DATA, error))
+        if (entry.is_regular_file())
+            files.push_back(entry.path());
+
+    std::sort(files.begin(), files.end());
+
+    return files;
+}
+
+std::vector<char32_t> read_corpus(const std::filesystem::path& file)
+{
+    std::ifstream   stream(file, std::ios::in | std::ios::binary);
+    std::string     text((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    return decode(text);
+}
+
+// The input of the case being run. Google benchmark calls a case
+// several times while it settles on an iteration count; the input
+// is prepared on the first call and replaced when a case needs a
+// different one, so that at most one is held at a time.
+template<typename Prepare>
+const Input& prepared(const std::string& key, Prepare&& prepare)
+{
+    static std::string  current;
+    static Input        input;
+
+    if (key != current)
+    {
+        input   = Input();
+        input   = prepare();
+        current = key;
+    }
+
+    return input;
+}
+
+template<typename Dest, typename Src, bool t_Big_Dest, bool t_Big_Src>
+void register_variant(const std::vector<std::filesystem::path>& files)
+{
+    std::string prefix  = name(k_Name<Dest>, t_Big_Dest, k_Name<Src>, t_Big_Src);
+    std::string source  = std::string(k_Name<Src>) + (t_Big_Src ? "be" : "le");
+
+    for (const auto& file : files)
+    {
+        benchmark::RegisterBenchmark((prefix + "/file:" + file.filename().string()).c_str(),
+            [file, source](benchmark::State& state)
+            {
+                const Input& input = prepared(source + file.string(), [&file]()
+                    {
+                        return from_code_points<Src>(read_corpus(file), t_Big_Src);
+                    });
+
+                transcode<Dest, Src, t_Big_Dest, t_Big_Src>(state, input);
+            });
+    }
+
+    benchmark::RegisterBenchmark((prefix + "/size").c_str(),
+        [source](benchmark::State& state)
+        {
+            std::size_t     size    = static_cast<std::size_t>(state.range(0));
+            const Input&    input   = prepared(source + "/size/" + std::to_string(size), [size]()
+                {
+                    return synthetic<Src>(size, t_Big_Src);
+                });
+
+            transcode<Dest, Src, t_Big_Dest, t_Big_Src>(state, input);
+        })
+        ->RangeMultiplier(4)
+        ->Range(k_Min_Synthetic, k_Max_Synthetic);
+}
+
+template<typename Dest, typename Src>
+void register_pair(const std::vector<std::filesystem::path>& files)
+{
+    register_variant<Dest, Src, true,  true >(files);
+    register_variant<Dest, Src, true,  false>(files);
+    register_variant<Dest, Src, false, true >(files);
+    register_variant<Dest, Src, false, false>(files);
+}
+
+template<typename Dest>
+void register_destination(const std::vector<std::filesystem::path>& files)
+{
+    register_pair<Dest, char8_t >(files);
+    register_pair<Dest, char16_t>(files);
+    register_pair<Dest, char32_t>(files);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    auto    files   = corpus_files();
+
+    register_destination<char8_t >(files);
+    register_destination<char16_t>(files);
+    register_destination<char32_t>(files);
+
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
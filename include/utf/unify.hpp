@@ -2,18 +2,58 @@
 #define _UNICODE_HPP__
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <execution>
 #include <iostream>
+#include <type_traits>
 
 #include <emmintrin.h>
 #include <immintrin.h>
+#include <x86intrin.h>
 #include <xmmintrin.h>
 
 #include "util/helper_functions.hpp"
 
+// Build with -DUTF_UNIFY_PHASE_STATS to have every UniFy instantiation
+// time its phases and count its SIMD blocks, see UniFy::phase_stats().
+#if defined(UTF_UNIFY_PHASE_STATS)
+    #define UTF_UNIFY_PHASE_STATS_ENABLED   true
+#else
+    #define UTF_UNIFY_PHASE_STATS_ENABLED   false
+#endif
+
 namespace utf
 {
 
+enum class Phase : std::uint8_t
+{
+    Magnify     = 0,
+    Verify,
+    Modify,
+    Qualify,
+    Count
+};
+
+// What one UniFy instantiation has done since the program started or
+// since its reset_phase_stats(). Cycles are time stamp counter ticks,
+// which tick at a constant rate, not at the core clock.
+//
+// The block counts come from the AVX2 loops over UTF-8: magnify reads
+// 32 code units at a time and modify decodes 8 slots at a time; either
+// finds no multibyte sequence in a block and moves on, or takes the
+// multibyte branch. Other conversions leave them at zero.
+struct PhaseStats
+{
+    std::uint64_t   calls_;
+    std::uint64_t   units_;                                 // input code units
+    std::uint64_t   cycles_[util::to_index(Phase::Count)];  // per Phase
+    std::uint64_t   magnify_ascii_blocks_;
+    std::uint64_t   magnify_multibyte_blocks_;
+    std::uint64_t   modify_ascii_blocks_;
+    std::uint64_t   modify_multibyte_blocks_;
+};
+
 template<   typename DestType, 
             typename SrcType,
             bool BigEndianDest  = true,
@@ -37,6 +77,19 @@ public:
     using Result    = std::tuple<int64_t, int64_t>;
     [[nodiscard]] static Result transcode(DestType* output, const SrcType* input, const int64_t size) noexcept;
 
+    static constexpr bool k_Collect_Phase_Stats = UTF_UNIFY_PHASE_STATS_ENABLED;
+
+    // Totals of all threads; all zero unless k_Collect_Phase_Stats.
+    [[nodiscard]] static PhaseStats phase_stats() noexcept
+    {
+        return stats_.snapshot();
+    }
+
+    static void reset_phase_stats() noexcept
+    {
+        stats_.reset();
+    }
+
 protected:
     static void magnify(DestType* output, const SrcType* input, const int64_t size) noexcept;
     [[nodiscard]] static int64_t verify(DestType* output, const int64_t size) noexcept;
@@ -67,6 +120,91 @@ protected:
 
 private:
     static constexpr uint8_t k_Convertion_Factor = sizeof(char32_t) / sizeof(DestType);
+
+    enum class Counter : std::uint8_t
+    {
+        Calls   = 0,
+        Units,
+        MagnifyCycles,
+        VerifyCycles,
+        ModifyCycles,
+        QualifyCycles,
+        MagnifyAsciiBlocks,
+        MagnifyMultibyteBlocks,
+        ModifyAsciiBlocks,
+        ModifyMultibyteBlocks,
+        Count
+    };
+
+    struct Stats
+    {
+        void add(Counter counter, std::uint64_t amount) noexcept
+        {
+            counters_[util::to_index(counter)].fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        void reset() noexcept
+        {
+            for (auto& counter : counters_)
+                counter.store(0, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] PhaseStats snapshot() const noexcept
+        {
+            auto get = [this](Counter counter) noexcept
+                {
+                    return counters_[util::to_index(counter)].load(std::memory_order_relaxed);
+                };
+
+            return PhaseStats {
+                get(Counter::Calls),
+                get(Counter::Units),
+                { get(Counter::MagnifyCycles), get(Counter::VerifyCycles), get(Counter::ModifyCycles), get(Counter::QualifyCycles) },
+                get(Counter::MagnifyAsciiBlocks),
+                get(Counter::MagnifyMultibyteBlocks),
+                get(Counter::ModifyAsciiBlocks),
+                get(Counter::ModifyMultibyteBlocks) };
+        }
+
+        std::atomic<std::uint64_t>  counters_[util::to_index(Counter::Count)] {};
+    };
+
+    struct NoStats
+    {
+        void add(Counter, std::uint64_t) noexcept
+        {}
+
+        void reset() noexcept
+        {}
+
+        [[nodiscard]] PhaseStats snapshot() const noexcept
+        {
+            return PhaseStats {};
+        }
+    };
+
+    // Time stamp counter, fenced so that it is read after the phase
+    // before it has finished and before the next one starts.
+    static std::uint64_t stamp() noexcept
+    {
+        if constexpr (k_Collect_Phase_Stats)
+        {
+            _mm_lfence();
+            std::uint64_t tsc   = __rdtsc();
+            _mm_lfence();
+
+            return tsc;
+        }
+
+        return 0;
+    }
+
+    static void count(Counter counter, std::uint64_t amount = 1) noexcept
+    {
+        stats_.add(counter, amount);
+    }
+
+    static inline std::conditional_t<k_Collect_Phase_Stats, Stats, NoStats>  stats_;
 };
 
 template<   typename DestType, 
@@ -89,14 +227,33 @@ template<   typename DestType,
 [[nodiscard]] UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>::Result
 UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>::transcode(DestType* output, const SrcType* input, const int64_t size) noexcept
 {
+    std::uint64_t   begin       = stamp();
+
     magnify(output, input, size);
 
+    std::uint64_t   magnified   = stamp();
+
     //return Result(size * 4, size / k_Convertion_Factor);
     int64_t invalid_index  = verify(output, size);
 
+    std::uint64_t   verified    = stamp();
+
     modify(output, invalid_index);
 
-    return qualify(output, invalid_index);
+    std::uint64_t   modified    = stamp();
+
+    Result  result  = qualify(output, invalid_index);
+
+    std::uint64_t   qualified   = stamp();
+
+    count(Counter::Calls);
+    count(Counter::Units, static_cast<std::uint64_t>(size));
+    count(Counter::MagnifyCycles, magnified - begin);
+    count(Counter::VerifyCycles, verified - magnified);
+    count(Counter::ModifyCycles, modified - verified);
+    count(Counter::QualifyCycles, qualified - modified);
+
+    return result;
 }
 
 template<   typename DestType, 
@@ -500,10 +657,16 @@ void UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>::native_u
 
     int64_t index   = 0;
 
+    // Counted locally and added once, after the loop.
+    std::uint64_t   blocks              = 0;
+    std::uint64_t   multibyte_blocks    = 0;
+
     while (index + 32 < size)
     {
         __m256i input_block     = _mm256_loadu_si256((const __m256i*)(input + index));
 
+        blocks++;
+
         __m256i first_half, second_half, first_qtr, second_qtr, third_qtr, forth_qtr;
 
         get_halves16(input_block, first_half, second_half, zero);
@@ -520,6 +683,8 @@ void UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>::native_u
                 (_mm256_testc_si256(zero, three_bytes_seq) != 1)  ||
                 (_mm256_testc_si256(zero, four_bytes_seq) != 1)  )
         {
+            multibyte_blocks++;
+
             __m256i first_half_4bs, second_half_4bs;
             __m256i first_half_3bs, second_half_3bs;
             __m256i first_half_2bs, second_half_2bs;
@@ -599,6 +764,9 @@ void UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>::native_u
         index -= decrement;
     }
 
+    count(Counter::MagnifyAsciiBlocks, blocks - multibyte_blocks);
+    count(Counter::MagnifyMultibyteBlocks, multibyte_blocks);
+
     while (index < size)
     {
         //*(reinterpret_cast<char32_t*>(output) + index)  = static_cast<char32_t>(*(input + index));
@@ -1253,9 +1421,14 @@ void UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>::modify_u
 
     char32_t* output32_p        = reinterpret_cast<char32_t*>(output);
 
+    std::uint64_t   blocks          = 0;
+    std::uint64_t   ascii_blocks    = 0;
+
     while (index + 8 < size)
     {
         __m256i input_block         = _mm256_loadu_si256((const __m256i*)(output32_p + index));
+
+        blocks++;
         __m256i empty_mask          = _mm256_cmpeq_epi32(empty_slots, input_block);
         __m256i data                = _mm256_andnot_si256(empty_mask, input_block);
         __m256i empty_data          = _mm256_and_si256(empty_mask, input_block);
@@ -1268,6 +1441,7 @@ void UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>::modify_u
 
         if (_mm256_testc_si256(zero, mbs_data) == 1)
         {
+            ascii_blocks++;
             index += 8;
             continue;
         }
@@ -1313,6 +1487,9 @@ void UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>::modify_u
         index += 8;
     }
 
+    count(Counter::ModifyAsciiBlocks, ascii_blocks);
+    count(Counter::ModifyMultibyteBlocks, blocks - ascii_blocks);
+
     while (index < size)
     {
         char32_t value  = static_cast<char32_t>(*(output32_p + index));
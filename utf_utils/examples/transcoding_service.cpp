@@ -0,0 +1,281 @@
+//--------------------------------------------------------------------------------------------------
+//  A local transcoding service: client processes hand UTF-8 to one dedicated transcoder process
+//  and get UTF-16 back, through a pair of util::SharedRingBuffer segments per client.  Clients
+//  write UTF-8 straight into the request ring, the transcoder converts from the request ring
+//  directly into the response ring, and clients consume UTF-16 in place; no other copies are
+//  made.  Pass a CPU number to pin the transcoder, keeping the SIMD-heavy work on its own core.
+//
+//      transcoding_service <utf8_file> [clients] [rounds] [transcoder_cpu]
+//--------------------------------------------------------------------------------------------------
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "utf_utils.h"
+#include "util/shared_ring_buffer.hpp"
+
+using namespace std;
+using uu::UtfUtils;
+
+using RequestRing   = util::SharedRingBuffer<char8_t, uint32_t, (1u << 20)>;
+using ResponseRing  = util::SharedRingBuffer<char16_t, uint32_t, (1u << 20)>;
+
+struct Client
+{
+    unique_ptr<RequestRing>     requests;
+    unique_ptr<ResponseRing>    responses;
+    pid_t                       pid;
+    bool                        done;
+};
+
+//--------------
+//
+string
+LoadFile(string const& filename)
+{
+    string      data;
+    ifstream    in(filename, ios::in | ios::binary);
+
+    if (in)
+    {
+        in.seekg(0, ios_base::end);
+        data.resize((size_t) in.tellg());
+        in.seekg(0, ios_base::beg);
+        in.read(&data[0], data.size());
+    }
+    return data;
+}
+
+//--------------
+//  Largest prefix of [src, src + size) no longer than limit that ends on a code point boundary.
+//
+size_t
+SequencePrefix(char8_t const* src, size_t size, size_t limit)
+{
+    size_t  length = min(size, limit);
+
+    while (length > 0  &&  length < size  &&  (src[length] & 0xC0) == 0x80)
+    {
+        --length;
+    }
+    return length;
+}
+
+//--------------
+//  Client side: send the file `rounds` times and check every UTF-16 code unit that comes back.
+//
+int
+RunClient(int request_fd, int response_fd, u8string const& text, u16string const& expected, size_t rounds)
+{
+    RequestRing     requests(request_fd);
+    ResponseRing    responses(response_fd);
+
+    if (!requests.claim(RequestRing::Role::Producer)  ||  !responses.claim(ResponseRing::Role::Consumer))
+    {
+        return 2;
+    }
+
+    size_t const    total       = rounds * expected.size();
+    size_t          sent        = 0;
+    size_t          rounds_sent = 0;
+    size_t          received    = 0;
+    size_t          mismatches  = 0;
+
+    while (received < total)
+    {
+        bool    idle = true;
+
+        if (rounds_sent < rounds)
+        {
+            auto    request = requests.buffer(static_cast<uint32_t>(text.size() - sent));
+            size_t  length  = SequencePrefix(text.data() + sent, text.size() - sent, request.capacity());
+
+            //- A real producer would recv() into request.data(); the copy stands in for that.
+            memcpy(request.data(), text.data() + sent, length);
+            request.size(static_cast<uint32_t>(length));
+
+            if ((sent += length) == text.size())
+            {
+                sent = 0;
+                ++rounds_sent;
+            }
+            idle = (length == 0);
+        }
+
+        auto    response = responses.read_block();
+
+        for (uint32_t i = 0;  i < response.capacity();  ++i, ++received)
+        {
+            mismatches += (response.data()[i] != expected[received % expected.size()]);
+        }
+        response.size(response.capacity());
+
+        if (idle  &&  response.capacity() == 0)
+        {
+            this_thread::yield();
+        }
+    }
+
+    requests.leave(RequestRing::Role::Producer);
+    responses.leave(ResponseRing::Role::Consumer);
+
+    return (mismatches == 0) ? 0 : 1;
+}
+
+//--------------
+//  Transcoder side: one conversion step for one client; returns the number of bytes consumed.
+//
+size_t
+Serve(Client& client)
+{
+    auto    request = client.requests->read_block();
+
+    if (request.capacity() == 0)
+    {
+        return 0;
+    }
+
+    //- A UTF-8 code unit never yields more than one UTF-16 code unit.
+    //
+    auto    response    = client.responses->buffer(request.capacity());
+    size_t  length      = SequencePrefix(request.data(), request.capacity(), response.capacity());
+
+    if (length == 0)
+    {
+        request.size(0);
+        return 0;
+    }
+
+    ptrdiff_t   units = UtfUtils::SseBigTableConvert(request.data(), request.data() + length, response.data());
+
+    if (units < 0)
+    {
+        fprintf(stderr, "invalid UTF-8 from client %d\n", (int) client.pid);
+        exit(EXIT_FAILURE);
+    }
+
+    response.size(static_cast<uint32_t>(units));
+    request.size(static_cast<uint32_t>(length));
+
+    return length;
+}
+
+//--------------
+//
+int
+main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <utf8_file> [clients] [rounds] [transcoder_cpu]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    string const    file    = LoadFile(argv[1]);
+    size_t const    clients = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 2;
+    size_t const    rounds  = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 100;
+    int const       cpu     = (argc > 4) ? atoi(argv[4]) : -1;
+
+    u8string        text(file.begin(), file.end());
+    u16string       expected(text.size(), u'\0');
+    ptrdiff_t       units = UtfUtils::SseBigTableConvert(text.data(), text.data() + text.size(), &expected[0]);
+
+    if (text.empty()  ||  units < 0)
+    {
+        fprintf(stderr, "%s: empty or not valid UTF-8\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    expected.resize(units);
+
+    vector<Client>  pool(clients);
+
+    for (auto& client : pool)
+    {
+        client.requests     = make_unique<RequestRing>(RequestRing::Layout::Transit);
+        client.responses    = make_unique<ResponseRing>(ResponseRing::Layout::Transit);
+        client.done         = false;
+
+        if ((client.pid = fork()) == 0)
+        {
+            //- Map the segments afresh, at addresses of the child's choosing.
+            _exit(RunClient(client.requests->fd(), client.responses->fd(), text, expected, rounds));
+        }
+    }
+
+    if (cpu >= 0)
+    {
+        cpu_set_t   set;
+
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+
+    auto        start       = chrono::steady_clock::now();
+    size_t      bytes       = 0;
+    size_t      remaining   = clients;
+    int         failures    = 0;
+
+    for (auto& client : pool)
+    {
+        if (!client.requests->claim(RequestRing::Role::Consumer)  ||  !client.responses->claim(ResponseRing::Role::Producer))
+        {
+            fprintf(stderr, "rings of client %d are already served\n", (int) client.pid);
+            return EXIT_FAILURE;
+        }
+    }
+
+    while (remaining > 0)
+    {
+        size_t  progress = 0;
+
+        for (auto& client : pool)
+        {
+            if (client.done)
+            {
+                continue;
+            }
+
+            size_t  consumed = Serve(client);
+            int     status;
+
+            //- A client is finished once its process is gone and its requests are drained,
+            //  whether it exited normally or died half way.
+            //
+            if (consumed == 0  &&  waitpid(client.pid, &status, WNOHANG) == client.pid)
+            {
+                client.done = true;
+                failures   += !(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+                --remaining;
+            }
+
+            progress += consumed;
+        }
+
+        bytes += progress;
+
+        if (progress == 0)
+        {
+            this_thread::yield();
+        }
+    }
+
+    double  seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    printf("%zu clients, %zu bytes transcoded in %.3f s (%.1f MB/s), %d failed\n",
+           clients, bytes, seconds, bytes / seconds / 1.0e6, failures);
+
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,482 @@
+#ifndef _ASYNC_LOGGER_HPP__
+#define _ASYNC_LOGGER_HPP__
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "util/buffer_policies.hpp"
+#include "util/char_stream.hpp"
+#include "util/record_ring.hpp"
+#include "util/ring_buffer.hpp"
+#include "util/transcoding_stage.hpp"
+
+namespace util
+{
+
+// Logging off the critical path. Every thread formats its records
+// through a CharStream straight into a ring of its own (a mirrored
+// SPSC RingBuffer of length-prefixed records, see record_ring.hpp),
+// stamped with the time log() was called. A background thread
+// merges the rings in timestamp order, transcodes the text to
+// OutType with UniFy and writes it, one line per record, with
+// writev(): UTF-8 straight from the rings, other encodings from a
+// staging area.
+//
+// The order holds across batches too. log() announces a record
+// in its slot before stamping it, and the writer holds back every
+// record newer than the oldest one still being formatted, so that
+// a record committed late never follows a newer one out. The
+// price is one seq_cst store per record (an xchg on x86), and a
+// Record kept alive beyond its statement holds back the output of
+// all threads until it ends.
+//
+// A logging thread takes no lock and makes no system call, except
+// once to set up its ring (do it early with attach()); when its
+// ring is full the record is dropped and counted rather than
+// waited for. At most t_Max_Threads threads get a ring; records
+// from any further thread are dropped as well.
+//
+// Size t_Ring_Size for the bursts: a ring must hold whatever its
+// thread logs faster than the writer drains it, and the writer
+// sleeps for idle whenever it has caught up. A record takes its
+// text plus a dozen bytes, so the default 64 KiB holds one to
+// two thousand short ones; a thread that logs tens of thousands
+// of records in a burst needs a ring that fits the burst (4 MiB
+// for 50,000 such records) or loses the rest.
+//
+//      logger.log() << "filled " << quantity << " @ " << FixedPoint<4>{price};
+template<typename OutType = char8_t, std::uint32_t t_Ring_Size = (1u << 16), std::size_t t_Max_Threads = 64>
+class AsyncLogger
+{
+public:
+    using Ring      = RingBuffer<char, std::uint32_t, t_Ring_Size, SpscPolicy, MirroredPolicy>;
+    using Records   = RecordRing<Ring>;
+    using Clock     = std::chrono::steady_clock;
+
+    // Text of one record, excluding its timestamp; longer records
+    // are cut.
+    static constexpr std::uint32_t  k_Max_Record    = 1024;
+    static constexpr std::size_t    k_Batch         = 64;
+
+private:
+    using Stamp     = Clock::rep;
+
+    // Slot::in_flight_ when no record is being formatted, and
+    // while log() has yet to stamp one.
+    static constexpr Stamp  k_Idle      = std::numeric_limits<Stamp>::max();
+    static constexpr Stamp  k_Pending   = std::numeric_limits<Stamp>::min();
+
+    static_assert(t_Ring_Size >= 2 * Records::footprint(sizeof(Stamp) + k_Max_Record), "ring too small for a record");
+
+    struct Slot
+    {
+        Ring                                                ring_;
+        Records                                             records_{ring_};
+        alignas(k_Cache_Line_Size) std::atomic<std::uint64_t> committed_{0};
+        std::atomic<std::uint64_t>                          dropped_{0};
+        std::atomic<Stamp>                                  in_flight_{k_Idle};
+        alignas(k_Cache_Line_Size) std::atomic<std::uint64_t> drained_{0};
+    };
+
+public:
+    // A record under construction; committed when it goes out of
+    // scope, i.e. at the end of the statement that called log().
+    class Record
+    {
+    public:
+        template<typename Value>
+        Record& operator<<(Value&& value)
+        {
+            stream_ << std::forward<Value>(value);
+            return *this;
+        }
+
+        ~Record() noexcept
+        {
+            if (slot_ == nullptr)
+                return;
+
+            slot_->records_.end_record(static_cast<std::uint32_t>(sizeof(Stamp) + stream_.length()));
+            slot_->committed_.store(slot_->committed_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            slot_->in_flight_.store(k_Idle, std::memory_order_release);
+        }
+
+        Record(const Record&)               = delete;
+        Record& operator=(const Record&)    = delete;
+
+    private:
+        friend class AsyncLogger;
+
+        Record(Slot* slot, char* text, int size) noexcept
+            : slot_(slot)
+            , stream_(text, size)
+        {}
+
+        Slot*               slot_;
+        CharStream<char*>   stream_;
+    };
+
+    // Writes to fd, which stays owned by the caller; the background
+    // thread sleeps for idle whenever it finds nothing to write.
+    explicit AsyncLogger(int fd, std::chrono::microseconds idle = std::chrono::microseconds(200))
+        : fd_(fd)
+        , id_(next_id().fetch_add(1, std::memory_order_relaxed) + 1)
+        , idle_(idle)
+        , threads_(0)
+        , overflow_(0)
+        , stop_(false)
+        , write_errors_(0)
+    {
+        for (auto& slot : slots_)
+            slot.store(nullptr, std::memory_order_relaxed);
+
+        writer_ = std::thread([this]() { run(); });
+    }
+
+    // Writes everything logged so far. No thread may log once the
+    // destructor has started.
+    ~AsyncLogger() noexcept
+    {
+        stop_.store(true, std::memory_order_release);
+        writer_.join();
+    }
+
+    AsyncLogger(const AsyncLogger&)             = delete;
+    AsyncLogger& operator=(const AsyncLogger&)  = delete;
+
+    [[nodiscard]] Record log()
+    {
+        Slot* slot = local_slot();
+
+        if (slot != nullptr)
+        {
+            auto text = slot->records_.begin_record(sizeof(Stamp) + k_Max_Record);
+
+            if (!text.empty())
+            {
+                // Announced before it is stamped; see drain().
+                slot->in_flight_.store(k_Pending, std::memory_order_seq_cst);
+
+                Stamp stamp = Clock::now().time_since_epoch().count();
+
+                slot->in_flight_.store(stamp, std::memory_order_relaxed);
+                std::memcpy(text.data(), &stamp, sizeof(Stamp));
+                return Record(slot, text.data() + sizeof(Stamp), static_cast<int>(k_Max_Record));
+            }
+
+            slot->dropped_.store(slot->dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        else
+        {
+            overflow_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return Record(nullptr, discard_, 0);
+    }
+
+    // Sets up the calling thread's ring ahead of its first record;
+    // false if all t_Max_Threads rings are taken. May throw
+    // std::system_error if the ring can't be mapped.
+    bool attach()
+    {
+        return local_slot() != nullptr;
+    }
+
+    // Blocks until every record committed before the call has been
+    // written.
+    void flush() const noexcept
+    {
+        std::size_t     count   = threads();
+        std::uint64_t   target[t_Max_Threads];
+
+        for (std::size_t index = 0; index < count; ++index)
+            target[index] = slot(index) ? slot(index)->committed_.load(std::memory_order_acquire) : 0;
+
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            while (slot(index) && slot(index)->drained_.load(std::memory_order_acquire) < target[index])
+                std::this_thread::sleep_for(idle_);
+        }
+    }
+
+    // Records lost to full rings or to threads beyond t_Max_Threads.
+    [[nodiscard]] std::uint64_t dropped() const noexcept
+    {
+        std::uint64_t total = overflow_.load(std::memory_order_relaxed);
+
+        for (std::size_t index = 0; index < threads(); ++index)
+            total += slot(index) ? slot(index)->dropped_.load(std::memory_order_relaxed) : 0;
+
+        return total;
+    }
+
+    [[nodiscard]] std::uint64_t write_errors() const noexcept
+    {
+        return write_errors_.load(std::memory_order_relaxed);
+    }
+
+protected:
+    // UTF-8 in, OutType out, in native byte order.
+    using Transcoder    = UniFy<OutType, char8_t, false, false>;
+    using Traits        = TranscoderTraits<Transcoder>;
+
+    static constexpr bool           k_Direct        = std::is_same_v<OutType, char8_t>;
+
+    // Staging per record, in char32_t units so that every record
+    // starts aligned for UniFy: its text, widened, and a newline.
+    static constexpr std::size_t    k_Stage_Record  = (k_Max_Record * Traits::k_Output_Factor * sizeof(OutType) + sizeof(OutType) + sizeof(char32_t) - 1) / sizeof(char32_t);
+
+    static std::atomic<std::uint64_t>& next_id() noexcept
+    {
+        static std::atomic<std::uint64_t> id {0};
+        return id;
+    }
+
+    [[nodiscard]] std::size_t threads() const noexcept
+    {
+        std::size_t count = threads_.load(std::memory_order_acquire);
+        return (count < t_Max_Threads) ? count : t_Max_Threads;
+    }
+
+    [[nodiscard]] Slot* slot(std::size_t index) const noexcept
+    {
+        return slots_[index].load(std::memory_order_acquire);
+    }
+
+    // The calling thread's slot, taken on its first record. Each
+    // thread keeps one entry per logger it has logged to, the last
+    // one used first, so that a thread alternating between loggers
+    // finds its slots again instead of taking new ones. Loggers are
+    // told apart by id_ rather than address, which may be reused;
+    // entries of destroyed loggers are simply never matched again.
+    Slot* local_slot()
+    {
+        struct Entry
+        {
+            std::uint64_t   logger_;
+            Slot*           slot_;
+        };
+
+        static thread_local std::vector<Entry> entries;
+
+        if (LIKELY(!entries.empty() && entries.front().logger_ == id_))
+            return entries.front().slot_;
+
+        for (auto& entry : entries)
+        {
+            if (entry.logger_ == id_)
+            {
+                std::swap(entry, entries.front());
+                return entries.front().slot_;
+            }
+        }
+
+        std::size_t index   = threads_.fetch_add(1, std::memory_order_acq_rel);
+        Slot*       slot    = nullptr;
+
+        if (index < t_Max_Threads)
+        {
+            owned_[index]   = std::make_unique<Slot>();
+            slot            = owned_[index].get();
+            slots_[index].store(slot, std::memory_order_release);
+        }
+
+        entries.push_back(Entry{id_, slot});
+        std::swap(entries.back(), entries.front());
+
+        return slot;
+    }
+
+    void run() noexcept
+    {
+        for (;;)
+        {
+            // Read the flag first: whatever was committed before it
+            // was set is seen by the drain that follows.
+            bool stopping = stop_.load(std::memory_order_acquire);
+
+            while (drain() > 0)
+                ;
+
+            if (stopping)
+                return;
+
+            std::this_thread::sleep_for(idle_);
+        }
+    }
+
+    // Writes up to k_Batch records, oldest first; returns how many.
+    //
+    // Only records stamped no later than the horizon are written:
+    // the time the drain started, or the stamp of the oldest record
+    // still being formatted if that is earlier. A record whose
+    // announcement the drain missed was stamped after the drain
+    // started, so it is newer than anything written now.
+    std::size_t drain() noexcept
+    {
+        using Head  = std::tuple<std::span<const char>, std::uint32_t>;
+
+        std::size_t     count       = threads();
+        Head            heads[t_Max_Threads];
+        std::uint32_t   offsets[t_Max_Threads];
+        std::uint64_t   taken[t_Max_Threads];
+        Stamp           horizon     = Clock::now().time_since_epoch().count();
+
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            Stamp pending   = slot(index) ? slot(index)->in_flight_.load(std::memory_order_seq_cst) : k_Idle;
+
+            if (pending < horizon)
+                horizon = pending;
+        }
+
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            offsets[index]  = 0;
+            taken[index]    = 0;
+            heads[index]    = slot(index) ? slot(index)->records_.record_at(0) : Head();
+        }
+
+        iovec           vectors[2 * k_Batch];
+        std::size_t     vector_count    = 0;
+        std::size_t     records         = 0;
+
+        if constexpr (!k_Direct)
+            staging_.resize(k_Batch * k_Stage_Record);
+
+        while (records < k_Batch)
+        {
+            std::size_t oldest  = count;
+            Stamp       stamp   = 0;
+
+            for (std::size_t index = 0; index < count; ++index)
+            {
+                auto& [payload, size] = heads[index];
+
+                if (payload.data() == nullptr)
+                    continue;
+
+                Stamp candidate;
+                std::memcpy(&candidate, payload.data(), sizeof(Stamp));
+
+                if (oldest == count || candidate < stamp)
+                {
+                    oldest  = index;
+                    stamp   = candidate;
+                }
+            }
+
+            if (oldest == count || stamp > horizon)
+                break;
+
+            auto [payload, size]    = heads[oldest];
+            const char*     text    = payload.data() + sizeof(Stamp);
+            std::size_t     length  = payload.size() - sizeof(Stamp);
+
+            if constexpr (k_Direct)
+            {
+                static const char k_Newline = '\n';
+
+                vectors[vector_count++] = iovec{const_cast<char*>(text), length};
+                vectors[vector_count++] = iovec{const_cast<char*>(&k_Newline), 1};
+            }
+            else
+            {
+                OutType*    output  = reinterpret_cast<OutType*>(staging_.data() + records * k_Stage_Record);
+                auto [written, consumed] = Transcoder::transcode(output, reinterpret_cast<const char8_t*>(text), static_cast<int64_t>(length));
+
+                (void) consumed;
+                output[written]         = OutType('\n');
+                vectors[vector_count++] = iovec{output, static_cast<std::size_t>(written + 1) * sizeof(OutType)};
+            }
+
+            offsets[oldest]    += size;
+            taken[oldest]      += 1;
+            heads[oldest]       = slot(oldest)->records_.record_at(offsets[oldest]);
+            ++records;
+        }
+
+        if (records == 0)
+            return 0;
+
+        write_all(vectors, vector_count);
+
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            if (taken[index] == 0)
+                continue;
+
+            Slot* owner = slot(index);
+
+            owner->records_.release_records(offsets[index]);
+            owner->drained_.store(owner->drained_.load(std::memory_order_relaxed) + taken[index], std::memory_order_release);
+        }
+
+        return records;
+    }
+
+    void write_all(iovec* vectors, std::size_t count) noexcept
+    {
+        while (count > 0)
+        {
+            ssize_t written = ::writev(fd_, vectors, static_cast<int>(count < IOV_MAX ? count : IOV_MAX));
+
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                write_errors_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            // Skip what was written, possibly part of a vector.
+            while (count > 0 && static_cast<std::size_t>(written) >= vectors->iov_len)
+            {
+                written    -= static_cast<ssize_t>(vectors->iov_len);
+                ++vectors;
+                --count;
+            }
+
+            if (count > 0)
+            {
+                vectors->iov_base   = static_cast<char*>(vectors->iov_base) + written;
+                vectors->iov_len   -= static_cast<std::size_t>(written);
+            }
+        }
+    }
+
+private:
+    int                                 fd_;
+    const std::uint64_t                 id_;
+    const std::chrono::microseconds     idle_;
+    std::atomic<std::size_t>            threads_;
+    std::atomic<Slot*>                  slots_[t_Max_Threads];
+    std::unique_ptr<Slot>               owned_[t_Max_Threads];
+    std::atomic<std::uint64_t>          overflow_;
+    std::atomic<bool>                   stop_;
+    std::atomic<std::uint64_t>          write_errors_;
+    std::vector<char32_t>               staging_;
+    std::thread                         writer_;
+
+    // Target of records that are dropped.
+    static inline char                  discard_[1];
+};
+
+}
+
+#endif // _ASYNC_LOGGER_HPP__
@@ -2,14 +2,68 @@
 #define _ATOMIC_LOCK_HPP__
 
 #include <atomic>
+#include <cstdint>
 #include <mutex>
+#include <thread>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "util/helper_functions.hpp"
+
+// Build with -DUTIL_ATOMIC_LOCK_STATS to have every AtomicLock keep
+// its own contention counters.
+#if defined(UTIL_ATOMIC_LOCK_STATS)
+    #define UTIL_ATOMIC_LOCK_STATS_ENABLED  true
+#else
+    #define UTIL_ATOMIC_LOCK_STATS_ENABLED  false
+#endif
 
 namespace util
 {
 
+inline void cpu_relax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+struct AtomicLockStats
+{
+    std::uint64_t   acquisitions_;
+    std::uint64_t   contended_;
+    std::uint64_t   spins_;
+    std::uint64_t   parks_;
+};
+
+// Per-instance test-and-test-and-set lock. A contended lock()
+// spins on a plain load with exponentially growing pause runs;
+// once the spin budget is spent the thread parks on a futex
+// until unlock() wakes it.
+//
+// state_ is 0 when free, 1 when held and 2 when held with
+// (possible) sleepers, so an uncontended unlock() never makes
+// a system call.
 class AtomicLock
 {
 public:
+    static constexpr bool           k_Collect_Stats = UTIL_ATOMIC_LOCK_STATS_ENABLED;
+    static constexpr std::uint32_t  k_Spin_Budget   = 1 << 10;
+    static constexpr std::uint32_t  k_Max_Backoff   = 1 << 6;
+
     AtomicLock()
     {}
 
@@ -18,18 +72,153 @@ public:
     AtomicLock& operator=(const AtomicLock&)    = delete;
     AtomicLock& operator=(AtomicLock&&)         = delete;
 
-    void lock()
+    void lock() noexcept
     {
-        while (std::atomic_flag_test_and_set_explicit(&is_locked_, std::memory_order_acquire))
-            __asm__("nop");
+        std::uint32_t expected = k_Free;
+
+        if (LIKELY(state_.compare_exchange_strong(expected, k_Locked, std::memory_order_acquire, std::memory_order_relaxed)))
+        {
+            count(Counter::Acquisitions);
+            return;
+        }
+
+        lock_contended();
     }
 
-    void unlock()
+    [[nodiscard]] bool try_lock() noexcept
     {
-        std::atomic_flag_clear_explicit(&is_locked_, std::memory_order_release);
+        std::uint32_t expected = k_Free;
+
+        if (state_.compare_exchange_strong(expected, k_Locked, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            count(Counter::Acquisitions);
+            return true;
+        }
+
+        return false;
+    }
+
+    void unlock() noexcept
+    {
+        if (UNLIKELY(state_.exchange(k_Free, std::memory_order_release) == k_Sleeping))
+            wake();
+    }
+
+    // Snapshot of the counters; all zero unless k_Collect_Stats.
+    [[nodiscard]] decltype(auto) stats() const noexcept
+    {
+        return stats_.snapshot();
     }
+
 private:
-    static std::atomic_flag is_locked_;
+    static constexpr std::uint32_t  k_Free      = 0;
+    static constexpr std::uint32_t  k_Locked    = 1;
+    static constexpr std::uint32_t  k_Sleeping  = 2;
+
+    enum class Counter : std::uint8_t
+    {
+        Acquisitions    = 0,
+        Contended,
+        Spins,
+        Parks
+    };
+
+    struct Stats
+    {
+        void add(Counter counter, std::uint64_t amount) noexcept
+        {
+            counters_[to_index(counter)].fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] AtomicLockStats snapshot() const noexcept
+        {
+            return AtomicLockStats {
+                counters_[to_index(Counter::Acquisitions)].load(std::memory_order_relaxed),
+                counters_[to_index(Counter::Contended)].load(std::memory_order_relaxed),
+                counters_[to_index(Counter::Spins)].load(std::memory_order_relaxed),
+                counters_[to_index(Counter::Parks)].load(std::memory_order_relaxed) };
+        }
+
+        std::atomic<std::uint64_t>  counters_[4] {};
+    };
+
+    struct NoStats
+    {
+        void add(Counter, std::uint64_t) noexcept
+        {}
+
+        [[nodiscard]] AtomicLockStats snapshot() const noexcept
+        {
+            return AtomicLockStats {};
+        }
+    };
+
+    void count(Counter counter, std::uint64_t amount = 1) noexcept
+    {
+        stats_.add(counter, amount);
+    }
+
+    void lock_contended() noexcept
+    {
+        std::uint32_t spins     = 0;
+        std::uint32_t backoff   = 1;
+
+        count(Counter::Contended);
+
+        while (spins < k_Spin_Budget)
+        {
+            if (state_.load(std::memory_order_relaxed) == k_Free)
+            {
+                std::uint32_t expected = k_Free;
+
+                if (state_.compare_exchange_weak(expected, k_Locked, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    count(Counter::Acquisitions);
+                    count(Counter::Spins, spins);
+                    return;
+                }
+            }
+
+            for (std::uint32_t i = 0; i < backoff; ++i)
+                cpu_relax();
+
+            spins      += backoff;
+            backoff     = (backoff < k_Max_Backoff) ? backoff << 1 : backoff;
+        }
+
+        count(Counter::Spins, spins);
+
+        // From here on the lock is only ever taken in the sleeping
+        // state, so that our unlock() wakes whoever parked after us.
+        while (state_.exchange(k_Sleeping, std::memory_order_acquire) != k_Free)
+        {
+            count(Counter::Parks);
+            park();
+        }
+
+        count(Counter::Acquisitions);
+    }
+
+    void park() noexcept
+    {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&state_), FUTEX_WAIT_PRIVATE, k_Sleeping, nullptr, nullptr, 0);
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    void wake() noexcept
+    {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&state_), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+    }
+
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex word must be a plain 32-bit integer");
+
+    std::atomic<std::uint32_t>  state_{k_Free};
+    [[no_unique_address]] std::conditional_t<k_Collect_Stats, Stats, NoStats>   stats_;
 };
 
 }
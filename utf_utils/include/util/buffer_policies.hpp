@@ -0,0 +1,114 @@
+#ifndef _BUFFER_POLICIES_HPP__
+#define _BUFFER_POLICIES_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace util
+{
+    // Size assumed for a cache line when separating data
+    // written by different threads.
+    inline constexpr std::size_t k_Cache_Line_Size  = 64;
+
+    // Policy tags, passed as the trailing template arguments
+    // of RingBuffer and TransitBuffer.
+
+    // Exactly one thread reserves/commits and exactly one
+    // thread reads/releases; no lock is taken.
+    struct SpscPolicy {};
+
+    // With SpscPolicy: back the buffer with MirroredStorage, so
+    // that every reservation and every readable block is one
+    // contiguous span, including at the wrap point.
+    struct MirroredPolicy {};
+
+    // Any number of threads reserve/commit and any number read/
+    // release; slots are claimed through per-slot sequence numbers.
+    struct MpmcPolicy {};
+
+    // Keep occupancy, wrap and stall counters per buffer, read
+    // through telemetry().snapshot(); see buffer_telemetry.hpp.
+    struct TelemetryPolicy {};
+
+    template<typename Policy, typename... Policies>
+    inline constexpr bool has_policy_v  = (std::is_same_v<Policy, Policies> || ...);
+
+    // Allocation policies; any of them switches the element
+    // storage from std::vector to MappedStorage. They combine
+    // freely with each other and with SpscPolicy/MpmcPolicy.
+
+    enum class HugePages : std::uint8_t
+    {
+        None        = 0,
+        Transparent,        // madvise(MADV_HUGEPAGE), THP
+        Size2M,             // MAP_HUGETLB | MAP_HUGE_2MB
+        Size1G              // MAP_HUGETLB | MAP_HUGE_1GB
+    };
+
+    template<HugePages t_Huge_Pages = HugePages::Size2M>
+    struct HugePagePolicy {};
+
+    // Bind the buffer's pages to one NUMA node (mbind, MPOL_BIND).
+    template<int t_Node>
+    struct NumaNodePolicy {};
+
+    // Leave trivially constructible elements as the kernel hands
+    // them out instead of writing every element up front; pages
+    // are then faulted in on first use.
+    struct NoZeroInitPolicy {};
+
+    template<typename Policy>
+    struct AllocationPolicyTraits
+    {
+        static constexpr HugePages  k_Huge_Pages    = HugePages::None;
+        static constexpr int        k_Numa_Node     = -1;
+        static constexpr bool       k_No_Zero_Init  = false;
+    };
+
+    template<HugePages t_Huge_Pages>
+    struct AllocationPolicyTraits<HugePagePolicy<t_Huge_Pages>> : AllocationPolicyTraits<void>
+    {
+        static constexpr HugePages  k_Huge_Pages    = t_Huge_Pages;
+    };
+
+    template<int t_Node>
+    struct AllocationPolicyTraits<NumaNodePolicy<t_Node>> : AllocationPolicyTraits<void>
+    {
+        static constexpr int        k_Numa_Node     = t_Node;
+    };
+
+    template<>
+    struct AllocationPolicyTraits<NoZeroInitPolicy> : AllocationPolicyTraits<void>
+    {
+        static constexpr bool       k_No_Zero_Init  = true;
+    };
+
+    // The allocation policies found in a buffer's policy list.
+    template<typename... Policies>
+    struct AllocationPolicies
+    {
+        static constexpr HugePages  k_Huge_Pages    = std::max({HugePages::None, AllocationPolicyTraits<Policies>::k_Huge_Pages...});
+        static constexpr int        k_Numa_Node     = std::max({-1, AllocationPolicyTraits<Policies>::k_Numa_Node...});
+        static constexpr bool       k_No_Zero_Init  = (false || ... || AllocationPolicyTraits<Policies>::k_No_Zero_Init);
+
+        static constexpr bool       k_Mapped        = k_Huge_Pages != HugePages::None || k_Numa_Node >= 0 || k_No_Zero_Init;
+    };
+
+    // What a user of a buffer may rely on about its reservations.
+    // k_Larger_Region: buffer() offers the larger of the free
+    // regions, or all free room as one span, rather than the back
+    // of the ring until it is used up. A ring whose back region
+    // is shorter than what its producer needs at once never wraps;
+    // producers with such a minimum require this. Specialized
+    // next to each buffer; SharedRingBuffer is left out, as it
+    // picks its layout at run time.
+    template<typename Buffer>
+    struct BufferTraits
+    {
+        static constexpr bool       k_Larger_Region = false;
+    };
+}
+
+#endif // _BUFFER_POLICIES_HPP__
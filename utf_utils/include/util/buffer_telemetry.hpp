@@ -0,0 +1,260 @@
+#ifndef _BUFFER_TELEMETRY_HPP__
+#define _BUFFER_TELEMETRY_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "util/buffer_policies.hpp"
+
+namespace util
+{
+
+// What a buffer with TelemetryPolicy has counted so far, see
+// BufferTelemetry::snapshot(). Sizes are in elements, the rest
+// are numbers of calls.
+struct TelemetrySnapshot
+{
+    std::uint64_t   occupancy;              // committed and not yet released
+    std::uint64_t   peak_occupancy;         // highest occupancy right after a commit
+    std::uint64_t   committed;
+    std::uint64_t   released;
+    std::uint64_t   reservations;           // buffer(), reserve_vectored() and move() blocks
+    std::uint64_t   wraps;                  // reservations that started over at the front
+    std::uint64_t   short_reservations;     // non-empty, but smaller than requested
+    std::uint64_t   empty_reservations;     // no room at all, i.e. the producer stalled
+    std::uint64_t   reads;                  // read_block() and read_vectored() calls
+    std::uint64_t   empty_reads;            // of which found nothing to read
+};
+
+// Per-buffer counters, kept by RingBuffer and TransitBuffer when
+// TelemetryPolicy is among their policies and compiled out (an
+// empty member) otherwise. The buffer calls reserved()/committed()
+// from the producer side and readable()/released() from the
+// consumer side; all updates are relaxed, so a snapshot taken from
+// another thread is consistent per counter but not across them.
+//
+// A wrap is a reservation that begins before the previous one; the
+// producer side of each buffer only moves forward otherwise. With
+// several producers (MpmcPolicy) reservations race for the last
+// begin seen, so wraps are approximate there.
+//
+// reserved() runs once per reservation, so its counters are bumped
+// with a relaxed load and store, which needs no locked instruction,
+// wherever one producer at a time reserves (SPSC, or under the
+// buffer's lock). t_Concurrent_Producers, set for MpmcPolicy, makes
+// them read-modify-writes instead.
+template<bool t_Enabled, bool t_Concurrent_Producers = false>
+class BufferTelemetry
+{
+public:
+    template<typename SizeType>
+    void reserved(SizeType begin, SizeType size_requested, SizeType capacity) noexcept
+    {
+        increment(producer_.reservations_);
+
+        if (capacity == 0)
+        {
+            increment(producer_.empty_reservations_);
+            return;
+        }
+
+        if (capacity < size_requested)
+            increment(producer_.short_reservations_);
+
+        std::uint64_t   last;
+
+        if constexpr (t_Concurrent_Producers)
+        {
+            last = producer_.last_begin_.exchange(static_cast<std::uint64_t>(begin), std::memory_order_relaxed);
+        }
+        else
+        {
+            last = producer_.last_begin_.load(std::memory_order_relaxed);
+            producer_.last_begin_.store(static_cast<std::uint64_t>(begin), std::memory_order_relaxed);
+        }
+
+        if (static_cast<std::uint64_t>(begin) < last)
+            increment(producer_.wraps_);
+    }
+
+    void committed(std::uint64_t size) noexcept
+    {
+        if (size == 0)
+            return;
+
+        std::uint64_t   total       = producer_.committed_.fetch_add(size, std::memory_order_relaxed) + size;
+        std::uint64_t   released    = consumer_.released_.load(std::memory_order_relaxed);
+        std::uint64_t   occupancy   = (total > released) ? total - released : 0;
+        std::uint64_t   peak        = producer_.peak_.load(std::memory_order_relaxed);
+
+        while (occupancy > peak && !producer_.peak_.compare_exchange_weak(peak, occupancy, std::memory_order_relaxed))
+        {}
+    }
+
+    void readable(std::uint64_t size) noexcept
+    {
+        consumer_.reads_.fetch_add(1, std::memory_order_relaxed);
+
+        if (size == 0)
+            consumer_.empty_reads_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void released(std::uint64_t size) noexcept
+    {
+        if (size != 0)
+            consumer_.released_.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    // The buffer was reset: whatever it held counts as released.
+    void cleared() noexcept
+    {
+        consumer_.released_.store(producer_.committed_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        producer_.last_begin_.store(0, std::memory_order_relaxed);
+    }
+
+    // With reset_peak set, the peak starts over from the current
+    // occupancy, so that successive snapshots each hold the peak of
+    // the interval since the previous one.
+    [[nodiscard]] TelemetrySnapshot snapshot(bool reset_peak = false) noexcept
+    {
+        TelemetrySnapshot   counters;
+
+        // released first: whatever it counts was committed before.
+        counters.released           = consumer_.released_.load(std::memory_order_relaxed);
+        counters.committed          = producer_.committed_.load(std::memory_order_relaxed);
+        counters.occupancy          = (counters.committed > counters.released) ? counters.committed - counters.released : 0;
+        counters.peak_occupancy     = reset_peak ? producer_.peak_.exchange(counters.occupancy, std::memory_order_relaxed) : producer_.peak_.load(std::memory_order_relaxed);
+        counters.reservations       = producer_.reservations_.load(std::memory_order_relaxed);
+        counters.wraps              = producer_.wraps_.load(std::memory_order_relaxed);
+        counters.short_reservations = producer_.short_reservations_.load(std::memory_order_relaxed);
+        counters.empty_reservations = producer_.empty_reservations_.load(std::memory_order_relaxed);
+        counters.reads              = consumer_.reads_.load(std::memory_order_relaxed);
+        counters.empty_reads        = consumer_.empty_reads_.load(std::memory_order_relaxed);
+
+        if (counters.peak_occupancy < counters.occupancy)
+            counters.peak_occupancy = counters.occupancy;
+
+        return counters;
+    }
+
+private:
+    static void increment(std::atomic<std::uint64_t>& counter) noexcept
+    {
+        if constexpr (t_Concurrent_Producers)
+            counter.fetch_add(1, std::memory_order_relaxed);
+        else
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Written by the producer and by the consumer respectively,
+    // on lines of their own.
+    struct alignas(k_Cache_Line_Size) Producer
+    {
+        std::atomic<std::uint64_t>  committed_{0};
+        std::atomic<std::uint64_t>  reservations_{0};
+        std::atomic<std::uint64_t>  wraps_{0};
+        std::atomic<std::uint64_t>  short_reservations_{0};
+        std::atomic<std::uint64_t>  empty_reservations_{0};
+        std::atomic<std::uint64_t>  last_begin_{0};
+        std::atomic<std::uint64_t>  peak_{0};
+    };
+
+    struct alignas(k_Cache_Line_Size) Consumer
+    {
+        std::atomic<std::uint64_t>  released_{0};
+        std::atomic<std::uint64_t>  reads_{0};
+        std::atomic<std::uint64_t>  empty_reads_{0};
+    };
+
+    Producer    producer_;
+    Consumer    consumer_;
+};
+
+template<bool t_Concurrent_Producers>
+class BufferTelemetry<false, t_Concurrent_Producers>
+{
+public:
+    template<typename SizeType>
+    void reserved(SizeType, SizeType, SizeType) noexcept
+    {}
+
+    void committed(std::uint64_t) noexcept
+    {}
+
+    void readable(std::uint64_t) noexcept
+    {}
+
+    void released(std::uint64_t) noexcept
+    {}
+
+    void cleared() noexcept
+    {}
+
+    [[nodiscard]] TelemetrySnapshot snapshot(bool = false) noexcept
+    {
+        return TelemetrySnapshot{};
+    }
+};
+
+// The telemetry named in a buffer's policy list.
+template<typename... Policies>
+using buffer_telemetry_t    = BufferTelemetry<has_policy_v<TelemetryPolicy, Policies...>, has_policy_v<MpmcPolicy, Policies...>>;
+
+// Reports a buffer's telemetry every interval from a thread of its
+// own, for as long as it lives, and once more when it is destroyed;
+// e.g. TelemetrySampler sampler(ring.telemetry(), 1s, print). Each
+// report holds the peak occupancy of its interval.
+class TelemetrySampler
+{
+public:
+    using Report    = std::function<void (const TelemetrySnapshot&)>;
+
+    template<typename Telemetry, typename Rep, typename Period>
+    TelemetrySampler(Telemetry& telemetry, std::chrono::duration<Rep, Period> interval, Report report)
+        : sample_([&telemetry]() noexcept { return telemetry.snapshot(true); })
+        , report_(std::move(report))
+        , stop_(false)
+    {
+        thread_ = std::thread([this, interval]()
+            {
+                std::unique_lock<std::mutex>    lock(mutex_);
+
+                while (!stopped_.wait_for(lock, interval, [this]() noexcept { return stop_; }))
+                    report_(sample_());
+            });
+    }
+
+    ~TelemetrySampler() noexcept
+    {
+        {
+            std::scoped_lock<std::mutex>    lock(mutex_);
+            stop_   = true;
+        }
+
+        stopped_.notify_one();
+        thread_.join();
+
+        report_(sample_());
+    }
+
+    TelemetrySampler(const TelemetrySampler&)             = delete;
+    TelemetrySampler& operator=(const TelemetrySampler&)  = delete;
+
+private:
+    std::function<TelemetrySnapshot ()>     sample_;
+    Report                                  report_;
+    std::mutex                              mutex_;
+    std::condition_variable                 stopped_;
+    bool                                    stop_;
+    std::thread                             thread_;
+};
+
+}
+
+#endif // _BUFFER_TELEMETRY_HPP__
@@ -1,53 +1,306 @@
 #ifndef _CHAR_STREAM_HPP__
 #define _CHAR_STREAM_HPP__
 
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "util/number_format.hpp"
+#include "util/transcoding_stage.hpp"
+
 namespace util
 {
 
+// Appends text to a buffer through reservations: strings are
+// copied in bulk into at most two of them (the second one for
+// what didn't fit before the wrap point), numbers are formatted
+// straight into one if it is large enough for any value of their
+// type. Whatever finds no room is dropped.
+//
+// Into char16_t and char32_t buffers, text is taken as UTF-8 and
+// transcoded with UniFy straight into the reservations. A sequence
+// cut by the end of a reservation is completed in the next one; a
+// sequence cut by the end of the inserted string is held back until
+// the next insertion completes it.
 template<typename Buffer>
 class CharStream
 {
 public:
-    using BType = typename Buffer::value_type;
+    using BType     = typename Buffer::value_type;
+    using SizeType  = typename Buffer::size_type;
+
+    static_assert(sizeof(BType) == sizeof(char) || std::is_same_v<BType, char16_t> || std::is_same_v<BType, char32_t>,
+                  "CharStream writes bytes, UTF-16 or UTF-32");
 
     CharStream(Buffer& buff)
         : buffer_(buff)
+        , carry_size_(0)
     {}
 
+    CharStream& operator<<(std::string_view str)
+    {
+        append(str.data(), str.size());
+
+        return *this;
+    }
+
+    CharStream& operator<<(std::u8string_view str)
+    {
+        append(reinterpret_cast<const char*>(str.data()), str.size());
+
+        return *this;
+    }
+
     CharStream& operator<<(const char* const str)
     {
-        char* ptr       = const_cast<char*>(str);
-        auto handle     = buffer_.buffer();
-        auto capacity   = handle.capacity_;
+        return *this << std::string_view(str);
+    }
 
-        while (capacity > 0 && *ptr != '\0')
-        {
-            handle.data()[handle.size_++]   = *(reinterpret_cast<BType*>(ptr));
+    CharStream& operator<<(const char8_t* const str)
+    {
+        return *this << std::u8string_view(str);
+    }
+
+    template<typename Integer, std::enable_if_t<is_number_v<Integer>, int> = 0>
+    CharStream& operator<<(Integer value)
+    {
+        format<k_Max_Integer_Size>([value](char* output) { return format_integer(output, value); });
 
-            ptr++;
-            capacity--;
+        return *this;
+    }
+
+    template<typename Float, std::enable_if_t<std::is_floating_point_v<Float>, int> = 0>
+    CharStream& operator<<(Float value)
+    {
+        format<k_Max_Float_Size>([value](char* output) { return format_float(output, value); });
+
+        return *this;
+    }
 
-            if (capacity == 0)
+    template<std::uint32_t t_Decimals, typename Integer>
+    CharStream& operator<<(FixedPoint<t_Decimals, Integer> value)
+    {
+        format<FixedPoint<t_Decimals, Integer>::k_Max_Size>([value](char* output) { return format_fixed(output, value); });
+
+        return *this;
+    }
+
+    CharStream(const CharStream&)               = delete;
+    CharStream& operator=(const CharStream&)    = delete;
+
+protected:
+    static constexpr bool   k_Transcode     = sizeof(BType) != sizeof(char);
+
+    // UTF-8 in, BType out, in native byte order.
+    using Transcoder        = UniFy<std::conditional_t<k_Transcode, BType, char8_t>, char8_t, false, false>;
+    using Traits            = TranscoderTraits<Transcoder>;
+
+    void append(const char* str, std::size_t size)
+    {
+        if constexpr (k_Transcode)
+        {
+            transcode(reinterpret_cast<const char8_t*>(str), size);
+        }
+        else
+        {
+            for (int reservation = 0; reservation < 2 && size > 0; ++reservation)
             {
+                auto        handle      = buffer_.buffer(static_cast<SizeType>(size));
+                std::size_t capacity    = handle.capacity();
+                std::size_t length      = (size < capacity) ? size : capacity;
+
+                std::memcpy(handle.data(), str, length);
+                handle.size(static_cast<SizeType>(length));
                 buffer_.commit(handle);
 
-                handle      = buffer_.buffer();
-                capacity    = handle.capacity_;
+                str    += length;
+                size   -= length;
             }
         }
+    }
 
-        buffer_.commit(handle);
+    template<std::size_t t_Max_Size, typename Format>
+    void format(Format&& writer)
+    {
+        if constexpr (!k_Transcode)
+        {
+            auto    handle  = buffer_.buffer(static_cast<SizeType>(t_Max_Size));
 
-        return *this;
+            if (handle.capacity() >= t_Max_Size)
+            {
+                char*   output  = reinterpret_cast<char*>(handle.data());
+
+                handle.size(static_cast<SizeType>(writer(output) - output));
+                buffer_.commit(handle);
+                return;
+            }
+
+            handle.size(0);
+            buffer_.commit(handle);
+        }
+
+        char    local[t_Max_Size];
+        append(local, static_cast<std::size_t>(writer(local) - local));
     }
 
-    CharStream(const CharStream&)               = delete;
-    CharStream& operator=(const CharStream&)    = delete;
+    void transcode(const char8_t* str, std::size_t size);
+
+    // Completes a sequence held back by the previous insertion;
+    // returns the number of units of str it used.
+    std::size_t complete(const char8_t* str, std::size_t size);
+
+    // Copies already transcoded units, across two reservations.
+    void put(const BType* units, std::size_t size);
 
 private:
-    Buffer&     buffer_;
+    static constexpr std::size_t    k_Max_Sequence  = 4;
+    static constexpr std::size_t    k_Max_Staged    = 64;
+
+    Buffer&                 buffer_;
+    char8_t                 carry_[k_Max_Sequence];
+    std::size_t             carry_size_;
+    std::vector<char32_t>   scratch_;
 };
 
+template<typename Buffer>
+inline
+void CharStream<Buffer>::transcode(const char8_t* str, std::size_t size)
+{
+    if (carry_size_ > 0)
+    {
+        std::size_t used = complete(str, size);
+
+        str    += used;
+        size   -= used;
+    }
+
+    // Output is never longer than input, but UniFy needs room for
+    // the widened input, so what is left of a reservation before the
+    // wrap point is used up over several rounds.
+    while (size > 0)
+    {
+        auto        handle  = buffer_.buffer(static_cast<SizeType>(size * Traits::k_Output_Factor));
+        std::size_t room    = handle.capacity() / Traits::k_Output_Factor;
+        std::size_t chunk   = (size < room) ? size : room;
+        BType*      output  = handle.data();
+
+        if (handle.capacity() == 0)
+            break;
+
+        // A reservation too short to take even one sequence that way
+        // (the last few units before the wrap point) is filled from
+        // scratch_ instead, as is one that is misaligned for UniFy.
+        bool        cramped = chunk < ((size < k_Max_Sequence) ? size : k_Max_Sequence);
+
+        if (cramped || reinterpret_cast<std::uintptr_t>(output) % Traits::k_Output_Alignment != 0)
+        {
+            if (cramped)
+            {
+                handle.size(0);
+                buffer_.commit(handle);
+                chunk = (size < k_Max_Staged) ? size : k_Max_Staged;
+            }
+
+            scratch_.resize(chunk * Traits::k_Output_Factor * sizeof(BType) / sizeof(char32_t) + 1);
+            output  = reinterpret_cast<BType*>(scratch_.data());
+        }
+
+        auto [written, consumed] = Transcoder::transcode(output, str, static_cast<int64_t>(chunk));
+
+        if (output != handle.data() && handle.capacity() > 0)
+        {
+            std::memcpy(handle.data(), output, static_cast<std::size_t>(written) * sizeof(BType));
+            handle.size(static_cast<SizeType>(written));
+            buffer_.commit(handle);
+        }
+        else if (output != handle.data())
+        {
+            put(output, static_cast<std::size_t>(written));
+        }
+        else
+        {
+            handle.size(static_cast<SizeType>(written));
+            buffer_.commit(handle);
+        }
+
+        str    += consumed;
+        size   -= static_cast<std::size_t>(consumed);
+
+        // The string itself ends inside a sequence.
+        if (chunk == size + static_cast<std::size_t>(consumed) && size > 0 && size < k_Max_Sequence)
+        {
+            std::memcpy(carry_, str, size);
+            carry_size_ = size;
+            size        = 0;
+        }
+
+        if (consumed == 0)
+            break;
+    }
+}
+
+template<typename Buffer>
+inline
+std::size_t CharStream<Buffer>::complete(const char8_t* str, std::size_t size)
+{
+    char8_t         stitch[k_Max_Sequence];
+    char32_t        local[k_Max_Sequence * Traits::k_Output_Factor * sizeof(BType) / sizeof(char32_t) + 1];
+    std::size_t     take    = k_Max_Sequence - carry_size_;
+
+    if (take > size)
+        take = size;
+
+    std::memcpy(stitch, carry_, carry_size_);
+    std::memcpy(stitch + carry_size_, str, take);
+
+    std::size_t     length  = carry_size_ + take;
+    BType*          output  = reinterpret_cast<BType*>(local);
+    auto [written, consumed] = Transcoder::transcode(output, stitch, static_cast<int64_t>(length));
+
+    if (static_cast<std::size_t>(consumed) <= carry_size_)
+    {
+        // Still short of a whole sequence: keep collecting, unless
+        // four units didn't make one, in which case it is dropped.
+        if (length < k_Max_Sequence)
+        {
+            std::memcpy(carry_, stitch, length);
+            carry_size_ = length;
+            return take;
+        }
+
+        carry_size_ = 0;
+        return 0;
+    }
+
+    put(output, static_cast<std::size_t>(written));
+
+    std::size_t used = static_cast<std::size_t>(consumed) - carry_size_;
+
+    carry_size_ = 0;
+    return used;
+}
+
+template<typename Buffer>
+inline
+void CharStream<Buffer>::put(const BType* units, std::size_t size)
+{
+    for (int reservation = 0; reservation < 2 && size > 0; ++reservation)
+    {
+        auto        handle      = buffer_.buffer(static_cast<SizeType>(size));
+        std::size_t capacity    = handle.capacity();
+        std::size_t length      = (size < capacity) ? size : capacity;
+
+        std::memcpy(handle.data(), units, length * sizeof(BType));
+        handle.size(static_cast<SizeType>(length));
+        buffer_.commit(handle);
+
+        units  += length;
+        size   -= length;
+    }
+}
+
 template<>
 class CharStream<char*>
 {
@@ -58,16 +311,50 @@ public:
         , index_(0)
     {}
 
+    CharStream& operator<<(std::string_view str)
+    {
+        append(str.data(), str.size());
+
+        return *this;
+    }
+
     CharStream& operator<<(const char* const str)
     {
-        const char* ptr = str;
-        auto capacity   = size_ - index_;
+        return *this << std::string_view(str);
+    }
 
-        while (capacity > 0 && *ptr != '\0')
-        {
-            buffer_[index_++]   = *ptr++;
-            capacity--;
-        }
+    CharStream& operator<<(std::u8string_view str)
+    {
+        append(reinterpret_cast<const char*>(str.data()), str.size());
+
+        return *this;
+    }
+
+    CharStream& operator<<(const char8_t* const str)
+    {
+        return *this << std::u8string_view(str);
+    }
+
+    template<typename Integer, std::enable_if_t<is_number_v<Integer>, int> = 0>
+    CharStream& operator<<(Integer value)
+    {
+        format<k_Max_Integer_Size>([value](char* output) { return format_integer(output, value); });
+
+        return *this;
+    }
+
+    template<typename Float, std::enable_if_t<std::is_floating_point_v<Float>, int> = 0>
+    CharStream& operator<<(Float value)
+    {
+        format<k_Max_Float_Size>([value](char* output) { return format_float(output, value); });
+
+        return *this;
+    }
+
+    template<std::uint32_t t_Decimals, typename Integer>
+    CharStream& operator<<(FixedPoint<t_Decimals, Integer> value)
+    {
+        format<FixedPoint<t_Decimals, Integer>::k_Max_Size>([value](char* output) { return format_fixed(output, value); });
 
         return *this;
     }
@@ -85,6 +372,29 @@ public:
     CharStream(const CharStream&)               = delete;
     CharStream& operator=(const CharStream&)    = delete;
 
+protected:
+    void append(const char* str, std::size_t size)
+    {
+        std::size_t capacity    = static_cast<std::size_t>(size_ - index_);
+        std::size_t length      = (size < capacity) ? size : capacity;
+
+        std::memcpy(buffer_ + index_, str, length);
+        index_ += static_cast<int>(length);
+    }
+
+    template<std::size_t t_Max_Size, typename Format>
+    void format(Format&& writer)
+    {
+        if (static_cast<std::size_t>(size_ - index_) >= t_Max_Size)
+        {
+            index_ = static_cast<int>(writer(buffer_ + index_) - buffer_);
+            return;
+        }
+
+        char    local[t_Max_Size];
+        append(local, static_cast<std::size_t>(writer(local) - local));
+    }
+
 private:
     char*   buffer_;
     int     size_;
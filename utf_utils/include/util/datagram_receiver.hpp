@@ -0,0 +1,291 @@
+#ifndef _DATAGRAM_RECEIVER_HPP__
+#define _DATAGRAM_RECEIVER_HPP__
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+#include "util/buffer_policies.hpp"
+#include "util/record_ring.hpp"
+#include "util/transcoding_stage.hpp"
+
+namespace util
+{
+
+// Called by DatagramReceiver with every datagram, in place in the
+// buffer and right after it arrived, before it is committed.
+struct NoDatagramHook
+{
+    template<typename Type, typename SizeType>
+    void operator()(const Type*, SizeType) noexcept
+    {}
+};
+
+// A DatagramReceiver hook that transcodes every datagram into
+// a buffer() reservation of another buffer while it is still in
+// cache, e.g. UTF-8 payloads straight into a char16_t buffer.
+// A datagram is expected to hold whole sequences; whatever the
+// transcoder doesn't consume counts as malformed(). Datagrams
+// that don't fit the output are dropped and counted, so that a
+// slow reader never stalls the socket. The output must offer
+// the larger of its free regions (see BufferTraits); a plain
+// RingBuffer would drop everything once its back region grew
+// too short for a datagram.
+template<typename OutBuffer, typename Transcoder>
+class TranscodeHook
+{
+public:
+    using DestType  = typename OutBuffer::value_type;
+    using SizeType  = typename OutBuffer::size_type;
+    using Traits    = TranscoderTraits<Transcoder>;
+
+    static_assert(BufferTraits<OutBuffer>::k_Larger_Region, "the output must offer the larger of its free regions");
+
+    explicit TranscodeHook(OutBuffer& output) noexcept
+        : output_(output)
+        , dropped_(0)
+        , malformed_(0)
+    {}
+
+    template<typename Type, typename InSizeType>
+    void operator()(const Type* data, InSizeType size) noexcept
+    {
+        auto        output      = output_.buffer(static_cast<SizeType>(size * Traits::k_Output_Factor));
+
+        if (output.capacity() < size * Traits::k_Output_Factor)
+        {
+            ++dropped_;
+            output.size(0);
+            output_.commit(output);
+            return;
+        }
+
+        DestType*   destination = output.data();
+
+        if (reinterpret_cast<std::uintptr_t>(destination) % Traits::k_Output_Alignment != 0)
+        {
+            scratch_.resize((size * Traits::k_Output_Factor * sizeof(DestType) + sizeof(char32_t) - 1) / sizeof(char32_t));
+            destination = reinterpret_cast<DestType*>(scratch_.data());
+        }
+
+        auto [written, consumed] = Transcoder::transcode(destination, data, static_cast<int64_t>(size));
+
+        if (destination != output.data())
+            std::memcpy(output.data(), destination, static_cast<std::size_t>(written) * sizeof(DestType));
+
+        malformed_ += (consumed != static_cast<int64_t>(size));
+
+        output.size(static_cast<SizeType>(written));
+        output_.commit(output);
+    }
+
+    [[nodiscard]] decltype(auto) dropped() const noexcept
+    {
+        return dropped_;
+    }
+
+    [[nodiscard]] decltype(auto) malformed() const noexcept
+    {
+        return malformed_;
+    }
+
+private:
+    OutBuffer&              output_;
+    std::size_t             dropped_;
+    std::size_t             malformed_;
+    std::vector<char32_t>   scratch_;
+};
+
+// Receives datagrams from a socket directly into buffer() Handles
+// of a byte buffer, up to t_Batch of them per recvmmsg() call.
+//
+// The reservation is split into t_Batch slots, one per message,
+// each room for one RecordRing record of t_Max_Datagram bytes.
+// Datagrams stay where they arrived: every slot gets the record
+// header of its datagram, and the rest of the slot a padding
+// record, so the buffer holds RecordRing records and a
+// RecordRing on it reads back one datagram per record.
+// Truncated datagrams are discarded and counted; their slots
+// become padding as a whole.
+//
+// The buffer must offer the larger of its free regions, as
+// TransitBuffer and a mirrored RingBuffer do (see BufferTraits):
+// a plain RingBuffer fills its back before wrapping, so a back
+// region shorter than one slot would never be used nor wrapped.
+// It should also hold at least two slots, so that the larger
+// region of an empty buffer always takes one.
+//
+// Not thread-safe; must be used from the buffer's producer side.
+template<typename Buffer, typename Hook = NoDatagramHook, std::size_t t_Batch = 32, std::size_t t_Max_Datagram = 2048>
+class DatagramReceiver
+{
+public:
+    using Type      = typename Buffer::value_type;
+    using SizeType  = typename Buffer::size_type;
+
+    static_assert(sizeof(Type) == 1, "datagrams are received into byte buffers");
+    static_assert(t_Batch > 0 && t_Max_Datagram > 0, "batch and datagram size must be non-zero");
+    static_assert(BufferTraits<Buffer>::k_Larger_Region, "datagrams are received into buffers that offer their larger region");
+
+    using Records   = RecordRing<Buffer>;
+    using Header    = typename Records::Header;
+
+    static_assert(t_Max_Datagram <= Records::k_Max_Payload, "a datagram must fit one record");
+
+    // Elements per slot: a record header and the largest datagram,
+    // padded to the record alignment.
+    static constexpr std::size_t    k_Slot_Size = Records::footprint(static_cast<SizeType>(t_Max_Datagram));
+
+    // datagrams and bytes committed, record framing included
+    using Progress  = std::tuple<std::size_t, SizeType>;
+
+    explicit DatagramReceiver(Buffer& buffer, int fd, Hook hook = Hook()) noexcept
+        : buffer_(buffer)
+        , fd_(fd)
+        , hook_(std::move(hook))
+        , truncated_(0)
+    {}
+
+    DatagramReceiver(const DatagramReceiver&)             = delete;
+    DatagramReceiver& operator=(const DatagramReceiver&)  = delete;
+
+    // Receives whatever is pending, at most one batch; with wait
+    // set, blocks until at least one datagram has arrived. Returns
+    // (0, 0) if nothing was pending or the buffer has no room for
+    // a single slot, and throws std::system_error on socket errors.
+    [[nodiscard]] decltype(auto) receive(bool wait = false);
+
+    [[nodiscard]] decltype(auto) hook() noexcept
+    {
+        return (hook_);
+    }
+
+    [[nodiscard]] decltype(auto) truncated() const noexcept
+    {
+        return truncated_;
+    }
+
+protected:
+    // Fills up to slots slots; returns the number of messages.
+    [[nodiscard]] std::size_t receive_batch(Type* data, std::size_t slots, bool wait);
+
+    static void frame(Type* record, Header value) noexcept
+    {
+        std::memcpy(record, &value, sizeof(Header));
+    }
+
+private:
+    Buffer&         buffer_;
+    int             fd_;
+    Hook            hook_;
+    std::size_t     truncated_;
+    std::size_t     lengths_[t_Batch];
+    bool            cut_[t_Batch];
+
+#if defined(__linux__)
+    mmsghdr         messages_[t_Batch];
+    iovec           vectors_[t_Batch];
+#endif
+};
+
+template<typename Buffer, typename Hook, std::size_t t_Batch, std::size_t t_Max_Datagram>
+inline
+decltype(auto) DatagramReceiver<Buffer, Hook, t_Batch, t_Max_Datagram>::receive(bool wait)
+{
+    auto        handle  = buffer_.buffer(static_cast<SizeType>(t_Batch * k_Slot_Size));
+    std::size_t slots   = handle.capacity() / k_Slot_Size;
+
+    if (slots == 0)
+    {
+        handle.size(0);
+        buffer_.commit(handle);
+        return Progress(0, 0);
+    }
+
+    Type*       data        = handle.data();
+    std::size_t received    = receive_batch(data, slots, wait);
+    std::size_t datagrams   = 0;
+    SizeType    size        = static_cast<SizeType>(received * k_Slot_Size);
+
+    for (std::size_t index = 0; index < received; ++index)
+    {
+        Type*       slot        = data + index * k_Slot_Size;
+
+        if (cut_[index])
+        {
+            ++truncated_;
+            frame(slot, Records::k_Padding | static_cast<Header>(k_Slot_Size));
+            continue;
+        }
+
+        SizeType    length      = static_cast<SizeType>(lengths_[index]);
+        SizeType    record      = Records::footprint(length);
+
+        frame(slot, static_cast<Header>(length));
+        hook_(slot + Records::k_Header_Size, length);
+
+        if (record < k_Slot_Size)
+            frame(slot + record, Records::k_Padding | static_cast<Header>(k_Slot_Size - record));
+
+        ++datagrams;
+    }
+
+    handle.size(size);
+    buffer_.commit(handle);
+
+    return Progress(datagrams, size);
+}
+
+template<typename Buffer, typename Hook, std::size_t t_Batch, std::size_t t_Max_Datagram>
+inline
+std::size_t DatagramReceiver<Buffer, Hook, t_Batch, t_Max_Datagram>::receive_batch(Type* data, std::size_t slots, bool wait)
+{
+#if defined(__linux__)
+    for (std::size_t index = 0; index < slots; ++index)
+    {
+        vectors_[index].iov_base    = data + index * k_Slot_Size + Records::k_Header_Size;
+        vectors_[index].iov_len     = t_Max_Datagram;
+
+        std::memset(&messages_[index], 0, sizeof(mmsghdr));
+        messages_[index].msg_hdr.msg_iov    = &vectors_[index];
+        messages_[index].msg_hdr.msg_iovlen = 1;
+    }
+
+    int count = ::recvmmsg(fd_, messages_, static_cast<unsigned int>(slots), wait ? MSG_WAITFORONE : MSG_DONTWAIT, nullptr);
+
+    if (count < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            return 0;
+
+        throw std::system_error(errno, std::generic_category(), "recvmmsg");
+    }
+
+    for (int index = 0; index < count; ++index)
+    {
+        lengths_[index] = messages_[index].msg_len;
+        cut_[index]     = (messages_[index].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+    }
+
+    return static_cast<std::size_t>(count);
+#else
+    (void) data;
+    (void) slots;
+    (void) wait;
+    throw std::system_error(ENOSYS, std::generic_category(), "DatagramReceiver");
+#endif
+}
+
+}
+
+#endif // _DATAGRAM_RECEIVER_HPP__
@@ -0,0 +1,150 @@
+#ifndef _DELIMITER_SCAN_HPP__
+#define _DELIMITER_SCAN_HPP__
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "util/helper_functions.hpp"
+
+namespace util
+{
+
+// Default delimiter predicate: every textual match counts.
+struct AcceptDelimiter
+{
+    template<typename Type, typename SizeType>
+    constexpr bool operator()(const Type*, const Type*, const SizeType) const noexcept
+    {
+        return true;
+    }
+};
+
+template<typename Type>
+inline constexpr bool k_Byte_Scannable  = sizeof(Type) == 1 && std::is_trivially_copyable_v<Type>;
+
+// Returns the first element in [first, last) equal to value, or
+// last. Byte-sized types are compared 32 (AVX2) or 16 (SSE2) at
+// a time with cmpeq/movemask; anything else falls back to
+// std::find.
+template<typename Type>
+inline const Type* find_value(const Type* first, const Type* last, const Type value) noexcept
+{
+    if constexpr (k_Byte_Scannable<Type>)
+    {
+        std::uint8_t    byte;
+        std::memcpy(&byte, &value, 1);
+
+#if defined(__AVX2__)
+        const __m256i   needle32    = _mm256_set1_epi8(static_cast<char>(byte));
+
+        for (; last - first >= 32; first += 32)
+        {
+            __m256i     chunk   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+            std::uint32_t mask  = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle32)));
+
+            if (mask != 0)
+                return first + __builtin_ctz(mask);
+        }
+#endif
+#if defined(__SSE2__)
+        const __m128i   needle16    = _mm_set1_epi8(static_cast<char>(byte));
+
+        for (; last - first >= 16; first += 16)
+        {
+            __m128i     chunk   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+            std::uint32_t mask  = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle16)));
+
+            if (mask != 0)
+                return first + __builtin_ctz(mask);
+        }
+#endif
+        for (; first != last; ++first)
+        {
+            if (*first == value)
+                return first;
+        }
+
+        return last;
+    }
+    else
+    {
+        return std::find(first, last, value);
+    }
+}
+
+// One step of a delimited read: moves elements of the readable
+// block [source, source + source_size) to the end of the
+// destination until the destination ends with the delimiter and
+// check_delimiter accepts it, or either side runs out.
+//
+// Candidates are found by scanning for the delimiter's last
+// element and verified against the tail of the destination, so
+// a delimiter split across two blocks (the wrap point) is still
+// found. Returns the number of source elements consumed and
+// whether the delimiter was found; data_size is advanced.
+template<typename Type, typename SizeType, typename Predicate>
+inline decltype(auto) scan_delimited(Type* source, const SizeType source_size, Type* destination_buffer, SizeType& data_size, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, Predicate& check_delimiter)
+{
+    using Status    = std::tuple<SizeType, bool>;
+
+    SizeType    room    = destination_buffer_size - data_size;
+    SizeType    limit   = (source_size < room) ? source_size : room;
+    SizeType    index   = 0;
+
+    auto move_to_destination = [&](SizeType count)
+    {
+        if constexpr (std::is_trivially_copyable_v<Type>)
+        {
+            if (count > 0)
+                std::memcpy(destination_buffer + data_size, source + index, count * sizeof(Type));
+        }
+        else
+        {
+            for (SizeType i = 0; i < count; ++i)
+                destination_buffer[data_size + i]   = std::move(source[index + i]);
+        }
+
+        data_size   += count;
+        index       += count;
+    };
+
+    if (delimiter_size == 0)
+    {
+        move_to_destination(limit);
+        return Status(index, false);
+    }
+
+    const Type  last_element    = delimiter[delimiter_size - 1];
+
+    while (index < limit)
+    {
+        const Type* candidate   = find_value<Type>(source + index, source + limit, last_element);
+
+        move_to_destination(static_cast<SizeType>(candidate - (source + index)));
+
+        if (index == limit)
+            break;
+
+        move_to_destination(1);
+
+        if (data_size >= delimiter_size
+            && std::equal(delimiter, delimiter + delimiter_size - 1, destination_buffer + data_size - delimiter_size)
+            && check_delimiter(destination_buffer, delimiter, delimiter_size))
+        {
+            return Status(index, true);
+        }
+    }
+
+    return Status(index, false);
+}
+
+}
+
+#endif // _DELIMITER_SCAN_HPP__
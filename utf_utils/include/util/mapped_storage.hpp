@@ -0,0 +1,176 @@
+#ifndef _MAPPED_STORAGE_HPP__
+#define _MAPPED_STORAGE_HPP__
+
+#include <cerrno>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "util/buffer_policies.hpp"
+
+namespace util
+{
+
+// Element storage mapped straight from the kernel, shaped by the
+// allocation policies in Allocation (an AllocationPolicies<...>):
+//
+//  - HugePages::Size2M/Size1G map from the hugetlb pool; if the
+//    pool is empty the mapping falls back to normal pages with a
+//    transparent huge page hint.
+//  - HugePages::Transparent maps normal pages with that hint.
+//  - A NUMA node binds the range with mbind(MPOL_BIND) before any
+//    page is touched, so every page is placed on that node.
+//  - NoZeroInitPolicy skips the initial fill. The kernel still
+//    hands out zeroed pages, but they are only faulted in (on the
+//    right node, with the right page size) as the buffer is used.
+//
+// The length is rounded up to whole (huge) pages, but size() is the
+// requested count, so buffers index it just like a std::vector.
+template<typename Type, typename Allocation>
+class MappedStorage
+{
+public:
+    static_assert(!Allocation::k_No_Zero_Init || std::is_trivially_default_constructible_v<Type>,
+                  "NoZeroInitPolicy needs trivially default constructible elements");
+
+    MappedStorage(std::size_t count, const Type& value)
+    {
+        map(count);
+
+        if constexpr (!Allocation::k_No_Zero_Init)
+            std::uninitialized_fill_n(data_, size_, value);
+        else
+            (void) value;
+    }
+
+    MappedStorage(const MappedStorage&)             = delete;
+    MappedStorage& operator=(const MappedStorage&)  = delete;
+
+    ~MappedStorage() noexcept
+    {
+        clear();
+    }
+
+    [[nodiscard]] decltype(auto) data() noexcept
+    {
+        return data_;
+    }
+
+    [[nodiscard]] decltype(auto) size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] decltype(auto) operator[](std::size_t index) noexcept
+    {
+        return (data_[index]);
+    }
+
+    decltype(auto) clear() noexcept
+    {
+        if (data_ != nullptr)
+        {
+            std::destroy_n(data_, size_);
+#if defined(__linux__)
+            ::munmap(data_, bytes_);
+#else
+            ::operator delete(data_);
+#endif
+        }
+        data_   = nullptr;
+        size_   = 0;
+        bytes_  = 0;
+    }
+
+private:
+    void map(std::size_t count)
+    {
+#if defined(__linux__)
+        constexpr HugePages huge_pages  = Allocation::k_Huge_Pages;
+
+        std::size_t page    = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        int         flags   = MAP_PRIVATE | MAP_ANONYMOUS;
+        void*       base    = MAP_FAILED;
+
+        if constexpr (huge_pages == HugePages::Size2M || huge_pages == HugePages::Size1G)
+        {
+            const std::size_t   huge_page   = (huge_pages == HugePages::Size2M) ? (std::size_t(1) << 21) : (std::size_t(1) << 30);
+            const int           huge_flag   = (huge_pages == HugePages::Size2M) ? (21 << MAP_HUGE_SHIFT) : (30 << MAP_HUGE_SHIFT);
+
+            // No MAP_NORESERVE: the pages must be reserved up front
+            // so an empty pool fails here, not with SIGBUS later.
+            bytes_  = round_up(count * sizeof(Type), huge_page);
+            base    = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB | huge_flag, -1, 0);
+        }
+
+        if (base == MAP_FAILED)
+        {
+            bytes_  = round_up(count * sizeof(Type), page);
+            base    = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, flags, -1, 0);
+
+            if (base == MAP_FAILED)
+                throw std::system_error(errno, std::generic_category(), "mmap");
+
+            // Only a hint; kernels without THP simply ignore it.
+            if constexpr (huge_pages != HugePages::None)
+                ::madvise(base, bytes_, MADV_HUGEPAGE);
+        }
+
+        if constexpr (Allocation::k_Numa_Node >= 0)
+        {
+            // Raw syscall rather than libnuma; numaif.h is not always
+            // installed, and a single node mask is all that is needed.
+            constexpr int           k_Mpol_Bind = 2;
+            constexpr std::size_t   k_Word_Bits = 8 * sizeof(unsigned long);
+            constexpr std::size_t   node        = static_cast<std::size_t>(Allocation::k_Numa_Node);
+
+            std::vector<unsigned long>  mask(node / k_Word_Bits + 1, 0UL);
+            mask[node / k_Word_Bits]    = 1UL << (node % k_Word_Bits);
+
+            // The kernel reads maxnode - 1 bits of the mask, so the
+            // top bit of the last word needs one more.
+            if (::syscall(SYS_mbind, base, bytes_, k_Mpol_Bind, mask.data(), mask.size() * k_Word_Bits + 1, 0) != 0)
+            {
+                int error = errno;
+                ::munmap(base, bytes_);
+                throw std::system_error(error, std::generic_category(), "mbind");
+            }
+        }
+
+        data_   = static_cast<Type*>(base);
+        size_   = count;
+#else
+        data_   = static_cast<Type*>(::operator new(count * sizeof(Type)));
+        size_   = count;
+#endif
+    }
+
+    static constexpr std::size_t round_up(std::size_t bytes, std::size_t unit) noexcept
+    {
+        return ((bytes + unit - 1) / unit) * unit;
+    }
+
+    Type*           data_   = nullptr;
+    std::size_t     size_   = 0;
+    std::size_t     bytes_  = 0;
+};
+
+// Element storage for a buffer: a std::vector unless the policy
+// list asks for a mapped allocation.
+template<typename Type, typename... Policies>
+using buffer_storage_t  = std::conditional_t<AllocationPolicies<Policies...>::k_Mapped,
+                                             MappedStorage<Type, AllocationPolicies<Policies...>>,
+                                             std::vector<Type>>;
+
+}
+
+#endif // _MAPPED_STORAGE_HPP__
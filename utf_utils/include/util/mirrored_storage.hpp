@@ -0,0 +1,128 @@
+#ifndef _MIRRORED_STORAGE_HPP__
+#define _MIRRORED_STORAGE_HPP__
+
+#include <cerrno>
+#include <cstddef>
+#include <numeric>
+#include <system_error>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace util
+{
+
+// Element storage for a ring whose pages are mapped twice,
+// back to back: data()[i] and data()[i + size()] are the same
+// memory. Any span of up to size() elements starting inside
+// the first copy is therefore contiguous, however it wraps.
+//
+// The element count is rounded up so that the buffer is a
+// whole number of pages; callers size their indices from
+// size(), not from the requested count. Types are restricted
+// to trivially copyable ones, as the memory is never
+// constructed or destroyed element by element.
+template<typename Type>
+class MirroredStorage
+{
+public:
+    static_assert(std::is_trivially_copyable_v<Type>, "MirroredStorage holds raw bytes");
+
+    MirroredStorage(std::size_t count, const Type& value)
+    {
+        map(count);
+
+        for (std::size_t i = 0; i < size_; ++i)
+            data_[i] = value;
+    }
+
+    MirroredStorage(const MirroredStorage&)             = delete;
+    MirroredStorage& operator=(const MirroredStorage&)  = delete;
+
+    ~MirroredStorage() noexcept
+    {
+        clear();
+    }
+
+    [[nodiscard]] decltype(auto) data() noexcept
+    {
+        return data_;
+    }
+
+    [[nodiscard]] decltype(auto) size() const noexcept
+    {
+        return size_;
+    }
+
+    decltype(auto) clear() noexcept
+    {
+#if defined(__linux__)
+        if (data_ != nullptr)
+            ::munmap(data_, 2 * size_ * sizeof(Type));
+#endif
+        data_   = nullptr;
+        size_   = 0;
+    }
+
+private:
+    void map(std::size_t count)
+    {
+#if defined(__linux__)
+        const std::size_t page  = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const std::size_t unit  = page / std::gcd(page, sizeof(Type));
+        const std::size_t elems = ((count + unit - 1) / unit) * unit;
+        const std::size_t bytes = elems * sizeof(Type);
+
+        int fd = ::memfd_create("util_mirrored_ring", MFD_CLOEXEC);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "memfd_create");
+
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+        {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "ftruncate");
+        }
+
+        // Reserve both halves in one go so nothing else can be
+        // mapped in between, then overlay the file on each half.
+        void* base = ::mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED)
+        {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "mmap");
+        }
+
+        char* first     = static_cast<char*>(base);
+        char* second    = first + bytes;
+
+        if (::mmap(first, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+            || ::mmap(second, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+        {
+            int error = errno;
+            ::munmap(base, 2 * bytes);
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "mmap");
+        }
+
+        ::close(fd);
+
+        data_   = reinterpret_cast<Type*>(first);
+        size_   = elems;
+#else
+        (void) count;
+        throw std::system_error(ENOSYS, std::generic_category(), "MirroredStorage");
+#endif
+    }
+
+    Type*           data_   = nullptr;
+    std::size_t     size_   = 0;
+};
+
+}
+
+#endif // _MIRRORED_STORAGE_HPP__
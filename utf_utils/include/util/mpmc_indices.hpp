@@ -0,0 +1,196 @@
+#ifndef _MPMC_INDICES_HPP__
+#define _MPMC_INDICES_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+
+#include "util/buffer_policies.hpp"
+
+namespace util
+{
+
+// Slot bookkeeping for a bounded multi-producer/multi-consumer
+// ring, after Vyukov's bounded MPMC queue. Every slot carries a
+// sequence number; for the slot at position p (index p % capacity)
+//
+//      sequence == p       the slot is free for this lap,
+//      sequence == p + 1   the slot holds committed data,
+//
+// and a consumer hands it to the next lap by storing p + capacity.
+// Producers and consumers claim runs of consecutive slots with a
+// single CAS on their shared position, so any number of
+// reservations and read blocks may be outstanding at once, each
+// owned by exactly one thread.
+//
+// A reservation may be committed short. The unused tail is then
+// published as a skip run (its first slot records its length),
+// which consumers step over without returning it.
+template<typename SizeType>
+class MpmcIndices
+{
+public:
+    using Block = std::tuple<SizeType, SizeType>;
+
+    explicit MpmcIndices(SizeType capacity)
+        : capacity_(capacity)
+        , mask_(static_cast<std::size_t>(capacity) - 1)
+        , slots_(new Slot[capacity])
+        , producer_()
+        , consumer_()
+    {
+        for (std::size_t i = 0; i < capacity_; ++i)
+            slots_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcIndices(const MpmcIndices&)             = delete;
+    MpmcIndices& operator=(const MpmcIndices&)  = delete;
+
+    // producer side, any thread
+    [[nodiscard]] decltype(auto) reserve(SizeType size_requested) noexcept;
+    decltype(auto) commit(SizeType begin, SizeType size_reserved, SizeType size_committed) noexcept;
+
+    // consumer side, any thread
+    [[nodiscard]] decltype(auto) readable(SizeType size_requested) noexcept;
+    decltype(auto) release(SizeType begin, SizeType size_claimed) noexcept;
+
+private:
+    struct Slot
+    {
+        std::atomic<std::size_t>    sequence_{0};
+        std::atomic<SizeType>       skip_{0};
+    };
+
+    struct alignas(k_Cache_Line_Size) Position
+    {
+        std::atomic<std::size_t>    position_{0};
+    };
+
+    const std::size_t           capacity_;
+    const std::size_t           mask_;
+    std::unique_ptr<Slot[]>     slots_;
+    Position                    producer_;
+    Position                    consumer_;
+};
+
+template<typename SizeType>
+inline
+decltype(auto) MpmcIndices<SizeType>::reserve(SizeType size_requested) noexcept
+{
+    std::size_t position    = producer_.position_.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        std::size_t begin   = position & mask_;
+        std::size_t limit   = capacity_ - begin;
+        std::size_t size    = 0;
+
+        if (limit > size_requested)
+            limit   = size_requested;
+
+        while (size < limit && slots_[begin + size].sequence_.load(std::memory_order_acquire) == position + size)
+            ++size;
+
+        if (size == 0)
+        {
+            // Either the ring is full or another producer moved on;
+            // only the latter is worth another look.
+            std::size_t current = producer_.position_.load(std::memory_order_relaxed);
+            if (current == position)
+                return Block(static_cast<SizeType>(begin), 0);
+
+            position    = current;
+            continue;
+        }
+
+        if (producer_.position_.compare_exchange_weak(position, position + size, std::memory_order_relaxed))
+            return Block(static_cast<SizeType>(begin), static_cast<SizeType>(size));
+    }
+}
+
+template<typename SizeType>
+inline
+decltype(auto) MpmcIndices<SizeType>::commit(SizeType begin, SizeType size_reserved, SizeType size_committed) noexcept
+{
+    if (size_committed < size_reserved)
+        slots_[begin + size_committed].skip_.store(size_reserved - size_committed, std::memory_order_relaxed);
+
+    // Publish back to front: once a consumer sees the first slot,
+    // every later slot of the reservation is visible as well.
+    for (std::size_t i = static_cast<std::size_t>(begin) + size_reserved; i-- > begin; )
+    {
+        std::size_t sequence    = slots_[i].sequence_.load(std::memory_order_relaxed);
+        slots_[i].sequence_.store(sequence + 1, std::memory_order_release);
+    }
+}
+
+template<typename SizeType>
+inline
+decltype(auto) MpmcIndices<SizeType>::readable(SizeType size_requested) noexcept
+{
+    std::size_t position    = consumer_.position_.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        std::size_t begin   = position & mask_;
+
+        if (slots_[begin].sequence_.load(std::memory_order_acquire) != position + 1)
+        {
+            std::size_t current = consumer_.position_.load(std::memory_order_relaxed);
+            if (current == position)
+                return Block(static_cast<SizeType>(begin), 0);
+
+            position    = current;
+            continue;
+        }
+
+        if (SizeType skip = slots_[begin].skip_.load(std::memory_order_relaxed); skip > 0)
+        {
+            // Reservations are published back to front, so the rest
+            // of the run is visible already.
+            if (consumer_.position_.compare_exchange_weak(position, position + skip, std::memory_order_relaxed))
+            {
+                slots_[begin].skip_.store(0, std::memory_order_relaxed);
+                release(static_cast<SizeType>(begin), skip);
+                position    = consumer_.position_.load(std::memory_order_relaxed);
+            }
+            continue;
+        }
+
+        std::size_t limit   = capacity_ - begin;
+        std::size_t size    = 1;
+
+        if (limit > size_requested)
+            limit   = size_requested;
+
+        while (size < limit
+            && slots_[begin + size].sequence_.load(std::memory_order_acquire) == position + size + 1
+            && slots_[begin + size].skip_.load(std::memory_order_relaxed) == 0)
+            ++size;
+
+        if (size > limit)
+            size    = limit;
+
+        if (size == 0)
+            return Block(static_cast<SizeType>(begin), 0);
+
+        if (consumer_.position_.compare_exchange_weak(position, position + size, std::memory_order_relaxed))
+            return Block(static_cast<SizeType>(begin), static_cast<SizeType>(size));
+    }
+}
+
+template<typename SizeType>
+inline
+decltype(auto) MpmcIndices<SizeType>::release(SizeType begin, SizeType size_claimed) noexcept
+{
+    for (std::size_t i = begin; i < static_cast<std::size_t>(begin) + size_claimed; ++i)
+    {
+        std::size_t sequence    = slots_[i].sequence_.load(std::memory_order_relaxed);
+        slots_[i].sequence_.store(sequence + capacity_ - 1, std::memory_order_release);
+    }
+}
+
+}
+
+#endif // _MPMC_INDICES_HPP__
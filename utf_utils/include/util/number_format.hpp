@@ -0,0 +1,150 @@
+#ifndef _NUMBER_FORMAT_HPP__
+#define _NUMBER_FORMAT_HPP__
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace util
+{
+
+// Writers for numbers in text form. Each writes into a caller
+// provided buffer of at least k_Max_*_Size chars and returns the
+// end of what it wrote; there is no terminating '\0'.
+
+template<typename Type>
+inline constexpr bool is_char_v = std::is_same_v<Type, char> || std::is_same_v<Type, signed char> || std::is_same_v<Type, unsigned char>
+                               || std::is_same_v<Type, char8_t> || std::is_same_v<Type, char16_t> || std::is_same_v<Type, char32_t>
+                               || std::is_same_v<Type, wchar_t>;
+
+// Integers other than bool and the character types, which are
+// text rather than numbers.
+template<typename Type>
+inline constexpr bool is_number_v   = std::is_integral_v<Type> && !std::is_same_v<Type, bool> && !is_char_v<Type>;
+
+inline constexpr std::size_t k_Max_Integer_Size = 20;      // -9223372036854775808, 18446744073709551615
+inline constexpr std::size_t k_Max_Float_Size   = 24;      // -1.7976931348623157e+308 and friends
+
+// "00", "01", ..., "99": two digits per division by 100.
+inline constexpr auto k_Digit_Pairs = []()
+    {
+        std::array<char, 200> pairs {};
+
+        for (int index = 0; index < 100; ++index)
+        {
+            pairs[2 * index]        = static_cast<char>('0' + index / 10);
+            pairs[2 * index + 1]    = static_cast<char>('0' + index % 10);
+        }
+
+        return pairs;
+    }();
+
+inline constexpr std::uint64_t k_Powers_Of_10[] =
+{
+    0,  // so that 0 counts as one digit
+    10ull,                  100ull,                     1000ull,                    10000ull,
+    100000ull,              1000000ull,                 10000000ull,                100000000ull,
+    1000000000ull,          10000000000ull,             100000000000ull,            1000000000000ull,
+    10000000000000ull,      100000000000000ull,         1000000000000000ull,        10000000000000000ull,
+    100000000000000000ull,  1000000000000000000ull,     10000000000000000000ull
+};
+
+// Number of decimal digits; log10 from the bit width (1233/4096
+// is just above log10(2)), corrected by one comparison.
+[[nodiscard]] inline std::uint32_t decimal_digits(std::uint64_t value) noexcept
+{
+    std::uint32_t guess = (static_cast<std::uint32_t>(std::bit_width(value | 1)) * 1233) >> 12;
+
+    return guess + 1 - (value < k_Powers_Of_10[guess]);
+}
+
+// Exactly digits digits of value, zero padded on the left.
+inline char* format_digits(char* output, std::uint64_t value, std::uint32_t digits) noexcept
+{
+    char* end   = output + digits;
+    char* last  = end;
+
+    while (digits >= 2)
+    {
+        const char* pair    = &k_Digit_Pairs[2 * (value % 100)];
+
+        value  /= 100;
+        digits -= 2;
+        *--last = pair[1];
+        *--last = pair[0];
+    }
+
+    if (digits == 1)
+        *--last = static_cast<char>('0' + value % 10);
+
+    return end;
+}
+
+template<typename Integer, std::enable_if_t<is_number_v<Integer>, int> = 0>
+inline char* format_integer(char* output, Integer value) noexcept
+{
+    std::uint64_t magnitude = static_cast<std::uint64_t>(value);
+
+    if constexpr (std::is_signed_v<Integer>)
+    {
+        if (value < 0)
+        {
+            *output++   = '-';
+            magnitude   = 0 - magnitude;
+        }
+    }
+
+    return format_digits(output, magnitude, decimal_digits(magnitude));
+}
+
+// Shortest text that reads back as the same value. libstdc++'s
+// to_chars implements this with Ryu.
+template<typename Float, std::enable_if_t<std::is_floating_point_v<Float>, int> = 0>
+inline char* format_float(char* output, Float value) noexcept
+{
+    static_assert(!std::is_same_v<Float, long double>, "long double may need more than k_Max_Float_Size chars");
+
+    return std::to_chars(output, output + k_Max_Float_Size, value).ptr;
+}
+
+// A decimal with t_Decimals places stored as a scaled integer,
+// e.g. FixedPoint<4>{1234500} for the price 123.4500.
+template<std::uint32_t t_Decimals, typename Integer = std::int64_t>
+struct FixedPoint
+{
+    static_assert(is_number_v<Integer> && t_Decimals > 0 && t_Decimals < 20, "FixedPoint needs an integer and 1 to 19 decimals");
+
+    static constexpr std::size_t    k_Max_Size  = k_Max_Integer_Size + 2;
+
+    Integer     value_;
+};
+
+template<std::uint32_t t_Decimals, typename Integer>
+inline char* format_fixed(char* output, FixedPoint<t_Decimals, Integer> number) noexcept
+{
+    std::uint64_t magnitude = static_cast<std::uint64_t>(number.value_);
+
+    if constexpr (std::is_signed_v<Integer>)
+    {
+        if (number.value_ < 0)
+        {
+            *output++   = '-';
+            magnitude   = 0 - magnitude;
+        }
+    }
+
+    constexpr std::uint64_t k_Scale = k_Powers_Of_10[t_Decimals];
+
+    output      = format_integer(output, magnitude / k_Scale);
+    *output++   = '.';
+
+    return format_digits(output, magnitude % k_Scale, t_Decimals);
+}
+
+}
+
+#endif // _NUMBER_FORMAT_HPP__
@@ -0,0 +1,323 @@
+#ifndef _RECORD_RING_HPP__
+#define _RECORD_RING_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace util
+{
+
+// Whether Ring hands out single spans across its wrap point
+// (RingBuffer with MirroredPolicy); false for rings that don't say.
+template<typename Ring, typename = void>
+struct is_contiguous_ring : std::false_type {};
+
+template<typename Ring>
+struct is_contiguous_ring<Ring, std::void_t<decltype(Ring::k_Contiguous)>> : std::bool_constant<Ring::k_Contiguous> {};
+
+// Length-prefixed records on top of an SPSC byte ring, read in
+// place. Every record is a 32-bit header holding the payload size,
+// followed by the payload, padded to k_Record_Alignment; it is
+// reserved and committed as a whole, so the consumer never sees
+// half a record.
+//
+// With a mirrored ring every record is one span wherever it lies.
+// On other rings a record that doesn't fit the space left at the
+// back is preceded by a padding record covering that space, which
+// readers skip, and starts again at the front. Such rings should
+// hold a multiple of k_Record_Alignment elements.
+//
+// push_record()/emplace_record() belong to the producer side,
+// peek_record()/pop_record()/consume_records() to the consumer.
+template<typename Ring>
+class RecordRing
+{
+public:
+    using Type      = typename Ring::value_type;
+    using SizeType  = typename Ring::size_type;
+    using Header    = std::uint32_t;
+
+    static_assert(sizeof(Type) == 1 && std::is_trivially_copyable_v<Type>, "records are kept in byte rings");
+
+    static constexpr SizeType   k_Header_Size       = sizeof(Header);
+    static constexpr SizeType   k_Record_Alignment  = alignof(Header);
+    static constexpr Header     k_Padding           = Header(1) << 31;
+    static constexpr Header     k_Max_Payload       = k_Padding - 1;
+
+    explicit RecordRing(Ring& ring) noexcept
+        : ring_(ring)
+        , peeked_(0)
+    {}
+
+    RecordRing(const RecordRing&)             = delete;
+    RecordRing& operator=(const RecordRing&)  = delete;
+
+    // Space one record with a payload of size elements occupies.
+    [[nodiscard]] static constexpr SizeType footprint(SizeType size) noexcept
+    {
+        return static_cast<SizeType>((k_Header_Size + size + k_Record_Alignment - 1) & ~(k_Record_Alignment - 1));
+    }
+
+    // Reserves a record of size elements and lets fill(span) write
+    // the payload in place, e.g. straight from recv(); false if the
+    // ring has no room for it right now.
+    template<typename Fill>
+    [[nodiscard]] bool emplace_record(SizeType size, Fill&& fill) noexcept(noexcept(fill(std::span<Type>())));
+
+    // The same in two steps, for payloads written piece by piece:
+    // begin_record() returns room for up to max_size elements (empty
+    // if there is none), end_record() commits the first size of them
+    // as one record. Nothing else may be pushed in between.
+    [[nodiscard]] std::span<Type> begin_record(SizeType max_size) noexcept;
+    void end_record(SizeType size) noexcept;
+
+    [[nodiscard]] bool push_record(std::span<const Type> payload) noexcept
+    {
+        return emplace_record(static_cast<SizeType>(payload.size()), [&payload](std::span<Type> record)
+            {
+                std::memcpy(record.data(), payload.data(), payload.size());
+            });
+    }
+
+    // The oldest record's payload, in place in the ring, until the
+    // next pop_record(); empty if there is none.
+    [[nodiscard]] decltype(auto) peek_record() noexcept;
+
+    // Releases the oldest record, peeked or not; false if there is
+    // none.
+    decltype(auto) pop_record() noexcept;
+
+    // Batched pop: calls visit(span) for every record readable as
+    // one block, at most max_records of them, then releases them all
+    // at once. Returns the number of records visited.
+    template<typename Visitor>
+    decltype(auto) consume_records(Visitor&& visit, SizeType max_records = std::numeric_limits<SizeType>::max());
+
+    // Deferred release, for consumers that keep several records in
+    // place (e.g. for one writev()) before giving them back; mirrored
+    // rings only. record_at(offset) returns the payload and the size
+    // of the record offset elements past the oldest one, offset being
+    // the sum of the sizes of the records before it; an empty payload
+    // if there is none. release_records(size) then releases them.
+    [[nodiscard]] decltype(auto) record_at(SizeType offset) noexcept;
+    decltype(auto) release_records(SizeType size) noexcept;
+
+protected:
+    [[nodiscard]] static Header header(const Type* record) noexcept
+    {
+        Header value;
+        std::memcpy(&value, record, sizeof(Header));
+        return value;
+    }
+
+    static void header(Type* record, Header value) noexcept
+    {
+        std::memcpy(record, &value, sizeof(Header));
+    }
+
+    [[nodiscard]] static SizeType record_size(Header value) noexcept
+    {
+        return (value & k_Padding) ? static_cast<SizeType>(value & k_Max_Payload) : footprint(static_cast<SizeType>(value));
+    }
+
+private:
+    using Handle    = typename Ring::Handle;
+
+    Ring&                   ring_;
+    SizeType                peeked_;
+    std::optional<Handle>   pending_;
+};
+
+template<typename Ring>
+template<typename Fill>
+inline
+bool RecordRing<Ring>::emplace_record(SizeType size, Fill&& fill) noexcept(noexcept(fill(std::span<Type>())))
+{
+    if (size > k_Max_Payload)
+        return false;
+
+    auto    payload = begin_record(size);
+
+    if (!pending_)
+        return false;
+
+    fill(payload.first(size));
+    end_record(size);
+
+    return true;
+}
+
+template<typename Ring>
+inline
+std::span<typename Ring::value_type> RecordRing<Ring>::begin_record(SizeType max_size) noexcept
+{
+    if (max_size > k_Max_Payload)
+        max_size = k_Max_Payload;
+
+    SizeType    needed  = footprint(max_size);
+    auto        handle  = ring_.buffer(needed);
+
+    if constexpr (!is_contiguous_ring<Ring>::value)
+    {
+        // Too short and at the back of the ring: pad it out and
+        // start over at the front.
+        bool at_back = handle.capacity() >= k_Header_Size
+                    && handle.data() + handle.capacity() == ring_.data() + ring_.capacity();
+
+        if (handle.capacity() < needed && at_back)
+        {
+            header(handle.data(), k_Padding | static_cast<Header>(handle.capacity()));
+            handle.size(handle.capacity());
+            ring_.commit(handle);
+
+            handle = ring_.buffer(needed);
+        }
+    }
+
+    if (handle.capacity() < needed)
+    {
+        handle.size(0);
+        ring_.commit(handle);
+        return std::span<Type>();
+    }
+
+    Type*   payload = handle.data() + k_Header_Size;
+
+    pending_.emplace(std::move(handle));
+
+    return std::span<Type>(payload, max_size);
+}
+
+template<typename Ring>
+inline
+void RecordRing<Ring>::end_record(SizeType size) noexcept
+{
+    if (!pending_)
+        return;
+
+    header(pending_->data(), static_cast<Header>(size));
+
+    pending_->size(footprint(size));
+    ring_.commit(*pending_);
+    pending_.reset();
+}
+
+template<typename Ring>
+inline
+decltype(auto) RecordRing<Ring>::peek_record() noexcept
+{
+    for (;;)
+    {
+        auto    handle  = ring_.read_block();
+
+        if (handle.capacity() < k_Header_Size)
+        {
+            peeked_ = 0;
+            handle.size(0);
+            return std::span<const Type>();
+        }
+
+        Header  value   = header(handle.data());
+
+        if (value & k_Padding)
+        {
+            handle.size(record_size(value));
+            ring_.release(handle);
+            continue;
+        }
+
+        peeked_ = record_size(value);
+        handle.size(0);
+
+        return std::span<const Type>(handle.data() + k_Header_Size, static_cast<SizeType>(value));
+    }
+}
+
+template<typename Ring>
+inline
+decltype(auto) RecordRing<Ring>::pop_record() noexcept
+{
+    if (peeked_ == 0 && peek_record().data() == nullptr)
+        return false;
+
+    auto    handle  = ring_.read_block(peeked_);
+
+    handle.size(peeked_);
+    ring_.release(handle);
+    peeked_ = 0;
+
+    return true;
+}
+
+template<typename Ring>
+template<typename Visitor>
+inline
+decltype(auto) RecordRing<Ring>::consume_records(Visitor&& visit, SizeType max_records)
+{
+    auto        handle  = ring_.read_block();
+    Type*       block   = handle.data();
+    SizeType    size    = handle.capacity();
+    SizeType    offset  = 0;
+    SizeType    records = 0;
+
+    while (records < max_records && size - offset >= k_Header_Size)
+    {
+        Header  value   = header(block + offset);
+
+        if (!(value & k_Padding))
+        {
+            visit(std::span<const Type>(block + offset + k_Header_Size, static_cast<SizeType>(value)));
+            ++records;
+        }
+
+        offset += record_size(value);
+    }
+
+    peeked_ = 0;
+    handle.size(offset);
+    ring_.release(handle);
+
+    return records;
+}
+
+template<typename Ring>
+inline
+decltype(auto) RecordRing<Ring>::record_at(SizeType offset) noexcept
+{
+    static_assert(is_contiguous_ring<Ring>::value, "records past the oldest are only contiguous in a mirrored ring");
+
+    using Result    = std::tuple<std::span<const Type>, SizeType>;
+
+    auto    handle  = ring_.read_block();
+
+    handle.size(0);
+
+    if (handle.capacity() < offset + k_Header_Size)
+        return Result(std::span<const Type>(), 0);
+
+    Header  value   = header(handle.data() + offset);
+
+    return Result(std::span<const Type>(handle.data() + offset + k_Header_Size, static_cast<SizeType>(value)), record_size(value));
+}
+
+template<typename Ring>
+inline
+decltype(auto) RecordRing<Ring>::release_records(SizeType size) noexcept
+{
+    auto    handle  = ring_.read_block(size);
+
+    handle.size(size);
+    ring_.release(handle);
+    peeked_ = 0;
+}
+
+}
+
+#endif // _RECORD_RING_HPP__
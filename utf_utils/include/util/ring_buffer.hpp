@@ -4,18 +4,38 @@
 #include <vector>
 #include <memory>
 #include <limits>
+#include <functional>
 
-#include "util/bool_lock.hpp"
+#include "util/atomic_lock.hpp"
+#include "util/buffer_policies.hpp"
+#include "util/buffer_telemetry.hpp"
+#include "util/delimiter_scan.hpp"
 #include "util/helper_functions.hpp"
+#include "util/mapped_storage.hpp"
+#include "util/mirrored_storage.hpp"
+#include "util/mpmc_indices.hpp"
+#include "util/spsc_indices.hpp"
+#include "util/vectored_handle.hpp"
+#include "util/wait_strategy.hpp"
 
 namespace util
 {
 
+// Args may carry allocation policies (HugePagePolicy,
+// NumaNodePolicy, NoZeroInitPolicy) which place the elements
+// in MappedStorage instead of a std::vector, e.g.
+// RingBuffer<T, S, N, HugePagePolicy<>, NumaNodePolicy<0>>.
 template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
 class RingBuffer
 {
 public:
+    // The SPSC and MPMC specializations match only on the first
+    // policy; a tag further down would silently select this one.
+    static_assert(!has_policy_v<SpscPolicy, Args...> && !has_policy_v<MpmcPolicy, Args...>,
+                  "SpscPolicy/MpmcPolicy must be the first RingBuffer policy");
+
     using value_type    = Type;
+    using size_type     = SizeType;
     struct Handle
     {
     public:
@@ -83,15 +103,12 @@ public:
 
     using ReadSizeStatus    = std::tuple<SizeType, bool>;
 
-    RingBuffer() noexcept
+    RingBuffer() noexcept(!AllocationPolicies<Args...>::k_Mapped)
         : buffer_(t_Size, Type())
         , sizes_(t_Size)
         , state_(State::Beginning)
-        , operators_()
         , lock_()
-    {
-        initialize();
-    }
+    {}
 
     ~RingBuffer() noexcept
     {
@@ -106,7 +123,12 @@ public:
     [[nodiscard]] decltype(auto) read_block(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
 
     using CheckDelimiter   = std::function<bool (const Type*, const Type*, const SizeType)>;
-    [[nodiscard]] decltype(auto) read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, CheckDelimiter check_delimiter = [](const Type*, const Type*, const SizeType) { return true; } ) noexcept;
+    [[nodiscard]] decltype(auto) read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, CheckDelimiter check_delimiter) noexcept;
+
+    // As above, with the predicate as a functor type so that it can
+    // be inlined into the scan; the default accepts every match.
+    template<typename Predicate = AcceptDelimiter>
+    [[nodiscard]] decltype(auto) read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, Predicate check_delimiter = Predicate()) noexcept;
 
     [[nodiscard]] decltype(auto) read_fixed_size(Type* destination_buffer, const int64_t read_size) noexcept;
 
@@ -120,23 +142,29 @@ public:
         return buffer_.data();
     }
 
+    // Counters kept with TelemetryPolicy (see buffer_telemetry.hpp);
+    // all zero without it.
+    [[nodiscard]] decltype(auto) telemetry() noexcept
+    {
+        return (telemetry_);
+    }
+
 protected:
-    decltype(auto) initialize() noexcept;
+    // One switch per operation over state_, in place of per-state
+    // std::function tables, so that the hot path can be inlined.
+    [[nodiscard]] decltype(auto) reserve_operation(SizeType size_requested) noexcept;
+    void commit_operation(Handle& handle) noexcept;
+    void release_operation(SizeType size_released) noexcept;
+    [[nodiscard]] decltype(auto) movable_block(SizeType size_requested) noexcept;
     [[nodiscard]] decltype(auto) reserve_back(SizeType size_requested) noexcept;
     [[nodiscard]] decltype(auto) reserve_front(SizeType size_requested) noexcept;
     [[nodiscard]] decltype(auto) commit_back(Handle& handle) noexcept;
     [[nodiscard]] decltype(auto) commit_front(Handle& handle) noexcept;
 
-    using StorageType           = std::vector<Type>;
-    using Lock                  = BoolLock;
+    using StorageType           = buffer_storage_t<Type, Args...>;
+    using Lock                  = util::AtomicLock;
+    using Telemetry             = buffer_telemetry_t<Args...>;
     using Block                 = std::tuple<SizeType, SizeType>;
-    using ReserveOperator       = std::function<Block (SizeType)>;
-    using CommitOperator        = std::function<void (Handle&)>;
-    using ReleaseOperator       = std::function<void (SizeType)>;
-    using ReadBlockOperator     = std::function<Block (SizeType)>;
-    using ReserveOperators      = std::vector<ReserveOperator>;
-    using CommitOperators       = std::vector<CommitOperator>;
-    using ReleaseOperators      = std::vector<ReleaseOperator>;
 
     enum class State : std::uint8_t
     {
@@ -183,190 +211,147 @@ protected:
         }
     };
 
-    struct Operators
-    {
-        ReserveOperators    reserve_operators_;
-        CommitOperators     commit_operators_;
-        ReleaseOperators    release_operators_;
-
-        Operators() noexcept
-            : reserve_operators_()
-            , commit_operators_()
-            , release_operators_()
-        {}
-
-        Operators(Operators&& operators) noexcept
-            : reserve_operators_(std::move(operators.reserve_operators_))
-            , commit_operators_(std::move(operators.commit_operators_))
-            , release_operators_(std::move(operators.release_operators_))
-        {}
-
-        Operators& operator=(Operators&& operators) noexcept
-        {
-            reserve_operators_  = std::move(operators.reserve_operators_);
-            commit_operators_   = std::move(operators.commit_operators_);
-            release_operators_  = std::move(operators.release_operators_);
-
-            return *this;
-        }
-
-        ~Operators() noexcept
-        {}
-    };
-
 private:
     StorageType         buffer_;
     Sizes               sizes_;
     State               state_;
-    Operators           operators_;
-    ReadBlockOperator   movable_block_;
     Lock                lock_;
+
+    [[no_unique_address]] Telemetry telemetry_;
 };
 
 template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
 inline
-decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::initialize() noexcept
+decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::reserve_operation(SizeType size_requested) noexcept
 {
-    // reserve - State::Beginning
-    operators_.reserve_operators_.emplace_back(
-            [this](SizeType size_requested)
-            {
-                return reserve_back(size_requested);
-            }
-        );
+    switch (state_)
+    {
+        case State::Beginning:
+        case State::Progressed:
+            return reserve_back(size_requested);
 
-    // reserve - State::Progressed
-    operators_.reserve_operators_.emplace_back(
-            [this](SizeType size_requested)
-            {
-                return reserve_back(size_requested);
-            }
-        );
+        case State::Rolledover:
+        default:
+            return reserve_front(size_requested);
+    }
+}
 
-    // reserve - State::Rolledover
-    operators_.reserve_operators_.emplace_back(
-            [this](SizeType size_requested)
-            {
-                return reserve_front(size_requested);
-            }
-        );
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+void RingBuffer<Type, SizeType, t_Size, Args...>::commit_operation(Handle& handle) noexcept
+{
+    switch (state_)
+    {
+        case State::Beginning:
+        {
+            commit_back(handle);
 
-    // commit - State::Beginning
-    operators_.commit_operators_.emplace_back(
-            [this](Handle& handle)
-            {
-                commit_back(handle);
+            return;
+        }
 
-                return;
-            }
-        );
+        case State::Progressed:
+        {
+            commit_back(handle);
 
-    // commit - State::Progressed
-    operators_.commit_operators_.emplace_back(
-            [this](Handle& handle)
+            if (sizes_.head_ == sizes_.tail_)
             {
-                commit_back(handle);
-
-                if (sizes_.head_ == sizes_.tail_)
-                {
-                    state_  = State::Beginning;
-                    sizes_  = std::move(Sizes(sizes_.capacity_));
-
-                    return;
-                }
-
-                if (sizes_.tail_ == sizes_.capacity_)
-                {
-                    sizes_.end_ = 0;
-                    state_  = State::Rolledover;
-
-                    return;
-                }
+                state_  = State::Beginning;
+                sizes_  = std::move(Sizes(sizes_.capacity_));
 
                 return;
             }
-        );
 
-    // commit - State::Rolledover
-    operators_.commit_operators_.emplace_back(
-            [this](Handle& handle)
+            if (sizes_.tail_ == sizes_.capacity_)
             {
-                commit_front(handle);
+                sizes_.end_ = 0;
+                state_  = State::Rolledover;
 
                 return;
             }
-        );
-
-    // release - State::Beginning
-    operators_.release_operators_.emplace_back(
-            [this](SizeType size_released)
-            {
-                if (size_released != 0)
-                {
-                    sizes_.head_   += size_released;
 
-                    if (sizes_.head_ == sizes_.end_)
-                    {
-                        sizes_      = std::move(Sizes(sizes_.capacity_));
-                        return;
-                    }
+            return;
+        }
 
-                    state_          = (sizes_.tail_ == sizes_.capacity_) ? State::Rolledover : State::Progressed;
-                }
+        case State::Rolledover:
+        default:
+        {
+            commit_front(handle);
 
-                return;
-            }
-        );
+            return;
+        }
+    }
+}
 
-    // release - State::Progressed
-    operators_.release_operators_.emplace_back(
-            [this](SizeType size_released)
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+void RingBuffer<Type, SizeType, t_Size, Args...>::release_operation(SizeType size_released) noexcept
+{
+    switch (state_)
+    {
+        case State::Beginning:
+        {
+            if (size_released != 0)
             {
                 sizes_.head_   += size_released;
 
                 if (sizes_.head_ == sizes_.end_)
                 {
-                    state_      = State::Beginning;
                     sizes_      = std::move(Sizes(sizes_.capacity_));
-
                     return;
                 }
 
-                if (sizes_.tail_ == sizes_.capacity_)
-                    state_  = State::Rolledover;
-
-                return;
+                state_          = (sizes_.tail_ == sizes_.capacity_) ? State::Rolledover : State::Progressed;
             }
-        );
 
-    // release - State::Rolledover
-    operators_.release_operators_.emplace_back(
-            [this](SizeType size_released)
-            {
-                sizes_.head_   += size_released;
+            return;
+        }
 
-                if (sizes_.head_ == sizes_.tail_)
-                {
-                    state_          = State::Beginning;
-                    sizes_.head_    = 0;
-                    sizes_.tail_    = sizes_.last_;
-                    sizes_.last_    = 0;
-                }
+        case State::Progressed:
+        {
+            sizes_.head_   += size_released;
+
+            if (sizes_.head_ == sizes_.end_)
+            {
+                state_      = State::Beginning;
+                sizes_      = std::move(Sizes(sizes_.capacity_));
 
                 return;
             }
-        );
 
-    movable_block_  =
-        [this](SizeType size_requested)
+            if (sizes_.tail_ == sizes_.capacity_)
+                state_  = State::Rolledover;
+
+            return;
+        }
+
+        case State::Rolledover:
+        default:
         {
-            SizeType    size = sizes_.tail_ - sizes_.head_;
+            sizes_.head_   += size_released;
+
+            if (sizes_.head_ == sizes_.tail_)
+            {
+                state_          = State::Beginning;
+                sizes_.head_    = 0;
+                sizes_.tail_    = sizes_.last_;
+                sizes_.last_    = 0;
+            }
+
+            return;
+        }
+    }
+}
 
-            if (size > size_requested)
-                size    = size_requested;
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::movable_block(SizeType size_requested) noexcept
+{
+    SizeType    size = sizes_.tail_ - sizes_.head_;
+
+    if (size > size_requested)
+        size    = size_requested;
 
-            return Block(sizes_.head_, size);
-        };
+    return Block(sizes_.head_, size);
 
 }
 
@@ -435,7 +420,9 @@ decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::buffer(SizeType size
 {
     std::scoped_lock<Lock> lock(lock_);
 
-    auto&& [begin, capacity]    = operators_.reserve_operators_[to_index(state_)](size_requested);
+    auto&& [begin, capacity]    = reserve_operation(size_requested);
+
+    telemetry_.reserved(begin, size_requested, capacity);
 
     return Handle(this, begin, capacity);
 }
@@ -456,7 +443,9 @@ decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::move(const Type* con
         {
             std::scoped_lock<Lock> lock(lock_);
 
-            auto&& [begin, capacity] = operators_.reserve_operators_[to_index(state_)](remaining_size);
+            auto&& [begin, capacity] = reserve_operation(remaining_size);
+
+            telemetry_.reserved(begin, remaining_size, capacity);
 
             buffer_begin    = begin;
             buffer_size     = capacity;
@@ -486,7 +475,9 @@ inline
 decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::commit(Handle& handle) noexcept
 {
     std::scoped_lock<Lock>  lock(lock_);
-    operators_.commit_operators_[to_index(state_)](handle);
+
+    telemetry_.committed((handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_);
+    commit_operation(handle);
 }
 
 template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
@@ -496,7 +487,7 @@ decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::read(Type* destinati
     auto&& [begin, capacity]  = [this](auto size)
                 {
                     std::scoped_lock<Lock>  lock(lock_);
-                    return movable_block_(size);
+                    return movable_block(size);
                 }(read_size);
 
     Type* buffer    = data() + begin;
@@ -507,7 +498,8 @@ decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::read(Type* destinati
     [this](auto capacity)
     {
         std::scoped_lock<Lock>  lock(lock_);
-        operators_.release_operators_[to_index(state_)](capacity);
+        release_operation(capacity);
+        telemetry_.released(capacity);
     }(capacity);
 
     return capacity;
@@ -516,6 +508,14 @@ decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::read(Type* destinati
 template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
 inline
 decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, CheckDelimiter check_delimiter) noexcept
+{
+    return read<CheckDelimiter&>(destination_buffer, destination_buffer_size, delimiter, delimiter_size, check_delimiter);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+template<typename Predicate>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, Predicate check_delimiter) noexcept
 {
     bool        delimiter_found     = false;
     SizeType    data_size           = 0;
@@ -525,41 +525,19 @@ decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::read(Type* destinati
         auto&& [movable_offset, movable_size]  = [this]()
                     {
                         std::scoped_lock<Lock>  lock(lock_);
-                        return movable_block_(std::numeric_limits<SizeType>::max());
+                        return movable_block(std::numeric_limits<SizeType>::max());
                     }();
 
         Type* movable_buffer    = data() + movable_offset;
         SizeType index          = 0;
 
-        for (index = 0; index < movable_size && data_size < destination_buffer_size; ++index)
-        {
-            destination_buffer[data_size++] = std::move(movable_buffer[index]);
-
-            if (index > delimiter_size)
-            {
-                bool    delimiter_match = true;
-                for (SizeType i = 0; i < delimiter_size; ++i)
-                {
-                    if (destination_buffer[data_size - 1 - i] != delimiter[delimiter_size - 1 - i])
-                    {
-                        delimiter_match = false;
-                        break;
-                    }
-                }
-
-                if (delimiter_match && check_delimiter(destination_buffer, delimiter, delimiter_size))
-                {
-                    delimiter_found = true;
-                    ++index;
-                    break;
-                }
-            }
-        }
+        std::tie(index, delimiter_found) = scan_delimited(movable_buffer, movable_size, destination_buffer, data_size, destination_buffer_size, delimiter, delimiter_size, check_delimiter);
 
         [this](auto index)
         {
             std::scoped_lock<Lock>  lock(lock_);
-            operators_.release_operators_[to_index(state_)](index);
+            release_operation(index);
+            telemetry_.released(index);
         }(index);
 
     } while(!delimiter_found && data_size < destination_buffer_size);
@@ -574,9 +552,11 @@ decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::read_block(SizeType
     auto&& [begin, size]  = [this](auto size)
                 {
                     std::scoped_lock<Lock>  lock(lock_);
-                    return movable_block_(size);
+                    return movable_block(size);
                 }(size_requested);
 
+    telemetry_.readable(size);
+
     return Handle(this, begin, size);
 }
 
@@ -591,7 +571,7 @@ decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::read_fixed_size(Type
         auto&& [offset, capacity]  = [this]()
                     {
                         std::scoped_lock<Lock>  lock(lock_);
-                        return movable_block_(std::numeric_limits<SizeType>::max());
+                        return movable_block(std::numeric_limits<SizeType>::max());
                     }();
 
         SizeType    index   = 0;
@@ -605,7 +585,8 @@ decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::read_fixed_size(Type
         [this](auto index)
         {
             std::scoped_lock<Lock>  lock(lock_);
-            operators_.release_operators_[to_index(state_)](index);
+            release_operation(index);
+            telemetry_.released(index);
         }(index);
 
     } while(data_size < read_size);
@@ -621,7 +602,8 @@ decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::release(Handle& hand
 
     SizeType release_size   = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_;
 
-    operators_.release_operators_[to_index(state_)](release_size);
+    release_operation(release_size);
+    telemetry_.released(release_size);
 
     handle.capacity_        = 0;
     handle.size_            = 0;
@@ -629,6 +611,734 @@ decltype(auto) RingBuffer<Type, SizeType, t_Size, Args...>::release(Handle& hand
     return;
 }
 
+
+// Single-producer/single-consumer specialization. Same
+// interface as the general RingBuffer, but reserve/commit
+// and read/release synchronize only through the acquire/
+// release indices of SpscIndices; there is no lock and no
+// operator table. buffer(), move() and commit() must only
+// be called from the producer thread, the read functions
+// and release() only from the consumer thread.
+//
+// Adding MirroredPolicy maps the storage twice (see
+// MirroredStorage), so a block never stops short at the end
+// of the buffer: RingBuffer<T, S, N, SpscPolicy, MirroredPolicy>.
+// The capacity is then rounded up to whole pages.
+//
+// Without MirroredPolicy, the allocation policies of
+// buffer_policies.hpp (HugePagePolicy, NumaNodePolicy,
+// NoZeroInitPolicy) may be added here as with every other
+// RingBuffer; they select MappedStorage.
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+class RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>
+{
+public:
+    static_assert(!has_policy_v<MpmcPolicy, Args...>, "SpscPolicy and MpmcPolicy are exclusive");
+
+    using value_type    = Type;
+    using size_type     = SizeType;
+    struct Handle
+    {
+    public:
+        explicit Handle(RingBuffer* parent, SizeType begin, SizeType capacity, bool reader = false) noexcept
+            : parent_(parent)
+            , reader_(reader)
+            , begin_(begin)
+            , capacity_(capacity)
+            , size_(0)
+        {}
+
+        Handle()    = delete;
+
+        Handle(Handle&& handle) noexcept
+            : parent_(std::move(handle.parent_))
+            , reader_(std::move(handle.reader_))
+            , begin_(std::move(handle.begin_))
+            , capacity_(std::move(handle.capacity_))
+            , size_(std::move(handle.size_))
+        {
+            handle.size_        = 0;
+            handle.capacity_    = 0;
+        }
+
+        Handle& operator=(Handle&& handle) noexcept
+        {
+            parent_             = std::move(handle.parent_);
+            reader_             = std::move(handle.reader_);
+            begin_              = std::move(handle.begin_);
+            capacity_           = std::move(handle.capacity_);
+            size_               = std::move(handle.size_);
+
+            handle.size_        = 0;
+            handle.capacity_    = 0;
+
+            return *this;
+        }
+
+        [[nodiscard]] decltype(auto) data() noexcept
+        {
+            return parent_->data() + begin_;
+        }
+
+        [[nodiscard]] decltype(auto) capacity() noexcept
+        {
+            return capacity_;
+        }
+
+        void size(SizeType s) noexcept
+        {
+            size_   = s;
+        }
+
+        // A handle from read_block() is released rather than
+        // committed, as it belongs to the consumer side.
+        ~Handle() noexcept
+        {
+            if (capacity_ > 0)
+            {
+                if (reader_)
+                    parent_->release(*this);
+                else
+                    parent_->commit(*this);
+            }
+        }
+
+    private:
+        RingBuffer*     parent_;
+        bool            reader_;
+
+    public:
+        SizeType        begin_;
+        SizeType        capacity_;
+        SizeType        size_;
+    };
+
+    using ReadSizeStatus    = std::tuple<SizeType, bool>;
+
+    using VectoredHandle    = util::VectoredHandle<RingBuffer, SizeType>;
+
+    RingBuffer() noexcept(!k_Mirrored && !AllocationPolicies<Args...>::k_Mapped && std::is_nothrow_default_constructible_v<Waiter>)
+        : buffer_(t_Size, Type())
+        , indices_(static_cast<SizeType>(buffer_.size()), false)
+    {}
+
+    ~RingBuffer() noexcept
+    {
+        buffer_.clear();
+    }
+
+    RingBuffer(const RingBuffer&)             = delete;
+    RingBuffer& operator=(const RingBuffer&)  = delete;
+
+    [[nodiscard]] decltype(auto) buffer(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+    [[nodiscard]] decltype(auto) read(Type* destination_buffer, const SizeType read_size = 1) noexcept;
+    [[nodiscard]] decltype(auto) read_block(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+
+    using CheckDelimiter   = std::function<bool (const Type*, const Type*, const SizeType)>;
+    [[nodiscard]] decltype(auto) read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, CheckDelimiter check_delimiter) noexcept;
+
+    // As above, with the predicate as a functor type so that it can
+    // be inlined into the scan; the default accepts every match.
+    template<typename Predicate = AcceptDelimiter>
+    [[nodiscard]] decltype(auto) read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, Predicate check_delimiter = Predicate()) noexcept;
+
+    [[nodiscard]] decltype(auto) read_fixed_size(Type* destination_buffer, const int64_t read_size) noexcept;
+
+    decltype(auto) move(const Type* const move_buffer, const SizeType move_size) noexcept;
+    decltype(auto) commit(Handle& handle) noexcept;
+
+    decltype(auto) release(Handle& handle) noexcept;
+
+    // Both spans on either side of the wrap point as an iovec pair,
+    // for a single readv/writev/recvmsg. Commit/release account for
+    // both spans in one index update. Trivially copyable types only.
+    [[nodiscard]] decltype(auto) reserve_vectored(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+    decltype(auto) commit(VectoredHandle& handle) noexcept;
+    [[nodiscard]] decltype(auto) read_vectored(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+    decltype(auto) release(VectoredHandle& handle) noexcept;
+
+    // Blocking waits with the strategy named in Args (SpinWait,
+    // FutexWait or EventFdWait, see wait_strategy.hpp): until
+    // read_block() would return data, on the consumer thread, and
+    // until buffer() would return space, on the producer thread.
+    // The blocking move()/read() variants wait the same way.
+    decltype(auto) wait_readable() noexcept;
+    decltype(auto) wait_writable() noexcept;
+
+    // The strategy objects themselves, e.g. for EventFdWait::fd().
+    [[nodiscard]] decltype(auto) readable_waiter() noexcept
+    {
+        return (readable_waiter_);
+    }
+
+    [[nodiscard]] decltype(auto) writable_waiter() noexcept
+    {
+        return (writable_waiter_);
+    }
+
+    [[nodiscard]] decltype(auto) data() noexcept
+    {
+        return buffer_.data();
+    }
+
+    // Elements in the ring; MirroredStorage rounds t_Size up to
+    // whole pages.
+    [[nodiscard]] decltype(auto) capacity() const noexcept
+    {
+        return static_cast<SizeType>(buffer_.size());
+    }
+
+    // Whether every reservation and readable block is a single
+    // span regardless of the wrap point.
+    static constexpr bool k_Contiguous  = has_policy_v<MirroredPolicy, Args...>;
+
+    // Counters kept with TelemetryPolicy (see buffer_telemetry.hpp);
+    // all zero without it.
+    [[nodiscard]] decltype(auto) telemetry() noexcept
+    {
+        return (telemetry_);
+    }
+
+protected:
+    static constexpr bool k_Mirrored    = k_Contiguous;
+
+    static_assert(!k_Mirrored || !AllocationPolicies<Args...>::k_Mapped, "allocation policies do not apply to mirrored storage");
+
+    using StorageType           = std::conditional_t<k_Mirrored, MirroredStorage<Type>, buffer_storage_t<Type, Args...>>;
+    using Indices               = std::conditional_t<k_Mirrored, SpscMirroredIndices<SizeType>, SpscIndices<SizeType>>;
+    using Waiter                = wait_strategy_t<Args...>;
+    using Telemetry             = buffer_telemetry_t<Args...>;
+
+private:
+    StorageType         buffer_;
+    Indices             indices_;
+    Waiter              readable_waiter_;
+    Waiter              writable_waiter_;
+
+    [[no_unique_address]] Telemetry telemetry_;
+};
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::buffer(SizeType size_requested) noexcept
+{
+    auto [begin, capacity]      = indices_.reserve(size_requested);
+
+    telemetry_.reserved(begin, size_requested, capacity);
+
+    return Handle(this, begin, capacity);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::move(const Type* const move_buffer, const SizeType move_size) noexcept
+{
+    SizeType size = 0;
+
+    do
+    {
+        SizeType    remaining_size  = move_size - size;
+        auto [buffer_begin, buffer_size] = indices_.reserve(remaining_size);
+
+        telemetry_.reserved(buffer_begin, remaining_size, buffer_size);
+
+        if (buffer_size == 0 && remaining_size > 0)
+        {
+            wait_writable();
+            continue;
+        }
+
+        Type*       buffer          = data() + buffer_begin;
+
+        if (buffer_size < remaining_size)
+            remaining_size  = buffer_size;
+
+        for (SizeType i = 0; i < remaining_size; ++i)
+            buffer[i]   = std::move(move_buffer[size++]);
+
+        indices_.commit(remaining_size);
+        telemetry_.committed(remaining_size);
+        readable_waiter_.notify();
+
+    } while(size < move_size);
+
+    return;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::commit(Handle& handle) noexcept
+{
+    SizeType commit_size    = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_;
+
+    indices_.commit(commit_size);
+    telemetry_.committed(commit_size);
+    readable_waiter_.notify();
+
+    handle.begin_           += commit_size;
+    handle.capacity_        = 0;
+    handle.size_            = 0;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::read(Type* destination_buffer, const SizeType read_size) noexcept
+{
+    auto [begin, capacity]  = indices_.readable(read_size);
+    Type* buffer            = data() + begin;
+
+    for (SizeType index = 0; index < capacity; ++index)
+        destination_buffer[index]   = std::move(buffer[index]);
+
+    indices_.release(capacity);
+    telemetry_.released(capacity);
+    writable_waiter_.notify();
+
+    return capacity;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, CheckDelimiter check_delimiter) noexcept
+{
+    return read<CheckDelimiter&>(destination_buffer, destination_buffer_size, delimiter, delimiter_size, check_delimiter);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+template<typename Predicate>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, Predicate check_delimiter) noexcept
+{
+    bool        delimiter_found     = false;
+    SizeType    data_size           = 0;
+
+    do
+    {
+        auto [movable_offset, movable_size] = indices_.readable(std::numeric_limits<SizeType>::max());
+
+        if (movable_size == 0 && data_size < destination_buffer_size)
+        {
+            wait_readable();
+            continue;
+        }
+
+        Type* movable_buffer    = data() + movable_offset;
+        SizeType index          = 0;
+
+        std::tie(index, delimiter_found) = scan_delimited(movable_buffer, movable_size, destination_buffer, data_size, destination_buffer_size, delimiter, delimiter_size, check_delimiter);
+
+        indices_.release(index);
+        telemetry_.released(index);
+        writable_waiter_.notify();
+
+    } while(!delimiter_found && data_size < destination_buffer_size);
+
+    return ReadSizeStatus(data_size, delimiter_found);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::read_block(SizeType size_requested) noexcept
+{
+    auto [begin, size]      = indices_.readable(size_requested);
+
+    telemetry_.readable(size);
+
+    return Handle(this, begin, size, true);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::read_fixed_size(Type* destination_buffer, const int64_t read_size) noexcept
+{
+    SizeType    data_size   = 0;
+
+    do
+    {
+        auto [offset, capacity] = indices_.readable(std::numeric_limits<SizeType>::max());
+
+        if (capacity == 0 && static_cast<int64_t>(data_size) < read_size)
+        {
+            wait_readable();
+            continue;
+        }
+
+        SizeType    index   = 0;
+        Type*       buffer  = data() + offset;
+
+        while (index < capacity && static_cast<int64_t>(data_size) < read_size)
+        {
+            destination_buffer[data_size++] = std::move(buffer[index++]);
+        }
+
+        indices_.release(index);
+        telemetry_.released(index);
+        writable_waiter_.notify();
+
+    } while(static_cast<int64_t>(data_size) < read_size);
+
+    return;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::release(Handle& handle) noexcept
+{
+    SizeType release_size   = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_;
+
+    indices_.release(release_size);
+    telemetry_.released(release_size);
+    writable_waiter_.notify();
+
+    handle.capacity_        = 0;
+    handle.size_            = 0;
+
+    return;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::reserve_vectored(SizeType size_requested) noexcept
+{
+    static_assert(std::is_trivially_copyable_v<Type>, "vectored I/O moves raw bytes");
+
+    auto [first_begin, first_size, second_begin, second_size] = indices_.reserve_vectored(size_requested);
+
+    telemetry_.reserved(first_begin, size_requested, static_cast<SizeType>(first_size + second_size));
+
+    return VectoredHandle(this,
+                iovec{data() + first_begin, first_size * sizeof(Type)},
+                iovec{data() + second_begin, second_size * sizeof(Type)},
+                first_size + second_size);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::commit(VectoredHandle& handle) noexcept
+{
+    SizeType commit_size    = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_;
+
+    indices_.commit(commit_size);
+    telemetry_.committed(commit_size);
+    readable_waiter_.notify();
+
+    handle.capacity_        = 0;
+    handle.size_            = 0;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::read_vectored(SizeType size_requested) noexcept
+{
+    static_assert(std::is_trivially_copyable_v<Type>, "vectored I/O moves raw bytes");
+
+    auto [first_begin, first_size, second_begin, second_size] = indices_.readable_vectored(size_requested);
+
+    telemetry_.readable(first_size + second_size);
+
+    return VectoredHandle(this,
+                iovec{data() + first_begin, first_size * sizeof(Type)},
+                iovec{data() + second_begin, second_size * sizeof(Type)},
+                first_size + second_size, true);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::release(VectoredHandle& handle) noexcept
+{
+    SizeType release_size   = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_;
+
+    indices_.release(release_size);
+    telemetry_.released(release_size);
+    writable_waiter_.notify();
+
+    handle.capacity_        = 0;
+    handle.size_            = 0;
+}
+
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::wait_readable() noexcept
+{
+    readable_waiter_.await([this]() noexcept { return indices_.can_read(); });
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>::wait_writable() noexcept
+{
+    writable_waiter_.await([this]() noexcept { return indices_.can_write(); });
+}
+
+
+// Bounded multi-producer/multi-consumer specialization, for
+// fanning several feeds into one ring. Any thread may hold a
+// Handle from buffer() while others reserve and commit theirs,
+// and likewise for read_block(); see MpmcIndices.
+//
+// Differences from the single-threaded interface:
+//  - t_Size must be a power of two;
+//  - a block never crosses the end of the buffer, so it may be
+//    shorter than requested even when more room is free;
+//  - move() of more than one block's worth may interleave with
+//    other producers between blocks; while the ring is full it
+//    spins, with a cpu_relax() between attempts, rather than
+//    waiting on a WaitStrategy;
+//  - release() returns a read block in full; elements beyond the
+//    handle's size are dropped;
+//  - there is no delimiter or fixed-size read, as a message
+//    could be split across consumers.
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+class RingBuffer<Type, SizeType, t_Size, MpmcPolicy, Args...>
+{
+public:
+    static_assert(t_Size > 0 && (t_Size & (t_Size - 1)) == 0, "MPMC ring size must be a power of two");
+    static_assert(!has_policy_v<SpscPolicy, Args...>, "SpscPolicy and MpmcPolicy are exclusive");
+
+    using value_type    = Type;
+    using size_type     = SizeType;
+    struct Handle
+    {
+    public:
+        explicit Handle(RingBuffer* parent, SizeType begin, SizeType capacity, bool reader = false) noexcept
+            : parent_(parent)
+            , reader_(reader)
+            , begin_(begin)
+            , capacity_(capacity)
+            , size_(0)
+        {}
+
+        Handle()    = delete;
+
+        Handle(Handle&& handle) noexcept
+            : parent_(std::move(handle.parent_))
+            , reader_(std::move(handle.reader_))
+            , begin_(std::move(handle.begin_))
+            , capacity_(std::move(handle.capacity_))
+            , size_(std::move(handle.size_))
+        {
+            handle.size_        = 0;
+            handle.capacity_    = 0;
+        }
+
+        Handle& operator=(Handle&& handle) noexcept
+        {
+            if (this == &handle)
+                return *this;
+
+            // The claimed slot being overwritten is handed back
+            // first, as in the destructor.
+            if (capacity_ > 0)
+            {
+                if (reader_)
+                    parent_->release(*this);
+                else
+                    parent_->commit(*this);
+            }
+
+            parent_             = std::move(handle.parent_);
+            reader_             = std::move(handle.reader_);
+            begin_              = std::move(handle.begin_);
+            capacity_           = std::move(handle.capacity_);
+            size_               = std::move(handle.size_);
+
+            handle.size_        = 0;
+            handle.capacity_    = 0;
+
+            return *this;
+        }
+
+        [[nodiscard]] decltype(auto) data() noexcept
+        {
+            return parent_->data() + begin_;
+        }
+
+        [[nodiscard]] decltype(auto) capacity() noexcept
+        {
+            return capacity_;
+        }
+
+        void size(SizeType s) noexcept
+        {
+            size_   = s;
+        }
+
+        // Every claimed slot must be handed back, or the ring
+        // stalls at it; hence commit/release on destruction even
+        // when nothing was written or read.
+        ~Handle() noexcept
+        {
+            if (capacity_ > 0)
+            {
+                if (reader_)
+                    parent_->release(*this);
+                else
+                    parent_->commit(*this);
+            }
+        }
+
+    private:
+        RingBuffer*     parent_;
+        bool            reader_;
+
+    public:
+        SizeType        begin_;
+        SizeType        capacity_;
+        SizeType        size_;
+    };
+
+    RingBuffer()
+        : buffer_(t_Size, Type())
+        , indices_(t_Size)
+    {}
+
+    ~RingBuffer() noexcept
+    {
+        buffer_.clear();
+    }
+
+    RingBuffer(const RingBuffer&)             = delete;
+    RingBuffer& operator=(const RingBuffer&)  = delete;
+
+    [[nodiscard]] decltype(auto) buffer(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+    [[nodiscard]] decltype(auto) read(Type* destination_buffer, const SizeType read_size = 1) noexcept;
+    [[nodiscard]] decltype(auto) read_block(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+
+    decltype(auto) move(const Type* const move_buffer, const SizeType move_size) noexcept;
+    decltype(auto) commit(Handle& handle) noexcept;
+
+    decltype(auto) release(Handle& handle) noexcept;
+
+    [[nodiscard]] decltype(auto) data() noexcept
+    {
+        return buffer_.data();
+    }
+
+    // Counters kept with TelemetryPolicy (see buffer_telemetry.hpp);
+    // all zero without it.
+    [[nodiscard]] decltype(auto) telemetry() noexcept
+    {
+        return (telemetry_);
+    }
+
+protected:
+    using StorageType           = buffer_storage_t<Type, Args...>;
+    using Indices               = MpmcIndices<SizeType>;
+    using Telemetry             = buffer_telemetry_t<MpmcPolicy, Args...>;
+
+private:
+    StorageType         buffer_;
+    Indices             indices_;
+
+    [[no_unique_address]] Telemetry telemetry_;
+};
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, MpmcPolicy, Args...>::buffer(SizeType size_requested) noexcept
+{
+    auto [begin, capacity]      = indices_.reserve(size_requested);
+
+    telemetry_.reserved(begin, size_requested, capacity);
+
+    return Handle(this, begin, capacity);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, MpmcPolicy, Args...>::move(const Type* const move_buffer, const SizeType move_size) noexcept
+{
+    SizeType size = 0;
+
+    do
+    {
+        SizeType    remaining_size  = move_size - size;
+        auto [buffer_begin, buffer_size] = indices_.reserve(remaining_size);
+
+        telemetry_.reserved(buffer_begin, remaining_size, buffer_size);
+
+        if (buffer_size == 0)
+        {
+            // Full; spin until a consumer releases a block.
+            cpu_relax();
+            continue;
+        }
+
+        Type*       buffer          = data() + buffer_begin;
+
+        for (SizeType i = 0; i < buffer_size; ++i)
+            buffer[i]   = std::move(move_buffer[size++]);
+
+        indices_.commit(buffer_begin, buffer_size, buffer_size);
+        telemetry_.committed(buffer_size);
+
+    } while(size < move_size);
+
+    return;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, MpmcPolicy, Args...>::commit(Handle& handle) noexcept
+{
+    SizeType commit_size    = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_;
+
+    indices_.commit(handle.begin_, handle.capacity_, commit_size);
+    telemetry_.committed(commit_size);
+
+    handle.begin_           += commit_size;
+    handle.capacity_        = 0;
+    handle.size_            = 0;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, MpmcPolicy, Args...>::read(Type* destination_buffer, const SizeType read_size) noexcept
+{
+    auto [begin, capacity]  = indices_.readable(read_size);
+    Type* buffer            = data() + begin;
+
+    for (SizeType index = 0; index < capacity; ++index)
+        destination_buffer[index]   = std::move(buffer[index]);
+
+    indices_.release(begin, capacity);
+    telemetry_.released(capacity);
+
+    return capacity;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, MpmcPolicy, Args...>::read_block(SizeType size_requested) noexcept
+{
+    auto [begin, size]      = indices_.readable(size_requested);
+
+    telemetry_.readable(size);
+
+    return Handle(this, begin, size, true);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+inline
+decltype(auto) RingBuffer<Type, SizeType, t_Size, MpmcPolicy, Args...>::release(Handle& handle) noexcept
+{
+    indices_.release(handle.begin_, handle.capacity_);
+    telemetry_.released(handle.capacity_);
+
+    handle.capacity_        = 0;
+    handle.size_            = 0;
+
+    return;
+}
+
+// Only a mirrored ring hands out all of its free room at once.
+template<typename Type, typename SizeType, SizeType t_Size, typename... Args>
+struct BufferTraits<RingBuffer<Type, SizeType, t_Size, SpscPolicy, Args...>>
+{
+    static constexpr bool   k_Larger_Region = has_policy_v<MirroredPolicy, Args...>;
+};
+
 }
 
 #endif // _RING__BUFFER_HPP__
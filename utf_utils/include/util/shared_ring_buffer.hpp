@@ -0,0 +1,560 @@
+#ifndef _SHARED_RING_BUFFER_HPP__
+#define _SHARED_RING_BUFFER_HPP__
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <system_error>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include "util/buffer_policies.hpp"
+#include "util/spsc_indices.hpp"
+#include "util/vectored_handle.hpp"
+
+namespace util
+{
+
+// Single-producer/single-consumer ring shared between two
+// processes. The header, the SpscIndices and the elements all
+// live in one memfd or POSIX shared memory segment:
+//
+//      | Header | SpscIndices<SizeType> | Type[t_Size] |
+//
+// at fixed offsets from its start, and the indices are element
+// offsets, so every process may map the segment wherever it
+// likes. The atomics are lock-free and therefore address-free,
+// which is all that process-shared use requires.
+//
+// Each side claims its role first. A role held by a process
+// that no longer exists can be claimed over; data committed by
+// a dead producer stays readable, its open reservation is
+// dropped, and a block a dead consumer had not yet released is
+// delivered again to the next one.
+//
+// Layout::Transit offers reservations from whichever side of
+// the buffer has more room, as TransitBuffer does; Layout::Ring
+// fills the back first, as RingBuffer does.
+template<typename Type, typename SizeType, SizeType t_Size>
+class SharedRingBuffer
+{
+public:
+    static_assert(std::is_trivially_copyable_v<Type>, "a shared segment holds raw bytes");
+    static_assert(std::atomic<SizeType>::is_always_lock_free, "shared indices must be lock-free");
+
+    using value_type    = Type;
+    using size_type     = SizeType;
+
+    enum class Layout : std::uint8_t
+    {
+        Ring        = 0,
+        Transit
+    };
+
+    enum class Role : std::uint8_t
+    {
+        Producer    = 0,
+        Consumer
+    };
+
+    struct Handle
+    {
+    public:
+        explicit Handle(SharedRingBuffer* parent, SizeType begin, SizeType capacity, bool reader = false) noexcept
+            : parent_(parent)
+            , reader_(reader)
+            , begin_(begin)
+            , capacity_(capacity)
+            , size_(0)
+        {}
+
+        Handle()    = delete;
+
+        Handle(Handle&& handle) noexcept
+            : parent_(std::move(handle.parent_))
+            , reader_(std::move(handle.reader_))
+            , begin_(std::move(handle.begin_))
+            , capacity_(std::move(handle.capacity_))
+            , size_(std::move(handle.size_))
+        {
+            handle.size_        = 0;
+            handle.capacity_    = 0;
+        }
+
+        Handle& operator=(Handle&& handle) noexcept
+        {
+            parent_             = std::move(handle.parent_);
+            reader_             = std::move(handle.reader_);
+            begin_              = std::move(handle.begin_);
+            capacity_           = std::move(handle.capacity_);
+            size_               = std::move(handle.size_);
+
+            handle.size_        = 0;
+            handle.capacity_    = 0;
+
+            return *this;
+        }
+
+        [[nodiscard]] decltype(auto) data() noexcept
+        {
+            return parent_->data() + begin_;
+        }
+
+        [[nodiscard]] decltype(auto) capacity() noexcept
+        {
+            return capacity_;
+        }
+
+        void size(SizeType s) noexcept
+        {
+            size_   = s;
+        }
+
+        ~Handle() noexcept
+        {
+            if (capacity_ > 0)
+            {
+                if (reader_)
+                    parent_->release(*this);
+                else
+                    parent_->commit(*this);
+            }
+        }
+
+    private:
+        SharedRingBuffer*   parent_;
+        bool                reader_;
+
+    public:
+        SizeType            begin_;
+        SizeType            capacity_;
+        SizeType            size_;
+    };
+
+    using VectoredHandle    = util::VectoredHandle<SharedRingBuffer, SizeType>;
+
+    // A new anonymous (memfd) segment; the peer maps it from fd(),
+    // inherited across fork() or passed with SCM_RIGHTS.
+    explicit SharedRingBuffer(Layout layout = Layout::Ring);
+
+    // Maps a segment created by another process.
+    explicit SharedRingBuffer(int fd);
+
+    // A new named segment (shm_open); see unlink().
+    SharedRingBuffer(const char* name, Layout layout);
+
+    // Maps an existing named segment.
+    explicit SharedRingBuffer(const char* name);
+
+    SharedRingBuffer(const SharedRingBuffer&)             = delete;
+    SharedRingBuffer& operator=(const SharedRingBuffer&)  = delete;
+
+    // Leaves any role still held, then unmaps the segment.
+    ~SharedRingBuffer() noexcept;
+
+    static decltype(auto) unlink(const char* name) noexcept
+    {
+#if defined(__linux__)
+        ::shm_unlink(name);
+#else
+        (void) name;
+#endif
+    }
+
+    [[nodiscard]] decltype(auto) fd() const noexcept
+    {
+        return fd_;
+    }
+
+    // Takes the role for this process. Fails while another live
+    // process holds it; takes over from a process that has died.
+    [[nodiscard]] bool claim(Role role) noexcept;
+    decltype(auto) leave(Role role) noexcept;
+
+    // Whether a live process currently holds the role.
+    [[nodiscard]] bool alive(Role role) const noexcept;
+
+    // producer side
+    [[nodiscard]] decltype(auto) buffer(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+    decltype(auto) commit(Handle& handle) noexcept;
+    [[nodiscard]] decltype(auto) reserve_vectored(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+    decltype(auto) commit(VectoredHandle& handle) noexcept;
+
+    // consumer side
+    [[nodiscard]] decltype(auto) read_block(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+    decltype(auto) release(Handle& handle) noexcept;
+    [[nodiscard]] decltype(auto) read_vectored(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+    decltype(auto) release(VectoredHandle& handle) noexcept;
+
+    [[nodiscard]] decltype(auto) data() noexcept
+    {
+        return data_;
+    }
+
+protected:
+    using Indices   = SpscIndices<SizeType>;
+
+    static constexpr std::uint64_t  k_Magic     = 0x676e6972646873ull;     // "shdring"
+    static constexpr std::uint32_t  k_Version   = 1;
+
+    struct Header
+    {
+        std::atomic<std::uint64_t>  magic_{0};
+        std::uint32_t               version_{0};
+        std::uint32_t               element_size_{0};
+        std::uint64_t               capacity_{0};
+        std::atomic<pid_t>          owners_[2] {};
+    };
+
+    static_assert(std::atomic<pid_t>::is_always_lock_free, "shared role owners must be lock-free");
+
+    static constexpr std::size_t round_up(std::size_t bytes, std::size_t unit) noexcept
+    {
+        return ((bytes + unit - 1) / unit) * unit;
+    }
+
+    static constexpr std::size_t    k_Indices_Offset    = round_up(sizeof(Header), k_Cache_Line_Size);
+    static constexpr std::size_t    k_Data_Offset       = round_up(k_Indices_Offset + sizeof(Indices), k_Cache_Line_Size);
+    static constexpr std::size_t    k_Segment_Size      = k_Data_Offset + static_cast<std::size_t>(t_Size) * sizeof(Type);
+
+    static_assert(alignof(Type) <= k_Cache_Line_Size, "elements must fit the segment alignment");
+
+    static decltype(auto) role_index(Role role) noexcept
+    {
+        return static_cast<std::size_t>(role);
+    }
+
+    void create(Layout layout);
+    void attach();
+    void map();
+    [[noreturn]] void fail(int error, const char* what);
+
+private:
+    int             fd_         = -1;
+    char*           base_       = nullptr;
+    Header*         header_     = nullptr;
+    Indices*        indices_    = nullptr;
+    Type*           data_       = nullptr;
+    bool            held_[2]    = {false, false};
+};
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+SharedRingBuffer<Type, SizeType, t_Size>::SharedRingBuffer(Layout layout)
+{
+#if defined(__linux__)
+    fd_ = ::memfd_create("util_shared_ring", MFD_CLOEXEC);
+    if (fd_ < 0)
+        throw std::system_error(errno, std::generic_category(), "memfd_create");
+
+    create(layout);
+#else
+    (void) layout;
+    throw std::system_error(ENOSYS, std::generic_category(), "SharedRingBuffer");
+#endif
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+SharedRingBuffer<Type, SizeType, t_Size>::SharedRingBuffer(int fd)
+{
+#if defined(__linux__)
+    fd_ = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (fd_ < 0)
+        throw std::system_error(errno, std::generic_category(), "fcntl");
+
+    attach();
+#else
+    (void) fd;
+    throw std::system_error(ENOSYS, std::generic_category(), "SharedRingBuffer");
+#endif
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+SharedRingBuffer<Type, SizeType, t_Size>::SharedRingBuffer(const char* name, Layout layout)
+{
+#if defined(__linux__)
+    fd_ = ::shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd_ < 0)
+        throw std::system_error(errno, std::generic_category(), "shm_open");
+
+    create(layout);
+#else
+    (void) name;
+    (void) layout;
+    throw std::system_error(ENOSYS, std::generic_category(), "SharedRingBuffer");
+#endif
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+SharedRingBuffer<Type, SizeType, t_Size>::SharedRingBuffer(const char* name)
+{
+#if defined(__linux__)
+    fd_ = ::shm_open(name, O_RDWR | O_CLOEXEC, 0);
+    if (fd_ < 0)
+        throw std::system_error(errno, std::generic_category(), "shm_open");
+
+    attach();
+#else
+    (void) name;
+    throw std::system_error(ENOSYS, std::generic_category(), "SharedRingBuffer");
+#endif
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+SharedRingBuffer<Type, SizeType, t_Size>::~SharedRingBuffer() noexcept
+{
+    leave(Role::Producer);
+    leave(Role::Consumer);
+
+#if defined(__linux__)
+    if (base_ != nullptr)
+        ::munmap(base_, k_Segment_Size);
+    if (fd_ >= 0)
+        ::close(fd_);
+#endif
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+void SharedRingBuffer<Type, SizeType, t_Size>::create(Layout layout)
+{
+#if defined(__linux__)
+    if (::ftruncate(fd_, static_cast<off_t>(k_Segment_Size)) != 0)
+        fail(errno, "ftruncate");
+
+    map();
+
+    header_ = ::new (base_) Header();
+    indices_ = ::new (base_ + k_Indices_Offset) Indices(t_Size, layout == Layout::Transit);
+
+    header_->version_       = k_Version;
+    header_->element_size_  = sizeof(Type);
+    header_->capacity_      = t_Size;
+
+    // Last, so that a process attaching by name never sees a
+    // half-built segment as valid.
+    header_->magic_.store(k_Magic, std::memory_order_release);
+#else
+    (void) layout;
+#endif
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+void SharedRingBuffer<Type, SizeType, t_Size>::attach()
+{
+#if defined(__linux__)
+    struct stat status;
+
+    if (::fstat(fd_, &status) != 0)
+        fail(errno, "fstat");
+
+    if (static_cast<std::size_t>(status.st_size) < k_Segment_Size)
+        fail(EINVAL, "SharedRingBuffer: segment too small");
+
+    map();
+
+    header_     = std::launder(reinterpret_cast<Header*>(base_));
+    indices_    = std::launder(reinterpret_cast<Indices*>(base_ + k_Indices_Offset));
+
+    if (header_->magic_.load(std::memory_order_acquire) != k_Magic
+        || header_->version_ != k_Version
+        || header_->element_size_ != sizeof(Type)
+        || header_->capacity_ != t_Size)
+        fail(EINVAL, "SharedRingBuffer: segment layout mismatch");
+#endif
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+void SharedRingBuffer<Type, SizeType, t_Size>::map()
+{
+#if defined(__linux__)
+    void* base = ::mmap(nullptr, k_Segment_Size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED)
+        fail(errno, "mmap");
+
+    base_   = static_cast<char*>(base);
+    data_   = reinterpret_cast<Type*>(base_ + k_Data_Offset);
+#endif
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+void SharedRingBuffer<Type, SizeType, t_Size>::fail(int error, const char* what)
+{
+#if defined(__linux__)
+    if (base_ != nullptr)
+        ::munmap(base_, k_Segment_Size);
+    if (fd_ >= 0)
+        ::close(fd_);
+#endif
+    base_   = nullptr;
+    fd_     = -1;
+
+    throw std::system_error(error, std::generic_category(), what);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+bool SharedRingBuffer<Type, SizeType, t_Size>::claim(Role role) noexcept
+{
+#if defined(__linux__)
+    std::atomic<pid_t>& owner   = header_->owners_[role_index(role)];
+    pid_t               self    = ::getpid();
+    pid_t               current = owner.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        if (current == self)
+            break;
+
+        // kill(pid, 0) only probes; EPERM still means it exists.
+        if (current != 0 && (::kill(current, 0) == 0 || errno != ESRCH))
+            return false;
+
+        if (owner.compare_exchange_weak(current, self, std::memory_order_acq_rel))
+        {
+            if (current != 0 && role == Role::Producer)
+                indices_->abandon();
+            break;
+        }
+    }
+
+    held_[role_index(role)] = true;
+    return true;
+#else
+    (void) role;
+    return false;
+#endif
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+decltype(auto) SharedRingBuffer<Type, SizeType, t_Size>::leave(Role role) noexcept
+{
+    if (!held_[role_index(role)] || header_ == nullptr)
+        return;
+
+#if defined(__linux__)
+    pid_t self = ::getpid();
+    header_->owners_[role_index(role)].compare_exchange_strong(self, 0, std::memory_order_acq_rel);
+#endif
+    held_[role_index(role)] = false;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+bool SharedRingBuffer<Type, SizeType, t_Size>::alive(Role role) const noexcept
+{
+#if defined(__linux__)
+    pid_t owner = header_->owners_[role_index(role)].load(std::memory_order_acquire);
+
+    return owner != 0 && (::kill(owner, 0) == 0 || errno != ESRCH);
+#else
+    (void) role;
+    return false;
+#endif
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+decltype(auto) SharedRingBuffer<Type, SizeType, t_Size>::buffer(SizeType size_requested) noexcept
+{
+    auto [begin, capacity]      = indices_->reserve(size_requested);
+
+    return Handle(this, begin, capacity);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+decltype(auto) SharedRingBuffer<Type, SizeType, t_Size>::commit(Handle& handle) noexcept
+{
+    indices_->commit(handle.size_);
+
+    handle.begin_           += (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_;
+    handle.capacity_        = 0;
+    handle.size_            = 0;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+decltype(auto) SharedRingBuffer<Type, SizeType, t_Size>::reserve_vectored(SizeType size_requested) noexcept
+{
+    auto [first_begin, first_size, second_begin, second_size] = indices_->reserve_vectored(size_requested);
+
+    return VectoredHandle(this,
+                iovec{data() + first_begin, first_size * sizeof(Type)},
+                iovec{data() + second_begin, second_size * sizeof(Type)},
+                first_size + second_size);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+decltype(auto) SharedRingBuffer<Type, SizeType, t_Size>::commit(VectoredHandle& handle) noexcept
+{
+    indices_->commit((handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_);
+
+    handle.capacity_        = 0;
+    handle.size_            = 0;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+decltype(auto) SharedRingBuffer<Type, SizeType, t_Size>::read_block(SizeType size_requested) noexcept
+{
+    auto [begin, size]      = indices_->readable(size_requested);
+
+    return Handle(this, begin, size, true);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+decltype(auto) SharedRingBuffer<Type, SizeType, t_Size>::release(Handle& handle) noexcept
+{
+    indices_->release((handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_);
+
+    handle.capacity_        = 0;
+    handle.size_            = 0;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+decltype(auto) SharedRingBuffer<Type, SizeType, t_Size>::read_vectored(SizeType size_requested) noexcept
+{
+    auto [first_begin, first_size, second_begin, second_size] = indices_->readable_vectored(size_requested);
+
+    return VectoredHandle(this,
+                iovec{data() + first_begin, first_size * sizeof(Type)},
+                iovec{data() + second_begin, second_size * sizeof(Type)},
+                first_size + second_size, true);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size>
+inline
+decltype(auto) SharedRingBuffer<Type, SizeType, t_Size>::release(VectoredHandle& handle) noexcept
+{
+    indices_->release((handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_);
+
+    handle.capacity_        = 0;
+    handle.size_            = 0;
+}
+
+}
+
+#endif // _SHARED_RING_BUFFER_HPP__
@@ -0,0 +1,511 @@
+#ifndef _SPSC_INDICES_HPP__
+#define _SPSC_INDICES_HPP__
+
+#include <atomic>
+#include <tuple>
+
+#include "util/buffer_policies.hpp"
+
+namespace util
+{
+
+// Index bookkeeping for a single-producer/single-consumer
+// bip buffer. The producer owns write_ and watermark_, the
+// consumer owns read_; each side keeps a cached copy of the
+// other's index and only reloads it when the cached value
+// does not satisfy the request.
+//
+// Data is always contiguous: when the producer wraps to the
+// front, it records where the data at the back ends in
+// watermark_, and the consumer wraps when it reaches it.
+// One slot is kept free so that read_ == write_ always
+// means empty.
+template<typename SizeType>
+class SpscIndices
+{
+public:
+    using Block     = std::tuple<SizeType, SizeType>;
+    // begin and size of the spans before and after the wrap point
+    using Segments  = std::tuple<SizeType, SizeType, SizeType, SizeType>;
+
+    explicit SpscIndices(SizeType capacity, bool prefer_larger) noexcept
+        : capacity_(capacity)
+        , prefer_larger_(prefer_larger)
+        , producer_()
+        , consumer_()
+    {}
+
+    SpscIndices(const SpscIndices&)             = delete;
+    SpscIndices& operator=(const SpscIndices&)  = delete;
+
+    // producer side
+    [[nodiscard]] decltype(auto) reserve(SizeType size_requested) noexcept;
+    [[nodiscard]] decltype(auto) reserve_vectored(SizeType size_requested) noexcept;
+    decltype(auto) commit(SizeType size_committed) noexcept;
+
+    // consumer side
+    [[nodiscard]] decltype(auto) readable(SizeType size_requested) noexcept;
+    [[nodiscard]] decltype(auto) readable_vectored(SizeType size_requested) noexcept;
+    decltype(auto) release(SizeType size_released) noexcept;
+
+    // Probes for blocking waits: whether reserve() would return
+    // any space (producer side) or readable() any data (consumer
+    // side). They refresh the cached index of the other side.
+    [[nodiscard]] decltype(auto) can_write() noexcept;
+    [[nodiscard]] decltype(auto) can_read() noexcept;
+
+    // Drops a reservation that will never be committed, e.g. one
+    // left behind by a producer that died; producer side.
+    decltype(auto) abandon() noexcept
+    {
+        producer_.reserved_size_    = 0;
+    }
+
+    // only while neither side is active
+    decltype(auto) reset() noexcept;
+
+protected:
+    [[nodiscard]] decltype(auto) writable(SizeType write, SizeType read) const noexcept;
+    [[nodiscard]] decltype(auto) writable_segments(SizeType write, SizeType read) const noexcept;
+
+private:
+    struct alignas(k_Cache_Line_Size) Producer
+    {
+        std::atomic<SizeType>   write_{0};
+        std::atomic<SizeType>   watermark_{0};
+        SizeType                read_cache_{0};
+        SizeType                reserved_begin_{0};
+        SizeType                reserved_size_{0};
+        SizeType                reserved_split_{0};
+    };
+
+    struct alignas(k_Cache_Line_Size) Consumer
+    {
+        std::atomic<SizeType>   read_{0};
+        SizeType                write_cache_{0};
+        SizeType                watermark_cache_{0};
+        SizeType                claimed_split_{0};
+    };
+
+    const SizeType      capacity_;
+    const bool          prefer_larger_;
+    Producer            producer_;
+    Consumer            consumer_;
+};
+
+template<typename SizeType>
+inline
+decltype(auto) SpscIndices<SizeType>::writable(SizeType write, SizeType read) const noexcept
+{
+    if (write < read)
+        return Block(write, read - write - 1);
+
+    SizeType back   = capacity_ - write;
+    SizeType front  = (read > 0) ? read - 1 : 0;
+
+    // A ring buffer fills the back before wrapping; a transit
+    // buffer offers whichever side is larger.
+    if (back > 0 && !(prefer_larger_ && front > back))
+        return Block(write, back);
+
+    return Block(SizeType(0), front);
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscIndices<SizeType>::writable_segments(SizeType write, SizeType read) const noexcept
+{
+    if (write < read)
+        return Segments(write, read - write - 1, 0, 0);
+
+    SizeType back   = capacity_ - write;
+    SizeType front  = (read > 0) ? read - 1 : 0;
+
+    if (back == 0)
+        return Segments(0, front, 0, 0);
+
+    return Segments(write, back, 0, front);
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscIndices<SizeType>::reserve(SizeType size_requested) noexcept
+{
+    if (producer_.reserved_size_ != 0)
+        return Block(producer_.reserved_begin_, 0);
+
+    SizeType write              = producer_.write_.load(std::memory_order_relaxed);
+    auto [begin, available]     = writable(write, producer_.read_cache_);
+
+    if (available < size_requested)
+    {
+        producer_.read_cache_   = consumer_.read_.load(std::memory_order_acquire);
+        std::tie(begin, available) = writable(write, producer_.read_cache_);
+    }
+
+    SizeType reserve_size       = (size_requested >= available) ? available : size_requested;
+    producer_.reserved_begin_   = begin;
+    producer_.reserved_size_    = reserve_size;
+    producer_.reserved_split_   = reserve_size;
+
+    return Block(begin, reserve_size);
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscIndices<SizeType>::reserve_vectored(SizeType size_requested) noexcept
+{
+    if (producer_.reserved_size_ != 0)
+        return Segments(producer_.reserved_begin_, 0, 0, 0);
+
+    SizeType write              = producer_.write_.load(std::memory_order_relaxed);
+    auto segments               = writable_segments(write, producer_.read_cache_);
+
+    if (std::get<1>(segments) + std::get<3>(segments) < size_requested)
+    {
+        producer_.read_cache_   = consumer_.read_.load(std::memory_order_acquire);
+        segments                = writable_segments(write, producer_.read_cache_);
+    }
+
+    auto [begin, first, second_begin, second] = segments;
+
+    if (first > size_requested)
+        first                   = size_requested;
+    if (second > size_requested - first)
+        second                  = size_requested - first;
+
+    producer_.reserved_begin_   = begin;
+    producer_.reserved_size_    = first + second;
+    producer_.reserved_split_   = first;
+
+    return Segments(begin, first, second_begin, second);
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscIndices<SizeType>::commit(SizeType size_committed) noexcept
+{
+    SizeType commit_size        = (size_committed < producer_.reserved_size_) ? size_committed : producer_.reserved_size_;
+    SizeType write              = producer_.write_.load(std::memory_order_relaxed);
+
+    producer_.reserved_size_    = 0;
+
+    if (commit_size == 0)
+        return;
+
+    // A vectored commit that runs past the end of the buffer: the
+    // data at the back now ends at the capacity.
+    if (commit_size > producer_.reserved_split_)
+    {
+        producer_.watermark_.store(producer_.reserved_begin_ + producer_.reserved_split_, std::memory_order_relaxed);
+        producer_.write_.store(commit_size - producer_.reserved_split_, std::memory_order_release);
+        return;
+    }
+
+    if (producer_.reserved_begin_ != write)
+        producer_.watermark_.store(write, std::memory_order_relaxed);
+
+    producer_.write_.store(producer_.reserved_begin_ + commit_size, std::memory_order_release);
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscIndices<SizeType>::readable(SizeType size_requested) noexcept
+{
+    SizeType read               = consumer_.read_.load(std::memory_order_relaxed);
+    SizeType write              = consumer_.write_cache_;
+
+    if (read == write)
+    {
+        write                   = producer_.write_.load(std::memory_order_acquire);
+        consumer_.write_cache_  = write;
+
+        if (write < read)
+            consumer_.watermark_cache_  = producer_.watermark_.load(std::memory_order_relaxed);
+    }
+
+    if (write < read && read == consumer_.watermark_cache_)
+    {
+        read                    = 0;
+        consumer_.read_.store(read, std::memory_order_release);
+    }
+
+    SizeType end                = (read <= write) ? write : consumer_.watermark_cache_;
+    SizeType size               = end - read;
+
+    if (size > size_requested)
+        size                    = size_requested;
+
+    consumer_.claimed_split_    = size;
+
+    return Block(read, size);
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscIndices<SizeType>::readable_vectored(SizeType size_requested) noexcept
+{
+    SizeType read               = consumer_.read_.load(std::memory_order_relaxed);
+    SizeType write              = consumer_.write_cache_;
+    SizeType available          = (read <= write) ? write - read : (consumer_.watermark_cache_ - read) + write;
+
+    if (available < size_requested)
+    {
+        write                   = producer_.write_.load(std::memory_order_acquire);
+        consumer_.write_cache_  = write;
+
+        if (write < read)
+            consumer_.watermark_cache_  = producer_.watermark_.load(std::memory_order_relaxed);
+    }
+
+    if (write < read && read == consumer_.watermark_cache_)
+    {
+        read                    = 0;
+        consumer_.read_.store(read, std::memory_order_release);
+    }
+
+    SizeType first              = (read <= write) ? write - read : consumer_.watermark_cache_ - read;
+    SizeType second             = (read <= write) ? 0 : write;
+
+    if (first > size_requested)
+        first                   = size_requested;
+    if (second > size_requested - first)
+        second                  = size_requested - first;
+
+    consumer_.claimed_split_    = first;
+
+    return Segments(read, first, 0, second);
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscIndices<SizeType>::release(SizeType size_released) noexcept
+{
+    if (size_released == 0)
+        return;
+
+    SizeType read               = consumer_.read_.load(std::memory_order_relaxed);
+
+    // Past the end of a vectored block's first span: continue from
+    // the front of the buffer.
+    if (size_released > consumer_.claimed_split_)
+    {
+        consumer_.read_.store(size_released - consumer_.claimed_split_, std::memory_order_release);
+        return;
+    }
+
+    consumer_.read_.store(read + size_released, std::memory_order_release);
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscIndices<SizeType>::can_write() noexcept
+{
+    producer_.read_cache_       = consumer_.read_.load(std::memory_order_acquire);
+
+    return std::get<1>(writable(producer_.write_.load(std::memory_order_relaxed), producer_.read_cache_)) > 0;
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscIndices<SizeType>::can_read() noexcept
+{
+    return consumer_.read_.load(std::memory_order_relaxed) != producer_.write_.load(std::memory_order_acquire);
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscIndices<SizeType>::reset() noexcept
+{
+    producer_.write_.store(0, std::memory_order_relaxed);
+    producer_.watermark_.store(0, std::memory_order_relaxed);
+    producer_.read_cache_       = 0;
+    producer_.reserved_begin_   = 0;
+    producer_.reserved_size_    = 0;
+    producer_.reserved_split_   = 0;
+    consumer_.read_.store(0, std::memory_order_relaxed);
+    consumer_.write_cache_      = 0;
+    consumer_.watermark_cache_  = 0;
+    consumer_.claimed_split_    = 0;
+}
+
+
+// Index bookkeeping for a single-producer/single-consumer
+// ring over MirroredStorage. Because the storage repeats
+// itself after capacity elements, free space and readable
+// data are each one span starting at write_ and read_
+// respectively, and no watermark is needed. Same interface
+// and threading rules as SpscIndices.
+template<typename SizeType>
+class SpscMirroredIndices
+{
+public:
+    using Block     = std::tuple<SizeType, SizeType>;
+    using Segments  = std::tuple<SizeType, SizeType, SizeType, SizeType>;
+
+    // prefer_larger is accepted for interface parity only;
+    // there is never more than one free region.
+    explicit SpscMirroredIndices(SizeType capacity, bool /* prefer_larger */ = false) noexcept
+        : capacity_(capacity)
+        , producer_()
+        , consumer_()
+    {}
+
+    SpscMirroredIndices(const SpscMirroredIndices&)             = delete;
+    SpscMirroredIndices& operator=(const SpscMirroredIndices&)  = delete;
+
+    // producer side
+    [[nodiscard]] decltype(auto) reserve(SizeType size_requested) noexcept;
+    decltype(auto) commit(SizeType size_committed) noexcept;
+
+    // consumer side
+    [[nodiscard]] decltype(auto) readable(SizeType size_requested) noexcept;
+    decltype(auto) release(SizeType size_released) noexcept;
+
+    // The mirror makes the second span redundant; it is always empty.
+    [[nodiscard]] decltype(auto) reserve_vectored(SizeType size_requested) noexcept
+    {
+        auto [begin, size]  = reserve(size_requested);
+        return Segments(begin, size, 0, 0);
+    }
+
+    [[nodiscard]] decltype(auto) readable_vectored(SizeType size_requested) noexcept
+    {
+        auto [begin, size]  = readable(size_requested);
+        return Segments(begin, size, 0, 0);
+    }
+
+    // Probes for blocking waits: whether reserve() would return
+    // any space (producer side) or readable() any data (consumer
+    // side). They refresh the cached index of the other side.
+    [[nodiscard]] decltype(auto) can_write() noexcept;
+    [[nodiscard]] decltype(auto) can_read() noexcept;
+
+    // only while neither side is active
+    decltype(auto) reset() noexcept;
+
+protected:
+    [[nodiscard]] SizeType advance(SizeType index, SizeType by) const noexcept
+    {
+        return (index >= capacity_ - by) ? index - (capacity_ - by) : index + by;
+    }
+
+    [[nodiscard]] SizeType distance(SizeType from, SizeType to) const noexcept
+    {
+        return (to >= from) ? to - from : capacity_ - (from - to);
+    }
+
+private:
+    struct alignas(k_Cache_Line_Size) Producer
+    {
+        std::atomic<SizeType>   write_{0};
+        SizeType                read_cache_{0};
+        SizeType                reserved_size_{0};
+    };
+
+    struct alignas(k_Cache_Line_Size) Consumer
+    {
+        std::atomic<SizeType>   read_{0};
+        SizeType                write_cache_{0};
+    };
+
+    const SizeType      capacity_;
+    Producer            producer_;
+    Consumer            consumer_;
+};
+
+template<typename SizeType>
+inline
+decltype(auto) SpscMirroredIndices<SizeType>::reserve(SizeType size_requested) noexcept
+{
+    SizeType write              = producer_.write_.load(std::memory_order_relaxed);
+
+    if (producer_.reserved_size_ != 0)
+        return Block(write, 0);
+
+    SizeType available          = capacity_ - 1 - distance(producer_.read_cache_, write);
+
+    if (available < size_requested)
+    {
+        producer_.read_cache_   = consumer_.read_.load(std::memory_order_acquire);
+        available               = capacity_ - 1 - distance(producer_.read_cache_, write);
+    }
+
+    SizeType reserve_size       = (size_requested >= available) ? available : size_requested;
+    producer_.reserved_size_    = reserve_size;
+
+    return Block(write, reserve_size);
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscMirroredIndices<SizeType>::commit(SizeType size_committed) noexcept
+{
+    SizeType commit_size        = (size_committed < producer_.reserved_size_) ? size_committed : producer_.reserved_size_;
+
+    producer_.reserved_size_    = 0;
+
+    if (commit_size == 0)
+        return;
+
+    SizeType write              = producer_.write_.load(std::memory_order_relaxed);
+    producer_.write_.store(advance(write, commit_size), std::memory_order_release);
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscMirroredIndices<SizeType>::readable(SizeType size_requested) noexcept
+{
+    SizeType read               = consumer_.read_.load(std::memory_order_relaxed);
+    SizeType size               = distance(read, consumer_.write_cache_);
+
+    if (size < size_requested)
+    {
+        consumer_.write_cache_  = producer_.write_.load(std::memory_order_acquire);
+        size                    = distance(read, consumer_.write_cache_);
+    }
+
+    return Block(read, (size > size_requested) ? size_requested : size);
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscMirroredIndices<SizeType>::release(SizeType size_released) noexcept
+{
+    if (size_released == 0)
+        return;
+
+    SizeType read               = consumer_.read_.load(std::memory_order_relaxed);
+    consumer_.read_.store(advance(read, size_released), std::memory_order_release);
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscMirroredIndices<SizeType>::can_write() noexcept
+{
+    producer_.read_cache_       = consumer_.read_.load(std::memory_order_acquire);
+
+    return distance(producer_.read_cache_, producer_.write_.load(std::memory_order_relaxed)) < capacity_ - 1;
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscMirroredIndices<SizeType>::can_read() noexcept
+{
+    return consumer_.read_.load(std::memory_order_relaxed) != producer_.write_.load(std::memory_order_acquire);
+}
+
+template<typename SizeType>
+inline
+decltype(auto) SpscMirroredIndices<SizeType>::reset() noexcept
+{
+    producer_.write_.store(0, std::memory_order_relaxed);
+    producer_.read_cache_       = 0;
+    producer_.reserved_size_    = 0;
+    consumer_.read_.store(0, std::memory_order_relaxed);
+    consumer_.write_cache_      = 0;
+}
+
+}
+
+#endif // _SPSC_INDICES_HPP__
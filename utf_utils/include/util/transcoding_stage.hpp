@@ -0,0 +1,277 @@
+#ifndef _TRANSCODING_STAGE_HPP__
+#define _TRANSCODING_STAGE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "util/buffer_policies.hpp"
+#include "util/unify.hpp"
+
+namespace util
+{
+
+// What a pipeline stage needs to know about a transcoder besides
+// its static transcode(output, input, size) -> (written, consumed):
+// how many output units it may touch per input unit, and how the
+// output must be aligned. UniFy widens every input unit to a
+// char32_t in the output before narrowing it again, so it needs
+// four bytes of output per input unit, char32_t aligned, unless
+// source and destination are the same type.
+template<typename Transcoder>
+struct TranscoderTraits;
+
+template<typename DestType, typename SrcType, bool BigEndianDest, bool BigEndianSrc, DestType* t_dest_ptr>
+struct TranscoderTraits<UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>>
+{
+    static constexpr bool           k_Same_Type         = std::is_same_v<DestType, SrcType>;
+    static constexpr std::size_t    k_Output_Factor     = k_Same_Type ? 1 : sizeof(char32_t) / sizeof(DestType);
+    static constexpr std::size_t    k_Output_Alignment  = k_Same_Type ? alignof(DestType) : alignof(char32_t);
+};
+
+// Moves text from one buffer to another, transcoding it on the
+// way: a read_block() Handle of the input is transcoded straight
+// into the Handle of a buffer() reservation on the output, which
+// is then committed with the number of units written, and the
+// input released with the number of units consumed. There is no
+// intermediate copy on either side.
+//
+// The reservation is for the transcoder's worst case; when the
+// output has less room the input is cut to fit. A sequence that
+// is cut off at the end of a block is left in the input when the
+// block was cut to fit, and is otherwise carried over (it may
+// continue at the front of the ring) and completed from the next
+// block. Only that splice goes through a small local buffer, and
+// it needs room for one code point.
+//
+// The output must offer the larger of its free regions, as
+// TransitBuffer and a mirrored RingBuffer do (see BufferTraits):
+// a plain RingBuffer whose back region is shorter than one
+// transcoded unit or code point would stall the stage for good.
+//
+// Reservations that are not aligned for the transcoder are
+// transcoded into scratch_ and copied; with char32_t output, or
+// UTF-8/UTF-16 output whose blocks stay aligned, this never
+// happens.
+template<typename InBuffer, typename OutBuffer, typename Transcoder>
+class TranscodingStage
+{
+public:
+    using SrcType   = typename InBuffer::value_type;
+    using DestType  = typename OutBuffer::value_type;
+    using SizeType  = typename InBuffer::size_type;
+    using Traits    = TranscoderTraits<Transcoder>;
+
+    // input units consumed and output units produced
+    using Progress  = std::tuple<SizeType, SizeType>;
+
+    // Longest sequence kept across blocks; more than any valid
+    // UTF-8 or UTF-16 sequence needs.
+    static constexpr SizeType   k_Max_Carry     = 8;
+
+    static_assert(BufferTraits<OutBuffer>::k_Larger_Region, "the output must offer the larger of its free regions");
+
+    explicit TranscodingStage(InBuffer& input, OutBuffer& output) noexcept
+        : input_(input)
+        , output_(output)
+        , carry_size_(0)
+    {}
+
+    TranscodingStage(const TranscodingStage&)             = delete;
+    TranscodingStage& operator=(const TranscodingStage&)  = delete;
+
+    // Transcodes at most one input block. Must be called from the
+    // input's consumer and the output's producer side.
+    [[nodiscard]] decltype(auto) step(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+
+    // Steps until no more progress can be made, i.e. the input is
+    // empty or the output is full.
+    [[nodiscard]] decltype(auto) pump() noexcept;
+
+    // Units held over from a block that ended inside a sequence.
+    [[nodiscard]] decltype(auto) carried() const noexcept
+    {
+        return carry_size_;
+    }
+
+protected:
+    [[nodiscard]] decltype(auto) splice() noexcept;
+
+    [[nodiscard]] static bool aligned(const DestType* output) noexcept
+    {
+        return reinterpret_cast<std::uintptr_t>(output) % Traits::k_Output_Alignment == 0;
+    }
+
+private:
+    InBuffer&               input_;
+    OutBuffer&              output_;
+    SrcType                 carry_[k_Max_Carry];
+    SizeType                carry_size_;
+    std::vector<char32_t>   scratch_;
+};
+
+template<typename InBuffer, typename OutBuffer, typename Transcoder>
+inline
+decltype(auto) TranscodingStage<InBuffer, OutBuffer, Transcoder>::step(SizeType size_requested) noexcept
+{
+    if (carry_size_ > 0)
+        return splice();
+
+    auto        input       = input_.read_block(size_requested);
+    SizeType    available   = input.capacity();
+
+    if (available == 0)
+        return Progress(0, 0);
+
+    auto        output      = output_.buffer(static_cast<SizeType>(available * Traits::k_Output_Factor));
+    SizeType    room        = output.capacity() / Traits::k_Output_Factor;
+    SizeType    size        = (available < room) ? available : room;
+
+    if (size == 0)
+    {
+        output.size(0);
+        output_.commit(output);
+        input.size(0);
+        input_.release(input);
+        return Progress(0, 0);
+    }
+
+    DestType*   destination = output.data();
+
+    if (!aligned(destination))
+    {
+        // Slow path; see above.
+        scratch_.resize((size * Traits::k_Output_Factor * sizeof(DestType) + sizeof(char32_t) - 1) / sizeof(char32_t));
+        destination = reinterpret_cast<DestType*>(scratch_.data());
+    }
+
+    auto [written, consumed] = Transcoder::transcode(destination, input.data(), static_cast<int64_t>(size));
+
+    if (destination != output.data())
+        std::memcpy(output.data(), destination, static_cast<std::size_t>(written) * sizeof(DestType));
+
+    // The whole block was offered and ends inside a sequence:
+    // the rest of it may only show up at the front of the ring.
+    if (consumed < size && size == available && size - consumed <= k_Max_Carry)
+    {
+        carry_size_ = static_cast<SizeType>(size - consumed);
+        std::memcpy(carry_, input.data() + consumed, carry_size_ * sizeof(SrcType));
+        consumed    = size;
+    }
+
+    output.size(static_cast<SizeType>(written));
+    output_.commit(output);
+    input.size(static_cast<SizeType>(consumed));
+    input_.release(input);
+
+    return Progress(static_cast<SizeType>(consumed), static_cast<SizeType>(written));
+}
+
+template<typename InBuffer, typename OutBuffer, typename Transcoder>
+inline
+decltype(auto) TranscodingStage<InBuffer, OutBuffer, Transcoder>::splice() noexcept
+{
+    // Stitch the carried units and the start of the next block
+    // together and transcode the sequence that spans them, adding
+    // one unit at a time until it is complete: only its output
+    // needs room, whatever follows it in the block is left to
+    // step().
+    SrcType     stitch[k_Max_Carry];
+    char32_t    local[k_Max_Carry * Traits::k_Output_Factor * sizeof(DestType) / sizeof(char32_t) + 1];
+
+    auto        input       = input_.read_block(static_cast<SizeType>(k_Max_Carry - carry_size_));
+    SizeType    available   = input.capacity();
+
+    if (available == 0)
+        return Progress(0, 0);
+
+    std::memcpy(stitch, carry_, carry_size_ * sizeof(SrcType));
+    std::memcpy(stitch + carry_size_, input.data(), available * sizeof(SrcType));
+
+    DestType*   destination = reinterpret_cast<DestType*>(local);
+    SizeType    size        = carry_size_;
+    int64_t     written     = 0;
+    int64_t     consumed    = 0;
+
+    do
+    {
+        ++size;
+        std::tie(written, consumed) = Transcoder::transcode(destination, stitch, static_cast<int64_t>(size));
+    }
+    while (consumed <= carry_size_ && size < carry_size_ + available);
+
+    if (consumed <= carry_size_)
+    {
+        // Still incomplete: keep collecting, unless that can never
+        // succeed, in which case the first unit is dropped.
+        SizeType    taken   = 0;
+
+        if (size < k_Max_Carry)
+        {
+            std::memcpy(carry_, stitch, size * sizeof(SrcType));
+            carry_size_ = size;
+            taken       = available;
+        }
+        else
+        {
+            std::memmove(carry_, carry_ + 1, (carry_size_ - 1) * sizeof(SrcType));
+            carry_size_ -= 1;
+        }
+
+        input.size(taken);
+        input_.release(input);
+        return Progress(taken, 0);
+    }
+
+    auto        output      = output_.buffer(static_cast<SizeType>(written));
+
+    if (output.capacity() < written)
+    {
+        output.size(0);
+        output_.commit(output);
+        input.size(0);
+        input_.release(input);
+        return Progress(0, 0);
+    }
+
+    std::memcpy(output.data(), destination, static_cast<std::size_t>(written) * sizeof(DestType));
+
+    SizeType    released    = static_cast<SizeType>(consumed) - carry_size_;
+    carry_size_             = 0;
+
+    output.size(static_cast<SizeType>(written));
+    output_.commit(output);
+    input.size(released);
+    input_.release(input);
+
+    return Progress(released, static_cast<SizeType>(written));
+}
+
+template<typename InBuffer, typename OutBuffer, typename Transcoder>
+inline
+decltype(auto) TranscodingStage<InBuffer, OutBuffer, Transcoder>::pump() noexcept
+{
+    SizeType    consumed    = 0;
+    SizeType    produced    = 0;
+
+    for (;;)
+    {
+        auto [in, out]  = step();
+
+        if (in == 0 && out == 0)
+            break;
+
+        consumed   += in;
+        produced   += out;
+    }
+
+    return Progress(consumed, produced);
+}
+
+}
+
+#endif // _TRANSCODING_STAGE_HPP__
@@ -6,11 +6,20 @@
 #include <mutex>
 #include <tuple>
 #include <limits>
+#include <functional>
 #include <type_traits>
 #include <cassert>
 
 #include "util/helper_functions.hpp"
 #include "util/atomic_lock.hpp"
+#include "util/buffer_policies.hpp"
+#include "util/buffer_telemetry.hpp"
+#include "util/delimiter_scan.hpp"
+#include "util/mapped_storage.hpp"
+#include "util/mirrored_storage.hpp"
+#include "util/spsc_indices.hpp"
+#include "util/vectored_handle.hpp"
+#include "util/wait_strategy.hpp"
 
 namespace util
 {
@@ -19,11 +28,21 @@ namespace util
 // as receiving operation can be expensive. In case of 
 // circular buffer, two receive operation may be needed
 // when the buffer wraps over.
-template<typename Type, typename SizeType, SizeType t_Size>
+//
+// Policies may carry allocation policies (HugePagePolicy,
+// NumaNodePolicy, NoZeroInitPolicy), see MappedStorage.
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
 class TransitBuffer
 {
 public:
+    // The SPSC specialization matches only on the first policy;
+    // a tag further down would silently select this one.
+    static_assert(!has_policy_v<SpscPolicy, Policies...>,
+                  "SpscPolicy must be the first TransitBuffer policy");
+    static_assert(!has_policy_v<MpmcPolicy, Policies...>, "TransitBuffer has no MPMC mode");
+
     using value_type    = Type;
+    using size_type     = SizeType;
 
     struct Handle
     {
@@ -98,14 +117,8 @@ public:
         , sizes_(t_Size)
         , pointers_(buffer_)
         , state_(State::Beginning)
-        , operators_()
-        , movable_block_()
         , lock_()
-    {
-        initialize();
-    }
-
-    decltype(auto) initialize() noexcept;
+    {}
 
     [[nodiscard]] decltype(auto) buffer(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
     [[nodiscard]] decltype(auto) move(Type* move_buffer, const SizeType move_size = 1) noexcept;
@@ -114,7 +127,12 @@ public:
     [[nodiscard]] decltype(auto) read(Type* destination_buffer, const SizeType read_size = 1) noexcept;
 
     using CheckDelimiter   = std::function<bool (const Type*, const Type*, const SizeType)>;
-    [[nodiscard]] decltype(auto) read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, CheckDelimiter check_delimiter = [](const Type*, const Type*, const SizeType) { return true; } ) noexcept;
+    [[nodiscard]] decltype(auto) read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, CheckDelimiter check_delimiter) noexcept;
+
+    // As above, with the predicate as a functor type so that it can
+    // be inlined into the scan; the default accepts every match.
+    template<typename Predicate = AcceptDelimiter>
+    [[nodiscard]] decltype(auto) read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, Predicate check_delimiter = Predicate()) noexcept;
 
     [[nodiscard]] decltype(auto) read_fixed_size(Type* destination_buffer, const int64_t read_size) noexcept;
 
@@ -131,21 +149,33 @@ public:
         return buffer_.data();
     }
 
+    // Counters kept with TelemetryPolicy (see buffer_telemetry.hpp);
+    // all zero without it.
+    [[nodiscard]] decltype(auto) telemetry() noexcept
+    {
+        return (telemetry_);
+    }
+
     decltype(auto) reset() noexcept
     {
         state_      = State::Beginning;
         sizes_.reset();
         pointers_.reset();
+        telemetry_.cleared();
     }
 
 protected:
-    using Buffer                = std::vector<Type>;
+    // One switch per operation over state_, in place of per-state
+    // std::function tables, so that the hot path can be inlined.
+    [[nodiscard]] decltype(auto) reserve_operation(SizeType size_requested) noexcept;
+    void commit_operation(Handle& handle) noexcept;
+    void release_operation(SizeType size_released) noexcept;
+    [[nodiscard]] decltype(auto) movable_block(SizeType size_requested) noexcept;
+
+    using Buffer                = buffer_storage_t<Type, Policies...>;
     using Block                 = std::tuple<Type*, SizeType>;
-    using ReserveOperator       = std::function<Block (SizeType)>;
-    using CommitOperator        = std::function<void (Handle&)>;
-    using ReleaseOperator       = std::function<void (SizeType)>;
-    using ReadBlockOperator     = std::function<Block (SizeType)>;
     using Lock                  = util::AtomicLock;
+    using Telemetry             = buffer_telemetry_t<Policies...>;
 
     enum class State : std::uint8_t
     {
@@ -154,10 +184,6 @@ protected:
         Secondary
     };
 
-    using ReserveOperators      = std::vector<ReserveOperator>;
-    using CommitOperators       = std::vector<CommitOperator>;
-    using ReleaseOperators      = std::vector<ReleaseOperator>;
-
     struct Sizes
     {
         SizeType    size_;
@@ -240,214 +266,142 @@ protected:
         }
     };
 
-    struct Operators
-    {
-        ReserveOperators    reserve_operators_;
-        CommitOperators     commit_operators_;
-        ReleaseOperators    release_operators_;
-
-        Operators() noexcept
-            : reserve_operators_()
-            , commit_operators_()
-            , release_operators_()
-        {}
-
-        Operators(Operators&& operators) noexcept
-            : reserve_operators_(std::move(operators.reserve_operators_))
-            , commit_operators_(std::move(operators.commit_operators_))
-            , release_operators_(std::move(operators.release_operators_))
-        {}
-
-        Operators& operator=(Operators&& operators) noexcept
-        {
-            reserve_operators_  = std::move(operators.reserve_operators_);
-            commit_operators_   = std::move(operators.commit_operators_);
-            release_operators_  = std::move(operators.release_operators_);
-
-            return *this;
-        }
-        ~Operators() noexcept
-        {
-            reserve_operators_.clear();
-            commit_operators_.clear();
-            release_operators_.clear();
-        }
-    };
-
 private:
     Buffer              buffer_;
     Sizes               sizes_;
     Pointers            pointers_;
     State               state_;
-    Operators           operators_;
-    ReadBlockOperator   movable_block_;
     Lock                lock_;
+
+    [[no_unique_address]] Telemetry telemetry_;
 };
 
-template<typename Type, typename SizeType, SizeType t_Size>
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
 inline
-decltype(auto) TransitBuffer<Type, SizeType, t_Size>::initialize() noexcept
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, Policies...>::reserve_operation(SizeType size_requested) noexcept
 {
-    // reserve_operators_
-    // State::Beginning
-    operators_.reserve_operators_.emplace_back(
-            [this](SizeType size_requested)
-            {
-                if (pointers_.promised_tail_ != pointers_.tail_)
-                    return Block(pointers_.tail_, 0);
-
-                SizeType space_available    = (pointers_.fixed_begin_ + sizes_.size_) - pointers_.tail_;
-                SizeType capacity           = (size_requested >= space_available) ? space_available : size_requested;
+    switch (state_)
+    {
+        case State::Beginning:
+        {
+            if (pointers_.promised_tail_ != pointers_.tail_)
+                return Block(pointers_.tail_, 0);
 
-                pointers_.promised_tail_    = pointers_.tail_ + capacity;
-                sizes_.size_right_         -= capacity;
+            SizeType space_available    = (pointers_.fixed_begin_ + sizes_.size_) - pointers_.tail_;
+            SizeType capacity           = (size_requested >= space_available) ? space_available : size_requested;
 
-                return Block(pointers_.tail_, capacity);
-            }
-        );
+            pointers_.promised_tail_    = pointers_.tail_ + capacity;
+            sizes_.size_right_         -= capacity;
 
-    // State::Progressed
-    operators_.reserve_operators_.emplace_back(
-            [this](SizeType size_requested)
-            {
-                if (pointers_.promised_tail_ != pointers_.tail_)
-                    return Block(pointers_.tail_, 0);
+            return Block(pointers_.tail_, capacity);
+        }
 
-                SizeType capacity           = (size_requested >= sizes_.size_right_) ? sizes_.size_right_ : size_requested;
+        case State::Progressed:
+        {
+            if (pointers_.promised_tail_ != pointers_.tail_)
+                return Block(pointers_.tail_, 0);
 
-                pointers_.promised_tail_    = pointers_.tail_ + capacity;
-                sizes_.size_right_         -= capacity;
+            SizeType capacity           = (size_requested >= sizes_.size_right_) ? sizes_.size_right_ : size_requested;
 
-                return Block(pointers_.tail_, capacity);
-            }
-        );
+            pointers_.promised_tail_    = pointers_.tail_ + capacity;
+            sizes_.size_right_         -= capacity;
 
-    // State::Secondary
-    operators_.reserve_operators_.emplace_back(
-            [this](SizeType size_requested)
-            {
-                if (    (pointers_.promised_tail_ != pointers_.tail_) &&
-                        (pointers_.promised_tail_ != pointers_.second_tail_)    )
-                    return Block(pointers_.second_tail_, 0);
+            return Block(pointers_.tail_, capacity);
+        }
 
-                SizeType capacity           = (size_requested >= sizes_.size_left_) ? sizes_.size_left_ : size_requested;
+        case State::Secondary:
+        default:
+        {
+            if (    (pointers_.promised_tail_ != pointers_.tail_) &&
+                    (pointers_.promised_tail_ != pointers_.second_tail_)    )
+                return Block(pointers_.second_tail_, 0);
 
-                pointers_.promised_tail_    = pointers_.second_tail_ + capacity;
-                sizes_.size_left_          -= capacity;
+            SizeType capacity           = (size_requested >= sizes_.size_left_) ? sizes_.size_left_ : size_requested;
 
-                return Block(pointers_.second_tail_, capacity);
-            }
-        );
+            pointers_.promised_tail_    = pointers_.second_tail_ + capacity;
+            sizes_.size_left_          -= capacity;
 
-    // commit_operators_
-    // State::Beginning
-    operators_.commit_operators_.emplace_back(
-            [this](Handle& handle)
-            {
-                SizeType commit_size        = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_; 
-                pointers_.tail_            += commit_size;
-                sizes_.size_right_         += pointers_.promised_tail_ - pointers_.tail_;
-                pointers_.promised_tail_    = pointers_.tail_;
-                handle.data_                = pointers_.tail_;
-                handle.capacity_            = 0;
-                handle.size_                = 0;
+            return Block(pointers_.second_tail_, capacity);
+        }
+    }
+}
 
-                return;
-            }
-        );
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+void TransitBuffer<Type, SizeType, t_Size, Policies...>::commit_operation(Handle& handle) noexcept
+{
+    switch (state_)
+    {
+        case State::Beginning:
+        {
+            SizeType commit_size        = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_; 
+            pointers_.tail_            += commit_size;
+            sizes_.size_right_         += pointers_.promised_tail_ - pointers_.tail_;
+            pointers_.promised_tail_    = pointers_.tail_;
+            handle.data_                = pointers_.tail_;
+            handle.capacity_            = 0;
+            handle.size_                = 0;
+
+            return;
+        }
 
-    // State::Progressed
-    operators_.commit_operators_.emplace_back(
-            [this](Handle& handle)
+        case State::Progressed:
+        {
+            SizeType commit_size        = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_; 
+            pointers_.tail_            += commit_size;
+            sizes_.size_right_         += pointers_.promised_tail_ - pointers_.tail_;
+            pointers_.promised_tail_    = pointers_.tail_;
+            handle.data_                = pointers_.tail_;
+            handle.capacity_            = 0;
+            handle.size_                = 0;
+
+            if (pointers_.head_ == pointers_.tail_)
             {
-                SizeType commit_size        = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_; 
-                pointers_.tail_            += commit_size;
-                sizes_.size_right_         += pointers_.promised_tail_ - pointers_.tail_;
-                pointers_.promised_tail_    = pointers_.tail_;
-                handle.data_                = pointers_.tail_;
-                handle.capacity_            = 0;
-                handle.size_                = 0;
-
-                if (pointers_.head_ == pointers_.tail_)
-                {
-                    state_                      = State::Beginning;
-                    pointers_.head_             = pointers_.fixed_begin_;
-                    pointers_.tail_             = pointers_.fixed_begin_;
-                    pointers_.promised_tail_    = pointers_.fixed_begin_;
-                    pointers_.second_tail_      = pointers_.fixed_begin_;
-                    sizes_.size_left_           = 0;
-                    sizes_.size_right_          = sizes_.size_;
-
-                    return;
-                }
-
-                if (sizes_.size_left_ > sizes_.size_right_)
-                    state_                  = State::Secondary;
+                state_                      = State::Beginning;
+                pointers_.head_             = pointers_.fixed_begin_;
+                pointers_.tail_             = pointers_.fixed_begin_;
+                pointers_.promised_tail_    = pointers_.fixed_begin_;
+                pointers_.second_tail_      = pointers_.fixed_begin_;
+                sizes_.size_left_           = 0;
+                sizes_.size_right_          = sizes_.size_;
 
                 return;
             }
-        );
 
-    // State::Secondary
-    operators_.commit_operators_.emplace_back(
-            [this](Handle& handle)
-            {
-                if (pointers_.tail_ == pointers_.promised_tail_)
-                    return;
+            if (sizes_.size_left_ > sizes_.size_right_)
+                state_                  = State::Secondary;
 
-                SizeType commit_size        = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_; 
-                pointers_.second_tail_     += commit_size;
-                sizes_.size_left_          += pointers_.promised_tail_ - pointers_.second_tail_;
-                pointers_.promised_tail_    = pointers_.second_tail_;
-                handle.data_                = pointers_.second_tail_;
-                handle.capacity_            = 0;
-                handle.size_                = 0;
+            return;
+        }
 
+        case State::Secondary:
+        default:
+        {
+            if (pointers_.tail_ == pointers_.promised_tail_)
                 return;
-            }
-        );
-
-    // release_operators_
-    // State::Beginning
-    operators_.release_operators_.emplace_back(
-            [this](SizeType size_released)
-            {
-                if (size_released != 0)
-                {
-                    pointers_.head_            += size_released;
-                    sizes_.size_left_          += size_released;
 
-                    if (pointers_.head_ == pointers_.promised_tail_)
-                    {
-                        state_                      = State::Beginning;
-                        pointers_.head_             = pointers_.fixed_begin_;
-                        pointers_.tail_             = pointers_.fixed_begin_;
-                        pointers_.promised_tail_    = pointers_.fixed_begin_;
-                        pointers_.second_tail_      = pointers_.fixed_begin_;
-                        sizes_.size_left_           = 0;
-                        sizes_.size_right_          = sizes_.size_;
-
-                        return;
-                    }
-
-                    if (pointers_.tail_ == pointers_.promised_tail_)
-                    {
-                        state_                      = (sizes_.size_right_ > sizes_.size_left_) ? State::Progressed : State::Secondary;
+            SizeType commit_size        = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_; 
+            pointers_.second_tail_     += commit_size;
+            sizes_.size_left_          += pointers_.promised_tail_ - pointers_.second_tail_;
+            pointers_.promised_tail_    = pointers_.second_tail_;
+            handle.data_                = pointers_.second_tail_;
+            handle.capacity_            = 0;
+            handle.size_                = 0;
 
-                        return;
-                    }
-
-                    if (pointers_.tail_ != pointers_.promised_tail_)
-                        state_                      = State::Progressed;
-                }
-
-                return;
-            }
-        );
+            return;
+        }
+    }
+}
 
-    // State::Progressed
-    operators_.release_operators_.emplace_back(
-            [this](SizeType size_released)
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+void TransitBuffer<Type, SizeType, t_Size, Policies...>::release_operation(SizeType size_released) noexcept
+{
+    switch (state_)
+    {
+        case State::Beginning:
+        {
+            if (size_released != 0)
             {
                 pointers_.head_            += size_released;
                 sizes_.size_left_          += size_released;
@@ -465,88 +419,120 @@ decltype(auto) TransitBuffer<Type, SizeType, t_Size>::initialize() noexcept
                     return;
                 }
 
-                if (pointers_.tail_ == pointers_.promised_tail_ && sizes_.size_left_ > sizes_.size_right_)
-                    state_                      = State::Secondary;
+                if (pointers_.tail_ == pointers_.promised_tail_)
+                {
+                    state_                      = (sizes_.size_right_ > sizes_.size_left_) ? State::Progressed : State::Secondary;
 
-                return;
+                    return;
+                }
+
+                if (pointers_.tail_ != pointers_.promised_tail_)
+                    state_                      = State::Progressed;
             }
-        );
 
-    // State::Secondary
-    operators_.release_operators_.emplace_back(
-            [this](SizeType size_released)
+            return;
+        }
+
+        case State::Progressed:
+        {
+            pointers_.head_            += size_released;
+            sizes_.size_left_          += size_released;
+
+            if (pointers_.head_ == pointers_.promised_tail_)
             {
-                pointers_.head_            += size_released;
-                sizes_.size_left_          += size_released;
+                state_                      = State::Beginning;
+                pointers_.head_             = pointers_.fixed_begin_;
+                pointers_.tail_             = pointers_.fixed_begin_;
+                pointers_.promised_tail_    = pointers_.fixed_begin_;
+                pointers_.second_tail_      = pointers_.fixed_begin_;
+                sizes_.size_left_           = 0;
+                sizes_.size_right_          = sizes_.size_;
 
-                if (pointers_.head_ == pointers_.promised_tail_ && sizes_.size_left_ != 0)
-                {
-                    state_                      = State::Beginning;
-                    pointers_.head_             = pointers_.fixed_begin_;
-                    pointers_.tail_             = pointers_.fixed_begin_;
-                    pointers_.promised_tail_    = pointers_.fixed_begin_;
-                    pointers_.second_tail_      = pointers_.fixed_begin_;
-                    sizes_.size_left_           = 0;
-                    sizes_.size_right_          = sizes_.size_;
+                return;
+            }
 
-                    return;
-                }
+            if (pointers_.tail_ == pointers_.promised_tail_ && sizes_.size_left_ > sizes_.size_right_)
+                state_                      = State::Secondary;
 
-                if (pointers_.head_ == pointers_.tail_ && pointers_.head_ == pointers_.promised_tail_)
-                {
-                    state_                      = State::Beginning;
-                    pointers_.head_             = pointers_.fixed_begin_;
-                    pointers_.tail_             = pointers_.fixed_begin_;
-                    pointers_.promised_tail_    = pointers_.fixed_begin_;
-                    pointers_.second_tail_      = pointers_.fixed_begin_;
-                    sizes_.size_left_           = 0;
-                    sizes_.size_right_          = sizes_.size_;
+            return;
+        }
 
-                    return;
-                }
+        case State::Secondary:
+        default:
+        {
+            pointers_.head_            += size_released;
+            sizes_.size_left_          += size_released;
 
-                if (pointers_.head_ == pointers_.tail_)
-                {
-                    state_                      = State::Beginning;
-                    pointers_.head_             = pointers_.fixed_begin_;
-                    pointers_.tail_             = pointers_.second_tail_;
-                    pointers_.second_tail_      = pointers_.fixed_begin_;
-                    sizes_.size_right_          = (pointers_.fixed_begin_ + sizes_.size_) - pointers_.promised_tail_;
-                    sizes_.size_left_           = 0;
-                }
+            if (pointers_.head_ == pointers_.promised_tail_ && sizes_.size_left_ != 0)
+            {
+                state_                      = State::Beginning;
+                pointers_.head_             = pointers_.fixed_begin_;
+                pointers_.tail_             = pointers_.fixed_begin_;
+                pointers_.promised_tail_    = pointers_.fixed_begin_;
+                pointers_.second_tail_      = pointers_.fixed_begin_;
+                sizes_.size_left_           = 0;
+                sizes_.size_right_          = sizes_.size_;
 
                 return;
             }
-        );
 
-    movable_block_  =
-        [this](SizeType size_requested)
-        {
-            SizeType    size = pointers_.tail_ - pointers_.head_;
+            if (pointers_.head_ == pointers_.tail_ && pointers_.head_ == pointers_.promised_tail_)
+            {
+                state_                      = State::Beginning;
+                pointers_.head_             = pointers_.fixed_begin_;
+                pointers_.tail_             = pointers_.fixed_begin_;
+                pointers_.promised_tail_    = pointers_.fixed_begin_;
+                pointers_.second_tail_      = pointers_.fixed_begin_;
+                sizes_.size_left_           = 0;
+                sizes_.size_right_          = sizes_.size_;
 
-            if (size > size_requested)
-                size    = size_requested;
+                return;
+            }
 
-            return Block(pointers_.head_, size);
-        };
+            if (pointers_.head_ == pointers_.tail_)
+            {
+                state_                      = State::Beginning;
+                pointers_.head_             = pointers_.fixed_begin_;
+                pointers_.tail_             = pointers_.second_tail_;
+                pointers_.second_tail_      = pointers_.fixed_begin_;
+                sizes_.size_right_          = (pointers_.fixed_begin_ + sizes_.size_) - pointers_.promised_tail_;
+                sizes_.size_left_           = 0;
+            }
 
-    return;
+            return;
+        }
+    }
 }
 
-template<typename Type, typename SizeType, SizeType t_Size>
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
 inline
-decltype(auto) TransitBuffer<Type, SizeType, t_Size>::buffer(SizeType size_requested) noexcept
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, Policies...>::movable_block(SizeType size_requested) noexcept
+{
+    SizeType    size = pointers_.tail_ - pointers_.head_;
+
+    if (size > size_requested)
+        size    = size_requested;
+
+    return Block(pointers_.head_, size);
+
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, Policies...>::buffer(SizeType size_requested) noexcept
 {
     std::scoped_lock<Lock> lock(lock_);
 
-    auto&& [movable_buffer, movable_size]   = operators_.reserve_operators_[to_index(state_)](size_requested);
+    auto&& [movable_buffer, movable_size]   = reserve_operation(size_requested);
+
+    telemetry_.reserved(static_cast<SizeType>(movable_buffer - data()), size_requested, movable_size);
 
     return Handle(this, movable_buffer, movable_size);
 }
 
-template<typename Type, typename SizeType, SizeType t_Size>
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
 inline
-decltype(auto) TransitBuffer<Type, SizeType, t_Size>::move(Type* move_buffer, const SizeType move_size) noexcept
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, Policies...>::move(Type* move_buffer, const SizeType move_size) noexcept
 {
     SizeType size = 0;
 
@@ -559,7 +545,9 @@ decltype(auto) TransitBuffer<Type, SizeType, t_Size>::move(Type* move_buffer, co
         {
             std::scoped_lock<Lock> lock(lock_);
 
-            auto&& [movable_buffer, movable_size] = operators_.reserve_operators_[to_index(state_)](remaining_size);
+            auto&& [movable_buffer, movable_size] = reserve_operation(remaining_size);
+
+            telemetry_.reserved(static_cast<SizeType>(movable_buffer - data()), remaining_size, movable_size);
 
             buffer      = movable_buffer;
             buffer_size = movable_size;
@@ -583,22 +571,24 @@ decltype(auto) TransitBuffer<Type, SizeType, t_Size>::move(Type* move_buffer, co
 
 }
 
-template<typename Type, typename SizeType, SizeType t_Size>
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
 inline
-decltype(auto) TransitBuffer<Type, SizeType, t_Size>::commit(Handle& handle) noexcept
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, Policies...>::commit(Handle& handle) noexcept
 {
     std::scoped_lock<Lock>  lock(lock_);
-    operators_.commit_operators_[to_index(state_)](handle);
+
+    telemetry_.committed((handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_);
+    commit_operation(handle);
 }
 
-template<typename Type, typename SizeType, SizeType t_Size>
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
 inline
-decltype(auto) TransitBuffer<Type, SizeType, t_Size>::read(Type* destination_buffer, const SizeType read_size) noexcept
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, Policies...>::read(Type* destination_buffer, const SizeType read_size) noexcept
 {
     auto&& [movable_buffer, movable_size]  = [this](auto size)
                 {
                     std::scoped_lock<Lock>  lock(lock_);
-                    return movable_block_(size);
+                    return movable_block(size);
                 }(read_size);
 
     for (SizeType index = 0; index < movable_size; ++index)
@@ -607,15 +597,24 @@ decltype(auto) TransitBuffer<Type, SizeType, t_Size>::read(Type* destination_buf
     [this](auto movable_size)
     {
         std::scoped_lock<Lock>  lock(lock_);
-        operators_.release_operators_[to_index(state_)](movable_size);
+        release_operation(movable_size);
+        telemetry_.released(movable_size);
     }(movable_size);
 
     return movable_size;
 }
 
-template<typename Type, typename SizeType, SizeType t_Size>
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
 inline
-decltype(auto) TransitBuffer<Type, SizeType, t_Size>::read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, CheckDelimiter check_delimiter) noexcept
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, Policies...>::read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, CheckDelimiter check_delimiter) noexcept
+{
+    return read<CheckDelimiter&>(destination_buffer, destination_buffer_size, delimiter, delimiter_size, check_delimiter);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+template<typename Predicate>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, Policies...>::read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, Predicate check_delimiter) noexcept
 {
     bool        delimiter_found     = false;
     SizeType    data_size           = 0;
@@ -625,40 +624,18 @@ decltype(auto) TransitBuffer<Type, SizeType, t_Size>::read(Type* destination_buf
         auto&& [movable_buffer, movable_size]  = [this]()
                     {
                         std::scoped_lock<Lock>  lock(lock_);
-                        return movable_block_(std::numeric_limits<SizeType>::max());
+                        return movable_block(std::numeric_limits<SizeType>::max());
                     }();
 
         SizeType index      = 0;
 
-        for (index = 0; index < movable_size && data_size < destination_buffer_size; ++index)
-        {
-            destination_buffer[data_size++] = std::move(movable_buffer[index]);
-
-            if (index > delimiter_size)
-            {
-                bool    delimiter_match = true;
-                for (SizeType i = 0; i < delimiter_size; ++i)
-                {
-                    if (destination_buffer[data_size - 1 - i] != delimiter[delimiter_size - 1 - i])
-                    {
-                        delimiter_match = false;
-                        break;
-                    }
-                }
-
-                if (delimiter_match && check_delimiter(destination_buffer, delimiter, delimiter_size))
-                {
-                    delimiter_found = true;
-                    ++index;
-                    break;
-                }
-            }
-        }
+        std::tie(index, delimiter_found) = scan_delimited(movable_buffer, movable_size, destination_buffer, data_size, destination_buffer_size, delimiter, delimiter_size, check_delimiter);
 
         [this](auto index)
         {
             std::scoped_lock<Lock>  lock(lock_);
-            operators_.release_operators_[to_index(state_)](index);
+            release_operation(index);
+            telemetry_.released(index);
         }(index);
 
     } while(!delimiter_found && data_size < destination_buffer_size);
@@ -666,9 +643,9 @@ decltype(auto) TransitBuffer<Type, SizeType, t_Size>::read(Type* destination_buf
     return ReadSizeStatus(data_size, delimiter_found);
 }
 
-template<typename Type, typename SizeType, SizeType t_Size>
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
 inline
-decltype(auto) TransitBuffer<Type, SizeType, t_Size>::read_fixed_size(Type* destination_buffer, const int64_t read_size) noexcept
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, Policies...>::read_fixed_size(Type* destination_buffer, const int64_t read_size) noexcept
 {
     SizeType    data_size           = 0;
 
@@ -677,7 +654,7 @@ decltype(auto) TransitBuffer<Type, SizeType, t_Size>::read_fixed_size(Type* dest
         auto&& [movable_buffer, movable_size]  = [this]()
                     {
                         std::scoped_lock<Lock>  lock(lock_);
-                        return movable_block_(std::numeric_limits<SizeType>::max());
+                        return movable_block(std::numeric_limits<SizeType>::max());
                     }();
 
         SizeType index      = 0;
@@ -690,7 +667,8 @@ decltype(auto) TransitBuffer<Type, SizeType, t_Size>::read_fixed_size(Type* dest
         [this](auto index)
         {
             std::scoped_lock<Lock>  lock(lock_);
-            operators_.release_operators_[to_index(state_)](index);
+            release_operation(index);
+            telemetry_.released(index);
         }(index);
 
     } while(static_cast<int64_t>(data_size) < read_size);
@@ -698,28 +676,31 @@ decltype(auto) TransitBuffer<Type, SizeType, t_Size>::read_fixed_size(Type* dest
     return;
 }
 
-template<typename Type, typename SizeType, SizeType t_Size>
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
 inline
-decltype(auto) TransitBuffer<Type, SizeType, t_Size>::read_block(SizeType size_requested) noexcept
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, Policies...>::read_block(SizeType size_requested) noexcept
 {
     auto&& [movable_buffer, movable_size]  = [this](auto size)
                 {
                     std::scoped_lock<Lock>  lock(lock_);
-                    return movable_block_(size);
+                    return movable_block(size);
                 }(size_requested);
 
+    telemetry_.readable(movable_size);
+
     return Handle(this, movable_buffer, movable_size);
 }
 
-template<typename Type, typename SizeType, SizeType t_Size>
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
 inline
-decltype(auto) TransitBuffer<Type, SizeType, t_Size>::release(Handle& handle) noexcept
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, Policies...>::release(Handle& handle) noexcept
 {
     std::scoped_lock<Lock>  lock(lock_);
 
     SizeType release_size   = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_;
 
-    operators_.release_operators_[to_index(state_)](release_size);
+    release_operation(release_size);
+    telemetry_.released(release_size);
 
     handle.capacity_        = 0;
     handle.size_            = 0;
@@ -727,6 +708,459 @@ decltype(auto) TransitBuffer<Type, SizeType, t_Size>::release(Handle& handle) no
     return;
 }
 
+
+// Single-producer/single-consumer specialization; see the
+// RingBuffer specialization for the threading rules. As in
+// the general TransitBuffer, a reservation is offered from
+// whichever side of the buffer has more room. With
+// MirroredPolicy there is only ever one side: all free room
+// is a single span, so one receive call can fill it.
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+class TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>
+{
+public:
+    static_assert(!has_policy_v<MpmcPolicy, Policies...>, "TransitBuffer has no MPMC mode");
+
+    using value_type    = Type;
+    using size_type     = SizeType;
+
+    struct Handle
+    {
+    public:
+        explicit Handle(TransitBuffer* parent, Type* data, SizeType capacity, bool reader = false) noexcept
+            : parent_(parent)
+            , reader_(reader)
+            , data_(data)
+            , capacity_(capacity)
+            , size_(0)
+        {}
+
+        Handle()    = delete;
+
+        Handle(Handle&& handle) noexcept
+            : parent_(std::move(handle.parent_))
+            , reader_(std::move(handle.reader_))
+            , data_(std::move(handle.data_))
+            , capacity_(std::move(handle.capacity_))
+            , size_(std::move(handle.size_))
+        {
+            handle.size_        = 0;
+            handle.capacity_    = 0;
+        }
+
+        Handle& operator=(Handle&& handle) noexcept
+        {
+            parent_             = std::move(handle.parent_);
+            reader_             = std::move(handle.reader_);
+            data_               = std::move(handle.data_);
+            capacity_           = std::move(handle.capacity_);
+            size_               = std::move(handle.size_);
+
+            handle.size_        = 0;
+            handle.capacity_    = 0;
+
+            return *this;
+        }
+
+        [[nodiscard]] decltype(auto) data() noexcept
+        {
+            return data_;
+        }
+
+        [[nodiscard]] decltype(auto) capacity() noexcept
+        {
+            return capacity_;
+        }
+
+        void size(SizeType s) noexcept
+        {
+            size_   = std::move(s);
+        }
+
+        ~Handle() noexcept
+        {
+            if (capacity_ > 0)
+            {
+                if (reader_)
+                    parent_->release(*this);
+                else
+                    parent_->commit(*this);
+            }
+        }
+
+    private:
+        TransitBuffer*  parent_;
+        bool            reader_;
+
+    public:
+        Type*           data_;
+        SizeType        capacity_;
+        SizeType        size_;
+    };
+
+    using ReadSizeStatus    = std::tuple<SizeType, bool>;
+
+    using VectoredHandle    = util::VectoredHandle<TransitBuffer, SizeType>;
+
+    template<typename... Args>
+    TransitBuffer(Args&&... args)
+        : buffer_(t_Size, Type(std::forward<Args>(args)...))
+        , indices_(static_cast<SizeType>(buffer_.size()), true)
+    {}
+
+    [[nodiscard]] decltype(auto) buffer(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+    [[nodiscard]] decltype(auto) move(Type* move_buffer, const SizeType move_size = 1) noexcept;
+    decltype(auto) commit(Handle& handle) noexcept;
+
+    [[nodiscard]] decltype(auto) read(Type* destination_buffer, const SizeType read_size = 1) noexcept;
+
+    using CheckDelimiter   = std::function<bool (const Type*, const Type*, const SizeType)>;
+    [[nodiscard]] decltype(auto) read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, CheckDelimiter check_delimiter) noexcept;
+
+    // As above, with the predicate as a functor type so that it can
+    // be inlined into the scan; the default accepts every match.
+    template<typename Predicate = AcceptDelimiter>
+    [[nodiscard]] decltype(auto) read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, Predicate check_delimiter = Predicate()) noexcept;
+
+    [[nodiscard]] decltype(auto) read_fixed_size(Type* destination_buffer, const int64_t read_size) noexcept;
+
+    [[nodiscard]] decltype(auto) read_block(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+    decltype(auto) release(Handle& handle) noexcept;
+
+    // Both spans on either side of the wrap point as an iovec pair,
+    // for a single readv/writev/recvmsg. Commit/release account for
+    // both spans in one index update. Trivially copyable types only.
+    [[nodiscard]] decltype(auto) reserve_vectored(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+    decltype(auto) commit(VectoredHandle& handle) noexcept;
+    [[nodiscard]] decltype(auto) read_vectored(SizeType size_requested = std::numeric_limits<SizeType>::max()) noexcept;
+    decltype(auto) release(VectoredHandle& handle) noexcept;
+
+    // Blocking waits with the strategy named in Policies (SpinWait,
+    // FutexWait or EventFdWait, see wait_strategy.hpp): until
+    // read_block() would return data, on the consumer thread, and
+    // until buffer() would return space, on the producer thread.
+    // The blocking move()/read() variants wait the same way.
+    decltype(auto) wait_readable() noexcept;
+    decltype(auto) wait_writable() noexcept;
+
+    // The strategy objects themselves, e.g. for EventFdWait::fd().
+    [[nodiscard]] decltype(auto) readable_waiter() noexcept
+    {
+        return (readable_waiter_);
+    }
+
+    [[nodiscard]] decltype(auto) writable_waiter() noexcept
+    {
+        return (writable_waiter_);
+    }
+
+    ~TransitBuffer() noexcept
+    {
+        buffer_.clear();
+    }
+
+    [[nodiscard]] decltype(auto) data() noexcept
+    {
+        return buffer_.data();
+    }
+
+    [[nodiscard]] decltype(auto) capacity() const noexcept
+    {
+        return static_cast<SizeType>(buffer_.size());
+    }
+
+    // Counters kept with TelemetryPolicy (see buffer_telemetry.hpp);
+    // all zero without it.
+    [[nodiscard]] decltype(auto) telemetry() noexcept
+    {
+        return (telemetry_);
+    }
+
+    // Not thread safe; only while both sides are idle.
+    decltype(auto) reset() noexcept
+    {
+        indices_.reset();
+        telemetry_.cleared();
+    }
+
+protected:
+    static constexpr bool k_Mirrored    = has_policy_v<MirroredPolicy, Policies...>;
+
+    static_assert(!k_Mirrored || !AllocationPolicies<Policies...>::k_Mapped, "allocation policies do not apply to mirrored storage");
+
+    using Buffer                = std::conditional_t<k_Mirrored, MirroredStorage<Type>, buffer_storage_t<Type, Policies...>>;
+    using Indices               = std::conditional_t<k_Mirrored, SpscMirroredIndices<SizeType>, SpscIndices<SizeType>>;
+    using Waiter                = wait_strategy_t<Policies...>;
+    using Telemetry             = buffer_telemetry_t<Policies...>;
+
+private:
+    Buffer              buffer_;
+    Indices             indices_;
+    Waiter              readable_waiter_;
+    Waiter              writable_waiter_;
+
+    [[no_unique_address]] Telemetry telemetry_;
+};
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::buffer(SizeType size_requested) noexcept
+{
+    auto [begin, capacity]      = indices_.reserve(size_requested);
+
+    telemetry_.reserved(begin, size_requested, capacity);
+
+    return Handle(this, data() + begin, capacity);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::move(Type* move_buffer, const SizeType move_size) noexcept
+{
+    SizeType size = 0;
+
+    do
+    {
+        SizeType    remaining_size  = move_size - size;
+        auto [buffer_begin, buffer_size] = indices_.reserve(remaining_size);
+
+        telemetry_.reserved(buffer_begin, remaining_size, buffer_size);
+
+        if (buffer_size == 0 && remaining_size > 0)
+        {
+            wait_writable();
+            continue;
+        }
+
+        Type*       buffer          = data() + buffer_begin;
+
+        if (buffer_size < remaining_size)
+            remaining_size  = buffer_size;
+
+        for (SizeType i = 0; i < remaining_size; ++i)
+        {
+            buffer[i]   = std::move(move_buffer[size++]);
+        }
+
+        indices_.commit(remaining_size);
+        telemetry_.committed(remaining_size);
+        readable_waiter_.notify();
+
+    } while(size < move_size);
+
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::commit(Handle& handle) noexcept
+{
+    SizeType commit_size    = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_;
+
+    indices_.commit(commit_size);
+    telemetry_.committed(commit_size);
+    readable_waiter_.notify();
+
+    handle.data_           += commit_size;
+    handle.capacity_        = 0;
+    handle.size_            = 0;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::read(Type* destination_buffer, const SizeType read_size) noexcept
+{
+    auto [begin, movable_size]  = indices_.readable(read_size);
+    Type* movable_buffer        = data() + begin;
+
+    for (SizeType index = 0; index < movable_size; ++index)
+        destination_buffer[index]   = std::move(movable_buffer[index]);
+
+    indices_.release(movable_size);
+    telemetry_.released(movable_size);
+    writable_waiter_.notify();
+
+    return movable_size;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, CheckDelimiter check_delimiter) noexcept
+{
+    return read<CheckDelimiter&>(destination_buffer, destination_buffer_size, delimiter, delimiter_size, check_delimiter);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+template<typename Predicate>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::read(Type* destination_buffer, const SizeType destination_buffer_size, const Type* delimiter, const SizeType delimiter_size, Predicate check_delimiter) noexcept
+{
+    bool        delimiter_found     = false;
+    SizeType    data_size           = 0;
+
+    do
+    {
+        auto [begin, movable_size]  = indices_.readable(std::numeric_limits<SizeType>::max());
+
+        if (movable_size == 0 && data_size < destination_buffer_size)
+        {
+            wait_readable();
+            continue;
+        }
+
+        Type*    movable_buffer     = data() + begin;
+        SizeType index              = 0;
+
+        std::tie(index, delimiter_found) = scan_delimited(movable_buffer, movable_size, destination_buffer, data_size, destination_buffer_size, delimiter, delimiter_size, check_delimiter);
+
+        indices_.release(index);
+        telemetry_.released(index);
+        writable_waiter_.notify();
+
+    } while(!delimiter_found && data_size < destination_buffer_size);
+
+    return ReadSizeStatus(data_size, delimiter_found);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::read_fixed_size(Type* destination_buffer, const int64_t read_size) noexcept
+{
+    SizeType    data_size           = 0;
+
+    do
+    {
+        auto [begin, movable_size]  = indices_.readable(std::numeric_limits<SizeType>::max());
+
+        if (movable_size == 0 && static_cast<int64_t>(data_size) < read_size)
+        {
+            wait_readable();
+            continue;
+        }
+
+        Type*    movable_buffer     = data() + begin;
+        SizeType index              = 0;
+
+        while (index < movable_size && static_cast<int64_t>(data_size) < read_size)
+        {
+            destination_buffer[data_size++] = std::move(movable_buffer[index++]);
+        }
+
+        indices_.release(index);
+        telemetry_.released(index);
+        writable_waiter_.notify();
+
+    } while(static_cast<int64_t>(data_size) < read_size);
+
+    return;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::read_block(SizeType size_requested) noexcept
+{
+    auto [begin, movable_size]  = indices_.readable(size_requested);
+
+    telemetry_.readable(movable_size);
+
+    return Handle(this, data() + begin, movable_size, true);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::release(Handle& handle) noexcept
+{
+    SizeType release_size   = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_;
+
+    indices_.release(release_size);
+    telemetry_.released(release_size);
+    writable_waiter_.notify();
+
+    handle.capacity_        = 0;
+    handle.size_            = 0;
+
+    return;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::reserve_vectored(SizeType size_requested) noexcept
+{
+    static_assert(std::is_trivially_copyable_v<Type>, "vectored I/O moves raw bytes");
+
+    auto [first_begin, first_size, second_begin, second_size] = indices_.reserve_vectored(size_requested);
+
+    telemetry_.reserved(first_begin, size_requested, static_cast<SizeType>(first_size + second_size));
+
+    return VectoredHandle(this,
+                iovec{data() + first_begin, first_size * sizeof(Type)},
+                iovec{data() + second_begin, second_size * sizeof(Type)},
+                first_size + second_size);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::commit(VectoredHandle& handle) noexcept
+{
+    SizeType commit_size    = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_;
+
+    indices_.commit(commit_size);
+    telemetry_.committed(commit_size);
+    readable_waiter_.notify();
+
+    handle.capacity_        = 0;
+    handle.size_            = 0;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::read_vectored(SizeType size_requested) noexcept
+{
+    static_assert(std::is_trivially_copyable_v<Type>, "vectored I/O moves raw bytes");
+
+    auto [first_begin, first_size, second_begin, second_size] = indices_.readable_vectored(size_requested);
+
+    telemetry_.readable(first_size + second_size);
+
+    return VectoredHandle(this,
+                iovec{data() + first_begin, first_size * sizeof(Type)},
+                iovec{data() + second_begin, second_size * sizeof(Type)},
+                first_size + second_size, true);
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::release(VectoredHandle& handle) noexcept
+{
+    SizeType release_size   = (handle.size_ < handle.capacity_) ? handle.size_ : handle.capacity_;
+
+    indices_.release(release_size);
+    telemetry_.released(release_size);
+    writable_waiter_.notify();
+
+    handle.capacity_        = 0;
+    handle.size_            = 0;
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::wait_readable() noexcept
+{
+    readable_waiter_.await([this]() noexcept { return indices_.can_read(); });
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+inline
+decltype(auto) TransitBuffer<Type, SizeType, t_Size, SpscPolicy, Policies...>::wait_writable() noexcept
+{
+    writable_waiter_.await([this]() noexcept { return indices_.can_write(); });
+}
+
+template<typename Type, typename SizeType, SizeType t_Size, typename... Policies>
+struct BufferTraits<TransitBuffer<Type, SizeType, t_Size, Policies...>>
+{
+    static constexpr bool   k_Larger_Region = true;
+};
+
 }
 
 #endif //_TRANSIT_BUFFER_HPP__
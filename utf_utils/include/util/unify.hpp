@@ -1,5 +1,5 @@
-#ifndef _UNICODE_HPP__
-#define _UNICODE_HPP__
+#ifndef _UNIFY_HPP__
+#define _UNIFY_HPP__
 
 #include <algorithm>
 #include <execution>
@@ -359,8 +359,9 @@ void UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>::simplify
             (std::is_same<char32_t, DestType>::value && std::is_same<char8_t,  SrcType>::value) )
     {
         char32_t* output32_p    = reinterpret_cast<char32_t*>(output);
+        int64_t   length        = size / k_Convertion_Factor;     // size is in DestType units
 
-        auto u8_to_32  = [&output32_p, &size](const char32_t& value)
+        auto u8_to_32  = [&output32_p, &length](const char32_t& value)
             {
                 if ( ((value & 0x00000080) == 0x0)        ||
                      ((value & 0x000000C0) == 0x00000080) )
@@ -378,7 +379,7 @@ void UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>::simplify
                 int64_t index       = &value - output32_p;
 
                 // last incomplete element
-                if (index + num_bytes > size)
+                if (index + num_bytes > length)
                     return;
 
                 uint8_t ctr = 0;
@@ -394,15 +395,16 @@ void UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>::simplify
                 return;
             };
 
-        std::for_each(std::execution::unseq, output32_p, output32_p + size, u8_to_32);
+        std::for_each(std::execution::unseq, output32_p, output32_p + length, u8_to_32);
     }
     else if constexpr (
             (std::is_same<char8_t,  DestType>::value && std::is_same<char16_t, SrcType>::value) ||
             (std::is_same<char32_t, DestType>::value && std::is_same<char16_t, SrcType>::value) )
     {
         char32_t* output32_p    = reinterpret_cast<char32_t*>(output);
+        int64_t   length        = size / k_Convertion_Factor;     // size is in DestType units
 
-        auto u16_to_32  = [&output32_p, &size](const char32_t& value)
+        auto u16_to_32  = [&output32_p, &length](const char32_t& value)
             {
                 if ((value & 0x0000FC00) != 0x0000D800)
                     return;
@@ -410,7 +412,7 @@ void UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>::simplify
                 int64_t index       = &value - output32_p;
 
                 // last incomplete element or lower surrogate
-                if (((value & 0x0000FC00) == 0x0000DC00) || (index + 1 == size))
+                if (((value & 0x0000FC00) == 0x0000DC00) || (index + 1 == length))
                     return;
 
                 output32_p[index]   = ( (value << 16) | (output32_p[index + 1] & 0x0000FFFF) );
@@ -418,7 +420,7 @@ void UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>::simplify
                 return;
             };
 
-        std::for_each(std::execution::unseq, output32_p, output32_p + size, u16_to_32);
+        std::for_each(std::execution::unseq, output32_p, output32_p + length, u16_to_32);
     }
     else
     {
@@ -1013,4 +1015,4 @@ UniFy<DestType, SrcType, BigEndianDest, BigEndianSrc, t_dest_ptr>::qualify(DestT
 
 }
 
-#endif  //_UNICODE_HPP__
+#endif  //_UNIFY_HPP__
@@ -0,0 +1,102 @@
+#ifndef _VECTORED_HANDLE_HPP__
+#define _VECTORED_HANDLE_HPP__
+
+#include <cstddef>
+#include <utility>
+
+#include <sys/uio.h>
+
+namespace util
+{
+
+// Up to two spans of a ring, the part before the wrap point and
+// the part after it, laid out as an iovec array so that one
+// readv/writev/recvmsg/sendmsg call covers both. size() is in
+// elements and counts from the start of the first span into the
+// second; on destruction the handle commits (producer) or
+// releases (consumer) that many elements in one step.
+template<typename Buffer, typename SizeType>
+class VectoredHandle
+{
+public:
+    explicit VectoredHandle(Buffer* parent, const iovec& first, const iovec& second, SizeType capacity, bool reader = false) noexcept
+        : parent_(parent)
+        , reader_(reader)
+        , iov_{first, second}
+        , capacity_(capacity)
+        , size_(0)
+    {}
+
+    VectoredHandle()    = delete;
+
+    VectoredHandle(VectoredHandle&& handle) noexcept
+        : parent_(std::move(handle.parent_))
+        , reader_(std::move(handle.reader_))
+        , iov_{handle.iov_[0], handle.iov_[1]}
+        , capacity_(std::move(handle.capacity_))
+        , size_(std::move(handle.size_))
+    {
+        handle.size_        = 0;
+        handle.capacity_    = 0;
+    }
+
+    VectoredHandle& operator=(VectoredHandle&& handle) noexcept
+    {
+        parent_             = std::move(handle.parent_);
+        reader_             = std::move(handle.reader_);
+        iov_[0]             = handle.iov_[0];
+        iov_[1]             = handle.iov_[1];
+        capacity_           = std::move(handle.capacity_);
+        size_               = std::move(handle.size_);
+
+        handle.size_        = 0;
+        handle.capacity_    = 0;
+
+        return *this;
+    }
+
+    [[nodiscard]] decltype(auto) iov() noexcept
+    {
+        return static_cast<iovec*>(iov_);
+    }
+
+    // 0, 1 or 2; empty spans are never followed by a used one.
+    [[nodiscard]] decltype(auto) iov_count() const noexcept
+    {
+        return static_cast<int>(iov_[0].iov_len != 0) + static_cast<int>(iov_[1].iov_len != 0);
+    }
+
+    [[nodiscard]] decltype(auto) capacity() noexcept
+    {
+        return capacity_;
+    }
+
+    void size(SizeType s) noexcept
+    {
+        size_   = s;
+    }
+
+    ~VectoredHandle() noexcept
+    {
+        if (capacity_ > 0)
+        {
+            if (reader_)
+                parent_->release(*this);
+            else
+                parent_->commit(*this);
+        }
+    }
+
+private:
+    Buffer*         parent_;
+    bool            reader_;
+    iovec           iov_[2];
+
+public:
+    SizeType        capacity_;
+    SizeType        size_;
+};
+
+}
+
+#endif // _VECTORED_HANDLE_HPP__
@@ -0,0 +1,255 @@
+#ifndef _WAIT_STRATEGY_HPP__
+#define _WAIT_STRATEGY_HPP__
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "util/atomic_lock.hpp"
+#include "util/buffer_policies.hpp"
+
+namespace util
+{
+
+// Ways for one side of a buffer to block until the other side
+// has made progress. Each strategy is also the policy tag that
+// selects it, e.g. RingBuffer<T, S, N, SpscPolicy, FutexWait>.
+//
+// A buffer keeps one strategy object per direction. The waiting
+// side calls await(ready) with a probe of the buffer state; the
+// other side calls notify() after every commit or release. A
+// waiter only ever parks after announcing itself and re-checking
+// the probe, so notify() makes no system call unless somebody is
+// actually asleep, i.e. unless the commit took the buffer from
+// empty to non-empty (or the release from full to non-full).
+// It is not free, though: FutexWait and EventFdWait run a
+// seq_cst fence on every notify() before checking for a
+// waiter, which is what keeps a wake-up from being missed. On
+// x86 that is an mfence per commit and release.
+
+// Busy-waits with a pause; notify() is free. The default.
+class SpinWait
+{
+public:
+    template<typename Ready>
+    void await(Ready&& ready) noexcept
+    {
+        while (!ready())
+            cpu_relax();
+    }
+
+    void notify() noexcept
+    {}
+};
+
+// Spins for a while, then sleeps on a futex until notified.
+class FutexWait
+{
+public:
+    static constexpr std::uint32_t  k_Spin_Budget   = 1 << 10;
+
+    FutexWait() noexcept
+    {}
+
+    FutexWait(const FutexWait&)                 = delete;
+    FutexWait& operator=(const FutexWait&)      = delete;
+
+    template<typename Ready>
+    void await(Ready&& ready) noexcept
+    {
+        for (std::uint32_t spins = 0; spins < k_Spin_Budget; ++spins)
+        {
+            if (ready())
+                return;
+
+            cpu_relax();
+        }
+
+        for (;;)
+        {
+            std::uint32_t epoch = epoch_.load(std::memory_order_acquire);
+
+            sleepers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (ready())
+            {
+                sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+
+            park(epoch);
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    void notify() noexcept
+    {
+        // Pairs with the fence in await(): either the waiter sees
+        // the new state, or we see the waiter.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (LIKELY(sleepers_.load(std::memory_order_relaxed) == 0))
+            return;
+
+        epoch_.fetch_add(1, std::memory_order_release);
+        wake();
+    }
+
+private:
+    void park(std::uint32_t epoch) noexcept
+    {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch_), FUTEX_WAIT_PRIVATE, epoch, nullptr, nullptr, 0);
+#else
+        (void) epoch;
+        std::this_thread::yield();
+#endif
+    }
+
+    void wake() noexcept
+    {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch_), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    }
+
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex word must be a plain 32-bit integer");
+
+    std::atomic<std::uint32_t>  epoch_{0};
+    std::atomic<std::uint32_t>  sleepers_{0};
+};
+
+// Signals through an eventfd, so that a thread can wait on the
+// buffer together with sockets in one epoll set. To do so,
+// register fd() for EPOLLIN once and, before every epoll_wait,
+//
+//      if (!waiter.arm(ready))     // already ready, don't sleep
+//          ...
+//
+// then call drain() once the fd reports readable. await() does
+// the same with poll() for callers that only wait on the buffer.
+class EventFdWait
+{
+public:
+    static constexpr std::uint32_t  k_Spin_Budget   = 1 << 10;
+
+    EventFdWait()
+    {
+#if defined(__linux__)
+        fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (fd_ < 0)
+            throw std::system_error(errno, std::generic_category(), "eventfd");
+#else
+        throw std::system_error(ENOSYS, std::generic_category(), "EventFdWait");
+#endif
+    }
+
+    EventFdWait(const EventFdWait&)             = delete;
+    EventFdWait& operator=(const EventFdWait&)  = delete;
+
+    ~EventFdWait() noexcept
+    {
+#if defined(__linux__)
+        if (fd_ >= 0)
+            ::close(fd_);
+#endif
+    }
+
+    [[nodiscard]] decltype(auto) fd() const noexcept
+    {
+        return fd_;
+    }
+
+    // Requests a wake-up on the next notify(). Returns false, and
+    // leaves the fd alone, if ready() already holds.
+    template<typename Ready>
+    [[nodiscard]] bool arm(Ready&& ready) noexcept
+    {
+        armed_.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (ready())
+        {
+            armed_.store(0, std::memory_order_relaxed);
+            return false;
+        }
+
+        return true;
+    }
+
+    decltype(auto) drain() noexcept
+    {
+#if defined(__linux__)
+        std::uint64_t count;
+        while (::read(fd_, &count, sizeof(count)) == sizeof(count))
+            ;
+#endif
+    }
+
+    template<typename Ready>
+    void await(Ready&& ready) noexcept
+    {
+        for (std::uint32_t spins = 0; spins < k_Spin_Budget; ++spins)
+        {
+            if (ready())
+                return;
+
+            cpu_relax();
+        }
+
+        while (arm(ready))
+        {
+#if defined(__linux__)
+            pollfd descriptor {fd_, POLLIN, 0};
+            ::poll(&descriptor, 1, -1);
+#else
+            std::this_thread::yield();
+#endif
+            drain();
+        }
+    }
+
+    void notify() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (LIKELY(armed_.load(std::memory_order_relaxed) == 0))
+            return;
+
+        if (armed_.exchange(0, std::memory_order_relaxed) != 0)
+        {
+#if defined(__linux__)
+            std::uint64_t one = 1;
+            [[maybe_unused]] auto written = ::write(fd_, &one, sizeof(one));
+#endif
+        }
+    }
+
+private:
+    int                         fd_     = -1;
+    std::atomic<std::uint32_t>  armed_{0};
+};
+
+// The wait strategy named in a buffer's policy list; SpinWait
+// if there is none.
+template<typename... Policies>
+using wait_strategy_t   = std::conditional_t<has_policy_v<EventFdWait, Policies...>, EventFdWait,
+                          std::conditional_t<has_policy_v<FutexWait, Policies...>, FutexWait,
+                                             SpinWait>>;
+
+}
+
+#endif // _WAIT_STRATEGY_HPP__
@@ -5,7 +5,10 @@
 //==================================================================================================
 //
 #include "utf_utils.h"
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <vector>
 
 #if defined KEWB_PLATFORM_LINUX
     #include <emmintrin.h>
@@ -16,357 +19,274 @@
 #endif
 
 namespace uu {
-//- Static member data init.
+//--------------------------------------------------------------------------------------------------
+/// \brief  Generates the DFA lookup tables for a grammar of well-formed sequences.
+///
+/// \details
+///     This static member function builds, at compile time, the four arrays that make up a
+///     `LookupTables` object from a list of sequence rules, in the manner of Table 3-7 of the
+///     Unicode Standard.  It proceeds as follows:
+///       * Each octet is given a signature: the trailing-unit pattern of the rule it leads (if
+///         any), and the set of trailing-unit ranges that contain it.  Octets with the same
+///         signature share a character class; octets with an empty signature are ILL.  Classes
+///         are numbered in order of their first octet, after ILL.
+///       * Each distinct, non-empty suffix of a rule's trailing-unit ranges becomes a state.
+///         Suffixes made only of 80..BF ranges come first, shortest first; the others follow in
+///         rule order.
+///       * Transitions, first-unit descriptors, and first-octet masks follow directly.
+///
+///     Given the rules for strict UTF-8 in ascending lead order, the result is exactly the set
+///     of tables (and the class and state numbering) described by the `CharClass` and `State`
+///     enumerations.  A grammar needing more than 12 classes or 9 states fails to compile.
+///
+/// \param rules
+///     The rules of the grammar, in ascending order of leading unit.
+///
+/// \returns
+///     The generated lookup tables.
+//--------------------------------------------------------------------------------------------------
 //
-UtfUtils::LookupTables const    UtfUtils::smTables =
+template<size_t N>
+constexpr UtfUtils::LookupTables
+UtfUtils::MakeLookupTables(SequenceRule const (&rules)[N])
 {
-    //- Initialize the maFirstUnitTable member array.  This array implements a lookup table that
-    //  maps the first code unit of a sequence to: 1. a pre-masked value to start the computation
-    //  of the resulting code point; and, 2. the next state in the DFA for this code unit.
+    struct Suffix
+    {
+        int32_t     mRule;
+        int32_t     mPos;
+    };
+
+    LookupTables    tbl{};
+    Suffix          states[9]{};    //- The trailing-unit suffix awaited in each state
+    int32_t         nStates = 2;    //- BGN and ERR have no suffix
+    int32_t         leadKey[256]{}; //- Per octet: 1 + first rule with the same trailing units as its rule
+    uint32_t        trailSet[256]{};//- Per octet: the set of trailing-unit ranges containing it
+    int32_t         classLead[12]{};
+    uint32_t        classTrail[12]{};
+    int32_t         classOf[256]{};
+    int32_t         nClasses = 1;   //- ILL is always class 0
+
+    auto    contains = [](ByteRange r, int32_t unit)
+    {
+        return r.mLo <= unit  &&  unit <= r.mHi;
+    };
+    auto    sameSuffix = [&rules](int32_t r0, int32_t p0, int32_t r1, int32_t p1)
+    {
+        if (rules[r0].mTrailCount - p0 != rules[r1].mTrailCount - p1) return false;
+
+        for (;  p0 < rules[r0].mTrailCount;  ++p0, ++p1)
+        {
+            if (rules[r0].maTrail[p0].mLo != rules[r1].maTrail[p1].mLo  ||
+                rules[r0].maTrail[p0].mHi != rules[r1].maTrail[p1].mHi) return false;
+        }
+        return true;
+    };
+    auto    isPlain = [&rules](int32_t r, int32_t p)
+    {
+        for (;  p < rules[r].mTrailCount;  ++p)
+        {
+            if (rules[r].maTrail[p].mLo != 0x80  ||  rules[r].maTrail[p].mHi != 0xBF) return false;
+        }
+        return true;
+    };
+    auto    findState = [&](int32_t r, int32_t p)
+    {
+        for (int32_t s = 2;  s < nStates;  ++s)
+        {
+            if (sameSuffix(states[s].mRule, states[s].mPos, r, p)) return s;
+        }
+        return -1;
+    };
+    auto    addState = [&](int32_t r, int32_t p)
+    {
+        if (findState(r, p) >= 0) return;
+        if (nStates == 9) throw "grammar needs too many DFA states";
+        states[nStates++] = Suffix{r, p};
+    };
+
+    //- Enumerate the states: all-80..BF suffixes by increasing length, then the rest.
     //
+    for (int32_t len = 1;  len <= 3;  ++len)
     {
-        { 0x00, BGN },   //- 0x00
-        { 0x01, BGN },   //- 0x01
-        { 0x02, BGN },   //- 0x02
-        { 0x03, BGN },   //- 0x03
-        { 0x04, BGN },   //- 0x04
-        { 0x05, BGN },   //- 0x05
-        { 0x06, BGN },   //- 0x06
-        { 0x07, BGN },   //- 0x07
-        { 0x08, BGN },   //- 0x08
-        { 0x09, BGN },   //- 0x09
-        { 0x0A, BGN },   //- 0x0A
-        { 0x0B, BGN },   //- 0x0B
-        { 0x0C, BGN },   //- 0x0C
-        { 0x0D, BGN },   //- 0x0D
-        { 0x0E, BGN },   //- 0x0E
-        { 0x0F, BGN },   //- 0x0F
-
-        { 0x10, BGN },   //- 0x10
-        { 0x11, BGN },   //- 0x11
-        { 0x12, BGN },   //- 0x12
-        { 0x13, BGN },   //- 0x13
-        { 0x14, BGN },   //- 0x14
-        { 0x15, BGN },   //- 0x15
-        { 0x16, BGN },   //- 0x16
-        { 0x17, BGN },   //- 0x17
-        { 0x18, BGN },   //- 0x18
-        { 0x19, BGN },   //- 0x19
-        { 0x1A, BGN },   //- 0x1A
-        { 0x1B, BGN },   //- 0x1B
-        { 0x1C, BGN },   //- 0x1C
-        { 0x1D, BGN },   //- 0x1D
-        { 0x1E, BGN },   //- 0x1E
-        { 0x1F, BGN },   //- 0x1F
-
-        { 0x20, BGN },   //- 0x20
-        { 0x21, BGN },   //- 0x21
-        { 0x22, BGN },   //- 0x22
-        { 0x23, BGN },   //- 0x23
-        { 0x24, BGN },   //- 0x24
-        { 0x25, BGN },   //- 0x25
-        { 0x26, BGN },   //- 0x26
-        { 0x27, BGN },   //- 0x27
-        { 0x28, BGN },   //- 0x28
-        { 0x29, BGN },   //- 0x29
-        { 0x2A, BGN },   //- 0x2A
-        { 0x2B, BGN },   //- 0x2B
-        { 0x2C, BGN },   //- 0x2C
-        { 0x2D, BGN },   //- 0x2D
-        { 0x2E, BGN },   //- 0x2E
-        { 0x2F, BGN },   //- 0x2F
-
-        { 0x30, BGN },   //- 0x30
-        { 0x31, BGN },   //- 0x31
-        { 0x32, BGN },   //- 0x32
-        { 0x33, BGN },   //- 0x33
-        { 0x34, BGN },   //- 0x34
-        { 0x35, BGN },   //- 0x35
-        { 0x36, BGN },   //- 0x36
-        { 0x37, BGN },   //- 0x37
-        { 0x38, BGN },   //- 0x38
-        { 0x39, BGN },   //- 0x39
-        { 0x3A, BGN },   //- 0x3A
-        { 0x3B, BGN },   //- 0x3B
-        { 0x3C, BGN },   //- 0x3C
-        { 0x3D, BGN },   //- 0x3D
-        { 0x3E, BGN },   //- 0x3E
-        { 0x3F, BGN },   //- 0x3F
-
-        { 0x40, BGN },   //- 0x40
-        { 0x41, BGN },   //- 0x41
-        { 0x42, BGN },   //- 0x42
-        { 0x43, BGN },   //- 0x43
-        { 0x44, BGN },   //- 0x44
-        { 0x45, BGN },   //- 0x45
-        { 0x46, BGN },   //- 0x46
-        { 0x47, BGN },   //- 0x47
-        { 0x48, BGN },   //- 0x48
-        { 0x49, BGN },   //- 0x49
-        { 0x4A, BGN },   //- 0x4A
-        { 0x4B, BGN },   //- 0x4B
-        { 0x4C, BGN },   //- 0x4C
-        { 0x4D, BGN },   //- 0x4D
-        { 0x4E, BGN },   //- 0x4E
-        { 0x4F, BGN },   //- 0x4F
-
-        { 0x50, BGN },   //- 0x50
-        { 0x51, BGN },   //- 0x51
-        { 0x52, BGN },   //- 0x52
-        { 0x53, BGN },   //- 0x53
-        { 0x54, BGN },   //- 0x54
-        { 0x55, BGN },   //- 0x55
-        { 0x56, BGN },   //- 0x56
-        { 0x57, BGN },   //- 0x57
-        { 0x58, BGN },   //- 0x58
-        { 0x59, BGN },   //- 0x59
-        { 0x5A, BGN },   //- 0x5A
-        { 0x5B, BGN },   //- 0x5B
-        { 0x5C, BGN },   //- 0x5C
-        { 0x5D, BGN },   //- 0x5D
-        { 0x5E, BGN },   //- 0x5E
-        { 0x5F, BGN },   //- 0x5F
-
-        { 0x60, BGN },   //- 0x60
-        { 0x61, BGN },   //- 0x61
-        { 0x62, BGN },   //- 0x62
-        { 0x63, BGN },   //- 0x63
-        { 0x64, BGN },   //- 0x64
-        { 0x65, BGN },   //- 0x65
-        { 0x66, BGN },   //- 0x66
-        { 0x67, BGN },   //- 0x67
-        { 0x68, BGN },   //- 0x68
-        { 0x69, BGN },   //- 0x69
-        { 0x6A, BGN },   //- 0x6A
-        { 0x6B, BGN },   //- 0x6B
-        { 0x6C, BGN },   //- 0x6C
-        { 0x6D, BGN },   //- 0x6D
-        { 0x6E, BGN },   //- 0x6E
-        { 0x6F, BGN },   //- 0x6F
-
-        { 0x70, BGN },   //- 0x70
-        { 0x71, BGN },   //- 0x71
-        { 0x72, BGN },   //- 0x72
-        { 0x73, BGN },   //- 0x73
-        { 0x74, BGN },   //- 0x74
-        { 0x75, BGN },   //- 0x75
-        { 0x76, BGN },   //- 0x76
-        { 0x77, BGN },   //- 0x77
-        { 0x78, BGN },   //- 0x78
-        { 0x79, BGN },   //- 0x79
-        { 0x7A, BGN },   //- 0x7A
-        { 0x7B, BGN },   //- 0x7B
-        { 0x7C, BGN },   //- 0x7C
-        { 0x7D, BGN },   //- 0x7D
-        { 0x7E, BGN },   //- 0x7E
-        { 0x7F, BGN },   //- 0x7F
-
-        { 0x00, ERR },   //- 0x80
-        { 0x01, ERR },   //- 0x81
-        { 0x02, ERR },   //- 0x82
-        { 0x03, ERR },   //- 0x83
-        { 0x04, ERR },   //- 0x84
-        { 0x05, ERR },   //- 0x85
-        { 0x06, ERR },   //- 0x86
-        { 0x07, ERR },   //- 0x87
-        { 0x08, ERR },   //- 0x88
-        { 0x09, ERR },   //- 0x89
-        { 0x0A, ERR },   //- 0x8A
-        { 0x0B, ERR },   //- 0x8B
-        { 0x0C, ERR },   //- 0x8C
-        { 0x0D, ERR },   //- 0x8D
-        { 0x0E, ERR },   //- 0x8E
-        { 0x0F, ERR },   //- 0x8F
-
-        { 0x10, ERR },   //- 0x90
-        { 0x11, ERR },   //- 0x91
-        { 0x12, ERR },   //- 0x92
-        { 0x13, ERR },   //- 0x93
-        { 0x14, ERR },   //- 0x94
-        { 0x15, ERR },   //- 0x95
-        { 0x16, ERR },   //- 0x96
-        { 0x17, ERR },   //- 0x97
-        { 0x18, ERR },   //- 0x98
-        { 0x19, ERR },   //- 0x99
-        { 0x1A, ERR },   //- 0x9A
-        { 0x1B, ERR },   //- 0x9B
-        { 0x1C, ERR },   //- 0x9C
-        { 0x1D, ERR },   //- 0x9D
-        { 0x1E, ERR },   //- 0x9E
-        { 0x1F, ERR },   //- 0x9F
-
-        { 0x20, ERR },   //- 0xA0
-        { 0x21, ERR },   //- 0xA1
-        { 0x22, ERR },   //- 0xA2
-        { 0x23, ERR },   //- 0xA3
-        { 0x24, ERR },   //- 0xA4
-        { 0x25, ERR },   //- 0xA5
-        { 0x26, ERR },   //- 0xA6
-        { 0x27, ERR },   //- 0xA7
-        { 0x28, ERR },   //- 0xA8
-        { 0x29, ERR },   //- 0xA9
-        { 0x2A, ERR },   //- 0xAA
-        { 0x2B, ERR },   //- 0xAB
-        { 0x2C, ERR },   //- 0xAC
-        { 0x2D, ERR },   //- 0xAD
-        { 0x2E, ERR },   //- 0xAE
-        { 0x2F, ERR },   //- 0xAF
-
-        { 0x30, ERR },   //- 0xB0
-        { 0x31, ERR },   //- 0xB1
-        { 0x32, ERR },   //- 0xB2
-        { 0x33, ERR },   //- 0xB3
-        { 0x34, ERR },   //- 0xB4
-        { 0x35, ERR },   //- 0xB5
-        { 0x36, ERR },   //- 0xB6
-        { 0x37, ERR },   //- 0xB7
-        { 0x38, ERR },   //- 0xB8
-        { 0x39, ERR },   //- 0xB9
-        { 0x3A, ERR },   //- 0xBA
-        { 0x3B, ERR },   //- 0xBB
-        { 0x3C, ERR },   //- 0xBC
-        { 0x3D, ERR },   //- 0xBD
-        { 0x3E, ERR },   //- 0xBE
-        { 0x3F, ERR },   //- 0xBF
-
-        { 0xC0, ERR },   //- 0xC0
-        { 0xC1, ERR },   //- 0xC1
-        { 0x02, CS1 },   //- 0xC2
-        { 0x03, CS1 },   //- 0xC3
-        { 0x04, CS1 },   //- 0xC4
-        { 0x05, CS1 },   //- 0xC5
-        { 0x06, CS1 },   //- 0xC6
-        { 0x07, CS1 },   //- 0xC7
-        { 0x08, CS1 },   //- 0xC8
-        { 0x09, CS1 },   //- 0xC9
-        { 0x0A, CS1 },   //- 0xCA
-        { 0x0B, CS1 },   //- 0xCB
-        { 0x0C, CS1 },   //- 0xCC
-        { 0x0D, CS1 },   //- 0xCD
-        { 0x0E, CS1 },   //- 0xCE
-        { 0x0F, CS1 },   //- 0xCF
-
-        { 0x10, CS1 },   //- 0xD0
-        { 0x11, CS1 },   //- 0xD1
-        { 0x12, CS1 },   //- 0xD2
-        { 0x13, CS1 },   //- 0xD3
-        { 0x14, CS1 },   //- 0xD4
-        { 0x15, CS1 },   //- 0xD5
-        { 0x16, CS1 },   //- 0xD6
-        { 0x17, CS1 },   //- 0xD7
-        { 0x18, CS1 },   //- 0xD8
-        { 0x19, CS1 },   //- 0xD9
-        { 0x1A, CS1 },   //- 0xDA
-        { 0x1B, CS1 },   //- 0xDB
-        { 0x1C, CS1 },   //- 0xDC
-        { 0x1D, CS1 },   //- 0xDD
-        { 0x1E, CS1 },   //- 0xDE
-        { 0x1F, CS1 },   //- 0xDF
-
-        { 0x00, P3A },   //- 0xE0
-        { 0x01, CS2 },   //- 0xE1
-        { 0x02, CS2 },   //- 0xE2
-        { 0x03, CS2 },   //- 0xE3
-        { 0x04, CS2 },   //- 0xE4
-        { 0x05, CS2 },   //- 0xE5
-        { 0x06, CS2 },   //- 0xE6
-        { 0x07, CS2 },   //- 0xE7
-        { 0x08, CS2 },   //- 0xE8
-        { 0x09, CS2 },   //- 0xE9
-        { 0x0A, CS2 },   //- 0xEA
-        { 0x0B, CS2 },   //- 0xEB
-        { 0x0C, CS2 },   //- 0xEC
-        { 0x0D, P3B },   //- 0xED
-        { 0x0E, CS2 },   //- 0xEE
-        { 0x0F, CS2 },   //- 0xEF
-
-        { 0x00, P4A },   //- 0xF0
-        { 0x01, CS3 },   //- 0xF1
-        { 0x02, CS3 },   //- 0xF2
-        { 0x03, CS3 },   //- 0xF3
-        { 0x04, P4B },   //- 0xF4
-        { 0xF5, ERR },   //- 0xF5
-        { 0xF6, ERR },   //- 0xF6
-        { 0xF7, ERR },   //- 0xF7
-        { 0xF8, ERR },   //- 0xF8
-        { 0xF9, ERR },   //- 0xF9
-        { 0xFA, ERR },   //- 0xFA
-        { 0xFB, ERR },   //- 0xFB
-        { 0xFC, ERR },   //- 0xFC
-        { 0xFD, ERR },   //- 0xFD
-        { 0xFE, ERR },   //- 0xFE
-        { 0xFF, ERR },   //- 0xFF
-    },
-
-    //- Initialize the maOctetCategory member array.  This array implements a lookup table
-    //  that maps an input octet to a corresponding octet category.
+        for (int32_t r = 0;  r < (int32_t) N;  ++r)
+        {
+            int32_t     p = rules[r].mTrailCount - len;
+
+            if (p >= 0  &&  isPlain(r, p)) addState(r, p);
+        }
+    }
+    for (int32_t r = 0;  r < (int32_t) N;  ++r)
+    {
+        for (int32_t p = 0;  p < rules[r].mTrailCount;  ++p)
+        {
+            if (!isPlain(r, p)) addState(r, p);
+        }
+    }
+
+    //- Compute each octet's signature, and from those, the character classes.
     //
-    //   0    1    2    3    4    5    6    7    8    9    A    B    C    D    E    F
-    //============================================================================================
+    for (int32_t unit = 0;  unit < 256;  ++unit)
     {
-        ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, //- 00..0F
-        ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, //- 10..1F
-        ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, //- 20..2F
-        ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, //- 30..3F
-                                                                                        //
-        ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, //- 40..4F
-        ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, //- 50..5F
-        ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, //- 60..6F
-        ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC, //- 70..7F
-                                                                                        //
-        CR1, CR1, CR1, CR1, CR1, CR1, CR1, CR1, CR1, CR1, CR1, CR1, CR1, CR1, CR1, CR1, //- 80..8F
-        CR2, CR2, CR2, CR2, CR2, CR2, CR2, CR2, CR2, CR2, CR2, CR2, CR2, CR2, CR2, CR2, //- 90..9F
-        CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, //- A0..AF
-        CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, CR3, //- B0..BF
-                                                                                        //
-        ILL, ILL, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, //- C0..CF
-        L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, L2A, //- D0..DF
-        L3A, L3B, L3B, L3B, L3B, L3B, L3B, L3B, L3B, L3B, L3B, L3B, L3B, L3C, L3B, L3B, //- E0..EF
-        L4A, L4B, L4B, L4B, L4C, ILL, ILL, ILL, ILL, ILL, ILL, ILL, ILL, ILL, ILL, ILL, //- F0..FF
-    },
-
-    //- Initialize the maTransitions member array.  This array implements a lookup table that,
-    //  given the current DFA state and an input code unit, indicates the next DFA state. 
-	//
-    //  ILL  ASC  CR1  CR2  CR3  L2A  L3A  L3B  L3C  L4A  L4B  L4C  CLASS/STATE
-    //=========================================================================
+        int32_t     k = 0;
+
+        for (int32_t r = 0;  r < (int32_t) N;  ++r)
+        {
+            if (leadKey[unit] == 0  &&  contains(rules[r].mLead, unit))
+            {
+                for (int32_t q = 0;  q <= r;  ++q)
+                {
+                    if (sameSuffix(q, 0, r, 0)) { leadKey[unit] = q + 1;  break; }
+                }
+            }
+            for (int32_t p = 0;  p < rules[r].mTrailCount;  ++p, ++k)
+            {
+                if (contains(rules[r].maTrail[p], unit)) trailSet[unit] |= 1u << k;
+            }
+        }
+
+        if (leadKey[unit] != 0  ||  trailSet[unit] != 0)
+        {
+            int32_t     c = 1;
+
+            while (c < nClasses  &&  (classLead[c] != leadKey[unit]  ||  classTrail[c] != trailSet[unit])) ++c;
+
+            if (c == nClasses)
+            {
+                if (nClasses == 12) throw "grammar needs too many character classes";
+                classLead[c]  = leadKey[unit];
+                classTrail[c] = trailSet[unit];
+                ++nClasses;
+            }
+            classOf[unit] = c;
+        }
+    }
+
+    //- Fill in the transitions; unused rows and columns are left as errors.
+    //
+    for (int32_t i = 0;  i < 108;  ++i)
     {
-        err, END, err, err, err, CS1, P3A, CS2, P3B, P4A, CS3, P4B,	  //- BGN|END
-        err, err, err, err, err, err, err, err, err, err, err, err,   //- ERR
-																	  //
-        err, err, END, END, END, err, err, err, err, err, err, err,   //- CS1
-        err, err, CS1, CS1, CS1, err, err, err, err, err, err, err,   //- CS2
-        err, err, CS2, CS2, CS2, err, err, err, err, err, err, err,   //- CS3
-																	  //
-        err, err, err, err, CS1, err, err, err, err, err, err, err,   //- P3A
-        err, err, CS1, CS1, err, err, err, err, err, err, err, err,   //- P3B
-																	  //
-        err, err, err, CS2, CS2, err, err, err, err, err, err, err,   //- P4A
-        err, err, CS2, err, err, err, err, err, err, err, err, err,   //- P4B
-    },
-
-    //- Initialize the maFirstOctetMask member array.  This array implements a lookup table that
-    //  maps a character class to a mask that is applied to the first code unit in a sequence.
+        tbl.maTransitions[i] = ERR;
+    }
+    for (int32_t c = 1;  c < nClasses;  ++c)
+    {
+        int32_t     r = classLead[c] - 1;
+
+        if (r >= 0)
+        {
+            tbl.maTransitions[c] = (rules[r].mTrailCount == 0) ? END : (State)(12 * findState(r, 0));
+        }
+    }
+    for (int32_t s = 2;  s < nStates;  ++s)
+    {
+        int32_t     r = states[s].mRule;
+        int32_t     p = states[s].mPos;
+
+        for (int32_t unit = 0;  unit < 256;  ++unit)
+        {
+            if (classLead[classOf[unit]] == 0  &&  contains(rules[r].maTrail[p], unit))
+            {
+                tbl.maTransitions[12*s + classOf[unit]] =
+                    (p + 1 == rules[r].mTrailCount) ? END : (State)(12 * findState(r, p + 1));
+            }
+        }
+    }
+
+    //- Fill in the first-octet masks, the octet categories, and the first-unit descriptors.
     //
+    uint8_t const   leadMasks[4] = { 0x7F, 0x1F, 0x0F, 0x07 };
+
+    tbl.maFirstOctetMask[ILL] = 0xFF;
+    for (int32_t c = 1;  c < nClasses;  ++c)
+    {
+        tbl.maFirstOctetMask[c] = (classLead[c] != 0) ? leadMasks[rules[classLead[c] - 1].mTrailCount] : 0x3F;
+    }
+    for (int32_t unit = 0;  unit < 256;  ++unit)
     {
-        0xFF,   //- ILL - C0..C1, F5..FF    Illegal code unit
-                //
-        0x7F,   //- ASC - 00..7F            ASCII byte range
-                //
-        0x3F,   //- CR1 - 80..8F            Continuation range 1
-        0x3F,   //- CR2 - 90..9F            Continuation range 2
-        0x3F,   //- CR3 - A0..BF            Continuation range 3
-                //
-        0x1F,   //- L2A - C2..DF            Leading byte range 2A / 2-byte sequence
-                //
-        0x0F,   //- L3A - E0                Leading byte range 3A / 3-byte sequence
-        0x0F,   //- L3B - E1..EC, EE..EF    Leading byte range 3B / 3-byte sequence
-        0x0F,   //- L3C - ED                Leading byte range 3C / 3-byte sequence
-                //
-        0x07,   //- L4A - F0                Leading byte range 4A / 4-byte sequence
-        0x07,   //- L4B - F1..F3            Leading byte range 4B / 4-byte sequence
-        0x07,   //- L4C - F4                Leading byte range 4C / 4-byte sequence
-    },
+        tbl.maOctetCategory[unit]  = (CharClass) classOf[unit];
+        tbl.maFirstUnitTable[unit] = FirstUnitInfo
+        {
+            (char8_t)(unit & tbl.maFirstOctetMask[classOf[unit]]),
+            tbl.maTransitions[classOf[unit]]
+        };
+    }
+
+    return tbl;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Generates the DFA lookup tables for one of the built-in profiles.
+///
+/// \details
+///     The grammars below list the well-formed sequences of each variant.  The DFA works one
+///     code point at a time, so for CESU-8, Modified UTF-8, and WTF-8 it accepts every
+///     surrogate encoded as a three-unit sequence; the pairing rules of each variant are then
+///     applied by `JoinSurrogates`.
+//--------------------------------------------------------------------------------------------------
+//
+constexpr UtfUtils::LookupTables
+UtfUtils::MakeProfileTables(Profile prof)
+{
+    constexpr ByteRange     any = { 0x80, 0xBF };
+
+    constexpr SequenceRule  utf8[] =
+    {
+        { { 0x00, 0x7F }, 0, {} },
+        { { 0xC2, 0xDF }, 1, { any } },
+        { { 0xE0, 0xE0 }, 2, { { 0xA0, 0xBF }, any } },
+        { { 0xE1, 0xEC }, 2, { any, any } },
+        { { 0xED, 0xED }, 2, { { 0x80, 0x9F }, any } },
+        { { 0xEE, 0xEF }, 2, { any, any } },
+        { { 0xF0, 0xF0 }, 3, { { 0x90, 0xBF }, any, any } },
+        { { 0xF1, 0xF3 }, 3, { any, any, any } },
+        { { 0xF4, 0xF4 }, 3, { { 0x80, 0x8F }, any, any } },
+    };
+    constexpr SequenceRule  cesu8[] =
+    {
+        { { 0x00, 0x7F }, 0, {} },
+        { { 0xC2, 0xDF }, 1, { any } },
+        { { 0xE0, 0xE0 }, 2, { { 0xA0, 0xBF }, any } },
+        { { 0xE1, 0xEF }, 2, { any, any } },
+    };
+    constexpr SequenceRule  modifiedUtf8[] =
+    {
+        { { 0x01, 0x7F }, 0, {} },
+        { { 0xC0, 0xC0 }, 1, { { 0x80, 0x80 } } },
+        { { 0xC2, 0xDF }, 1, { any } },
+        { { 0xE0, 0xE0 }, 2, { { 0xA0, 0xBF }, any } },
+        { { 0xE1, 0xEF }, 2, { any, any } },
+    };
+    constexpr SequenceRule  wtf8[] =
+    {
+        { { 0x00, 0x7F }, 0, {} },
+        { { 0xC2, 0xDF }, 1, { any } },
+        { { 0xE0, 0xE0 }, 2, { { 0xA0, 0xBF }, any } },
+        { { 0xE1, 0xEF }, 2, { any, any } },
+        { { 0xF0, 0xF0 }, 3, { { 0x90, 0xBF }, any, any } },
+        { { 0xF1, 0xF3 }, 3, { any, any, any } },
+        { { 0xF4, 0xF4 }, 3, { { 0x80, 0x8F }, any, any } },
+    };
+
+    switch (prof)
+    {
+        case Profile::Cesu8:        return MakeLookupTables(cesu8);
+        case Profile::ModifiedUtf8: return MakeLookupTables(modifiedUtf8);
+        case Profile::Wtf8:         return MakeLookupTables(wtf8);
+        default:                    return MakeLookupTables(utf8);
+    }
+}
+
+//- Static member data init.  The strict UTF-8 tables used by all of the '*Convert' member
+//  functions, and the tables for each of the profiles accepted by 'ProfileConvert', are all
+//  generated at compile time.
+//
+constinit UtfUtils::LookupTables const  UtfUtils::smTables = MakeProfileTables(Profile::Utf8);
+
+constinit UtfUtils::LookupTables const  UtfUtils::smProfileTables[4] =
+{
+    MakeProfileTables(Profile::Utf8),
+    MakeProfileTables(Profile::Cesu8),
+    MakeProfileTables(Profile::ModifiedUtf8),
+    MakeProfileTables(Profile::Wtf8),
 };
 
 //- These are the human-readable names assigned to the code unit categories.
@@ -383,6 +303,141 @@ char const*     UtfUtils::smStateNames[9] =
     "BGN", "ERR", "CS1", "CS2", "CS3", "P3A", "P3B", "P4A", "P4B",
 };
 
+//- Initialize the smReverseTransitions member array.  This array implements a lookup table that,
+//  given the current reverse DFA state and the code unit preceding those already read, indicates
+//  the next reverse DFA state.  The accepted leading units for the R2* and R3* states are the
+//  same ones the forward DFA admits via its P3A/P3B and P4A/P4B states.
+//
+//  ILL  ASC  CR1  CR2  CR3  L2A  L3A  L3B  L3C  L4A  L4B  L4C  CLASS/STATE
+//=========================================================================
+UtfUtils::ReverseState const    UtfUtils::smReverseTransitions[132] =
+{
+    rer, REN, R1A, R1B, R1C, rer, rer, rer, rer, rer, rer, rer,   //- RBG|REN
+    rer, rer, rer, rer, rer, rer, rer, rer, rer, rer, rer, rer,   //- RER
+                                                                  //
+    rer, rer, R2A, R2B, R2C, REN, rer, rer, rer, rer, rer, rer,   //- R1A
+    rer, rer, R2A, R2B, R2C, REN, rer, rer, rer, rer, rer, rer,   //- R1B
+    rer, rer, R2A, R2B, R2C, REN, rer, rer, rer, rer, rer, rer,   //- R1C
+                                                                  //
+    rer, rer, R3A, R3B, R3C, rer, rer, REN, REN, rer, rer, rer,   //- R2A
+    rer, rer, R3A, R3B, R3C, rer, rer, REN, REN, rer, rer, rer,   //- R2B
+    rer, rer, R3A, R3B, R3C, rer, REN, REN, rer, rer, rer, rer,   //- R2C
+                                                                  //
+    rer, rer, rer, rer, rer, rer, rer, rer, rer, rer, REN, REN,   //- R3A
+    rer, rer, rer, rer, rer, rer, rer, rer, rer, REN, REN, rer,   //- R3B
+    rer, rer, rer, rer, rer, rer, rer, rer, rer, REN, REN, rer,   //- R3C
+};
+
+//- Initialize the candidate tables and dispatch pointers used by the 'TunedConvert' member
+//  functions.  The dispatch pointers start out referring to the calibrating converters, which
+//  replace them with the winning candidates on first use.
+//
+UtfUtils::TunedEntry<UtfUtils::Convert32Fn> const   UtfUtils::smCandidates32[6] =
+{
+    { &UtfUtils::BasicBigTableConvert,   "basic-big-table"   },
+    { &UtfUtils::FastBigTableConvert,    "fast-big-table"    },
+    { &UtfUtils::SseBigTableConvert,     "sse-big-table"     },
+    { &UtfUtils::BasicSmallTableConvert, "basic-small-table" },
+    { &UtfUtils::FastSmallTableConvert,  "fast-small-table"  },
+    { &UtfUtils::SseSmallTableConvert,   "sse-small-table"   },
+};
+
+UtfUtils::TunedEntry<UtfUtils::Convert16Fn> const   UtfUtils::smCandidates16[6] =
+{
+    { &UtfUtils::BasicBigTableConvert,   "basic-big-table"   },
+    { &UtfUtils::FastBigTableConvert,    "fast-big-table"    },
+    { &UtfUtils::SseBigTableConvert,     "sse-big-table"     },
+    { &UtfUtils::BasicSmallTableConvert, "basic-small-table" },
+    { &UtfUtils::FastSmallTableConvert,  "fast-small-table"  },
+    { &UtfUtils::SseSmallTableConvert,   "sse-small-table"   },
+};
+
+std::atomic<UtfUtils::Convert32Fn>  UtfUtils::smpTuned32{&UtfUtils::CalibrateAndConvert};
+std::atomic<UtfUtils::Convert16Fn>  UtfUtils::smpTuned16{&UtfUtils::CalibrateAndConvert};
+
+namespace {
+//- Upper bound on the number of code units timed during calibration, and the number of timed
+//  passes over the sample; the fastest pass of each candidate is the one compared.
+//
+size_t const    calibrationLimit  = 64u * 1024u;
+int const       calibrationPasses = 5;
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Returns the built-in calibration sample used when no caller sample is supplied.
+///
+/// \details
+///     The sample is mostly ASCII, with runs of two-, three-, and four-unit sequences mixed in,
+///     which approximates the markup-heavy multilingual text seen by most callers.
+//--------------------------------------------------------------------------------------------------
+//
+std::string const&
+GetDefaultSample()
+{
+    static std::string const    sample = []
+    {
+        char const* const   pieces[] =
+        {
+            "<p class=\"entry\">The quick brown fox jumps over the lazy dog; 0123456789.</p>\n",
+            "\xCE\xBA\xE1\xBD\xB9\xCF\x83\xCE\xBC\xCE\xB5 \xD0\xBF\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82, ",
+            "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E\xE3\x81\xAE\xE3\x83\x86\xE3\x82\xAD\xE3\x82\xB9\xE3\x83\x88 ",
+            "\xF0\x9F\x98\x80\xF0\x9F\x91\x8D\xF0\x9D\x84\x9E ",
+        };
+        std::string     text;
+
+        while (text.size() < calibrationLimit - 256u)
+        {
+            text += pieces[0];
+            text += pieces[0];
+            text += pieces[1];
+            text += pieces[0];
+            text += pieces[2];
+            text += pieces[3];
+        }
+        return text;
+    }();
+
+    return sample;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Times each candidate converter over a sample and returns the index of the fastest.
+//--------------------------------------------------------------------------------------------------
+//
+template<class CharT, class EntryT, size_t N>
+size_t
+PickFastest(EntryT const (&candidates)[N], char8_t const* pSmpl, char8_t const* pSmplEnd)
+{
+    using clock = std::chrono::steady_clock;
+
+    std::vector<CharT>  dst((size_t)(pSmplEnd - pSmpl) + 1u);
+    clock::duration     best = clock::duration::max();
+    size_t              pick = 0;
+
+    for (size_t i = 0;  i < N;  ++i)
+    {
+        clock::duration     fastest = clock::duration::max();
+
+        candidates[i].mpConvert(pSmpl, pSmplEnd, dst.data());       //- Warm caches and tables
+
+        for (int pass = 0;  pass < calibrationPasses;  ++pass)
+        {
+            clock::time_point   start = clock::now();
+            candidates[i].mpConvert(pSmpl, pSmplEnd, dst.data());
+            fastest = std::min(fastest, clock::now() - start);
+        }
+
+        if (fastest < best)
+        {
+            best = fastest;
+            pick = i;
+        }
+    }
+
+    return pick;
+}
+
+}   //- namespace
+
 //--------------------------------------------------------------------------------------------------
 /// \brief  Converts a sequence of UTF-8 code units to a sequence of UTF-32 code points.
 ///
@@ -458,6 +513,7 @@ UtfUtils::FastBigTableConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char3
         if (*pSrc < 0x80)
         {
             *pDst++ = *pSrc++;
+            CountAscii(1);
         }
         else
         {
@@ -527,6 +583,7 @@ UtfUtils::SseBigTableConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char32
         if (*pSrc < 0x80)
         {
             *pDst++ = *pSrc++;
+            CountAscii(1);
         }
         else
         {
@@ -619,6 +676,7 @@ UtfUtils::FastBigTableConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char1
         if (*pSrc < 0x80)
         {
             *pDst++ = *pSrc++;
+            CountAscii(1);
         }
         else
         {
@@ -688,6 +746,7 @@ UtfUtils::SseBigTableConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char16
         if (*pSrc < 0x80)
         {
             *pDst++ = *pSrc++;
+            CountAscii(1);
         }
         else
         {
@@ -780,6 +839,7 @@ UtfUtils::FastSmallTableConvert(char8_t const* pSrc, char8_t const* pSrcEnd, cha
         if (*pSrc < 0x80)
         {
             *pDst++ = *pSrc++;
+            CountAscii(1);
         }
         else
         {
@@ -849,6 +909,7 @@ UtfUtils::SseSmallTableConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char
         if (*pSrc < 0x80)
         {
             *pDst++ = *pSrc++;
+            CountAscii(1);
         }
         else
         {
@@ -941,6 +1002,7 @@ UtfUtils::FastSmallTableConvert(char8_t const* pSrc, char8_t const* pSrcEnd, cha
         if (*pSrc < 0x80)
         {
             *pDst++ = *pSrc++;
+            CountAscii(1);
         }
         else
         {
@@ -1010,6 +1072,7 @@ UtfUtils::SseSmallTableConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char
         if (*pSrc < 0x80)
         {
             *pDst++ = *pSrc++;
+            CountAscii(1);
         }
         else
         {
@@ -1109,6 +1172,345 @@ UtfUtils::ConvertWithTrace(char8_t const* pSrc, char8_t const* pSrcEnd, char16_t
     return pDst - pDstOrig;
 }
 
+//--------------------------------------------------------------------------------------------------
+/// \brief  Selects the fastest UTF-32 and UTF-16 converters for a representative sample.
+///
+/// \details
+///     This static member function times each of the '*BigTableConvert' and '*SmallTableConvert'
+///     member functions over (at most the first 64 KiB of) the given sample, and stores the
+///     fastest of each direction in the dispatch pointers used by `TunedConvert`.  If the sample
+///     is empty, a built-in mix of ASCII and multi-unit text is used instead.  It may be called
+///     at any time, from any thread; conversions already in progress are unaffected.
+///
+/// \param pSmpl
+///     A pointer defining the beginning of the sample range of code units.
+/// \param pSmplEnd
+///     A past-the-end pointer defining the end of the sample range.
+//--------------------------------------------------------------------------------------------------
+//
+void
+UtfUtils::Tune(char8_t const* pSmpl, char8_t const* pSmplEnd) noexcept
+{
+    if (pSmpl == pSmplEnd)
+    {
+        std::string const&  sample = GetDefaultSample();
+
+        pSmpl    = reinterpret_cast<char8_t const*>(sample.data());
+        pSmplEnd = pSmpl + sample.size();
+    }
+
+    //- Trim an oversized sample back to a sequence boundary, so that every candidate converts
+    //  the whole of it instead of stopping early at a truncated sequence.
+    //
+    if ((size_t)(pSmplEnd - pSmpl) > calibrationLimit)
+    {
+        pSmplEnd = pSmpl + calibrationLimit;
+
+        while (pSmplEnd > pSmpl  &&  (*pSmplEnd & 0xC0) == 0x80)
+        {
+            --pSmplEnd;
+        }
+    }
+
+    size_t const    pick32 = PickFastest<char32_t>(smCandidates32, pSmpl, pSmplEnd);
+    size_t const    pick16 = PickFastest<char16_t>(smCandidates16, pSmpl, pSmplEnd);
+
+    smpTuned32.store(smCandidates32[pick32].mpConvert, std::memory_order_relaxed);
+    smpTuned16.store(smCandidates16[pick16].mpConvert, std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Returns the name of the converter currently selected by `TunedConvert`.
+///
+/// \details
+///     The argument is used only to select the direction (UTF-32 or UTF-16); its value is
+///     ignored.  Before any calibration has been run the name returned is "untuned".
+//--------------------------------------------------------------------------------------------------
+//
+char const*
+UtfUtils::GetTunedName(char32_t const*) noexcept
+{
+    Convert32Fn     pFn = smpTuned32.load(std::memory_order_relaxed);
+
+    for (auto const& entry : smCandidates32)
+    {
+        if (entry.mpConvert == pFn) return entry.mpName;
+    }
+    return "untuned";
+}
+
+//--------------
+//
+char const*
+UtfUtils::GetTunedName(char16_t const*) noexcept
+{
+    Convert16Fn     pFn = smpTuned16.load(std::memory_order_relaxed);
+
+    for (auto const& entry : smCandidates16)
+    {
+        if (entry.mpConvert == pFn) return entry.mpName;
+    }
+    return "untuned";
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Calibrates on the built-in sample, then converts via the selected function.
+///
+/// \details
+///     These static member functions are the initial targets of the `TunedConvert` dispatch
+///     pointers.  Concurrent first calls may each run a calibration; the results are
+///     equivalent, and the last one stored wins.
+//--------------------------------------------------------------------------------------------------
+//
+ptrdiff_t
+UtfUtils::CalibrateAndConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char32_t* pDst) noexcept
+{
+    Tune(nullptr, nullptr);
+    return smpTuned32.load(std::memory_order_relaxed)(pSrc, pSrcEnd, pDst);
+}
+
+//--------------
+//
+ptrdiff_t
+UtfUtils::CalibrateAndConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char16_t* pDst) noexcept
+{
+    Tune(nullptr, nullptr);
+    return smpTuned16.load(std::memory_order_relaxed)(pSrc, pSrcEnd, pDst);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Converts a sequence of code units in a variant of UTF-8 to a sequence of UTF-32
+///         code points.
+///
+/// \details
+///     This static member function reads an input sequence of code units in the UTF-8 variant
+///     described by `prof`, and converts it to an output sequence of UTF-32 code points.  It
+///     performs conversion by traversing the DFA generated for that variant, and then applying
+///     the variant's surrogate rules:
+///       * CESU-8: a surrogate pair yields one supplementary code point; a lone surrogate is
+///         an error;
+///       * Modified UTF-8: a surrogate pair yields one supplementary code point; a lone
+///         surrogate is passed through, as a Java string may contain one;
+///       * WTF-8: a lone surrogate is passed through; a pair is an error, since WTF-8 requires
+///         supplementary code points to be encoded as four-unit sequences.
+///
+///     No ASCII short-circuit is applied, since Modified UTF-8 does not accept a raw 00 unit.
+///     For strict UTF-8, prefer `SseConvert`.
+///
+/// \param prof
+///     The variant of UTF-8 to be accepted.
+/// \param pSrc
+///     A non-null pointer defining the beginning of the code unit input range.
+/// \param pSrcEnd
+///     A non-null past-the-end pointer defining the end of the code unit input range.
+/// \param pDst
+///     A non-null pointer defining the beginning of the code point output range.
+///
+/// \returns
+///     If successful, the number of UTF-32 code points written; otherwise -1 is returned to
+///     indicate an error was encountered.
+//--------------------------------------------------------------------------------------------------
+//
+KEWB_ALIGN_FN std::ptrdiff_t
+UtfUtils::ProfileConvert(Profile prof, char8_t const* pSrc, char8_t const* pSrcEnd, char32_t* pDst) noexcept
+{
+    LookupTables const& tbl = smProfileTables[(int) prof];
+    char32_t*           pDstOrig = pDst;
+    char32_t            cdpt;
+
+    while (pSrc < pSrcEnd)
+    {
+        if (AdvanceWithProfile(tbl, pSrc, pSrcEnd, cdpt) != ERR  &&
+            ((cdpt & 0xFFFFF800) != 0xD800  ||  JoinSurrogates(prof, tbl, pSrc, pSrcEnd, cdpt)))
+        {
+            *pDst++ = cdpt;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    return pDst - pDstOrig;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Converts a sequence of code units in a variant of UTF-8 to a sequence of UTF-16
+///         code units.
+///
+/// \details
+///     This static member function behaves exactly as its UTF-32 counterpart above, writing
+///     each resulting code point as one or two UTF-16 code units.  A lone surrogate that the
+///     profile passes through is written as a single (unpaired) UTF-16 code unit.
+///
+/// \param prof
+///     The variant of UTF-8 to be accepted.
+/// \param pSrc
+///     A non-null pointer defining the beginning of the code unit input range.
+/// \param pSrcEnd
+///     A non-null past-the-end pointer defining the end of the code unit input range.
+/// \param pDst
+///     A non-null pointer defining the beginning of the code unit output range.
+///
+/// \returns
+///     If successful, the number of UTF-16 code units written; otherwise -1 is returned to
+///     indicate an error was encountered.
+//--------------------------------------------------------------------------------------------------
+//
+KEWB_ALIGN_FN std::ptrdiff_t
+UtfUtils::ProfileConvert(Profile prof, char8_t const* pSrc, char8_t const* pSrcEnd, char16_t* pDst) noexcept
+{
+    LookupTables const& tbl = smProfileTables[(int) prof];
+    char16_t*           pDstOrig = pDst;
+    char32_t            cdpt;
+
+    while (pSrc < pSrcEnd)
+    {
+        if (AdvanceWithProfile(tbl, pSrc, pSrcEnd, cdpt) != ERR  &&
+            ((cdpt & 0xFFFFF800) != 0xD800  ||  JoinSurrogates(prof, tbl, pSrc, pSrcEnd, cdpt)))
+        {
+            GetCodeUnits(cdpt, pDst);
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    return pDst - pDstOrig;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Applies a profile's surrogate rules to a decoded surrogate code point.
+///
+/// \details
+///     If `cdpt` is a high surrogate and the next sequence in the input decodes to a low
+///     surrogate, the pair is either joined into `cdpt` (consuming the second sequence) or
+///     rejected, according to the profile.  Otherwise `cdpt` is a lone surrogate, which is
+///     either accepted as-is or rejected.
+///
+/// \returns
+///     `true` if the surrogate (or the pair starting with it) is acceptable.
+//--------------------------------------------------------------------------------------------------
+//
+bool
+UtfUtils::JoinSurrogates
+(Profile prof, LookupTables const& tbl, char8_t const*& pSrc, char8_t const* pSrcEnd, char32_t& cdpt) noexcept
+{
+    char8_t const*  pNext = pSrc;
+    char32_t        next;
+
+    if (cdpt < 0xDC00  &&  pNext < pSrcEnd  &&
+        AdvanceWithProfile(tbl, pNext, pSrcEnd, next) != ERR  &&  (next & 0xFFFFFC00) == 0xDC00)
+    {
+        if (prof == Profile::Wtf8) return false;
+
+        cdpt = 0x10000 + ((cdpt - 0xD800) << 10) + (next - 0xDC00);
+        pSrc = pNext;
+        return true;
+    }
+
+    return prof != Profile::Cesu8;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Reports whether the DFA activity counters were compiled in.
+///
+/// \returns
+///     `true` if this file was built with KEWB_DFA_COUNTERS defined; otherwise `false`, in
+///     which case `GetDfaCounters` always returns a zeroed snapshot.
+//--------------------------------------------------------------------------------------------------
+//
+bool
+UtfUtils::HasDfaCounters() noexcept
+{
+    return smCountersEnabled;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Returns a snapshot of the calling thread's DFA activity counters.
+///
+/// \details
+///     Counts accumulate across all conversions performed by the calling thread since it
+///     started, or since its last call to `ResetDfaCounters`.  Code units consumed by the
+///     ASCII short-circuit paths are counted as one-unit sequences that pass through BGN,
+///     exactly as if they had been read by the DFA.  To profile a traffic mix across a pool
+///     of threads, have each thread take its own snapshot and sum them.
+//--------------------------------------------------------------------------------------------------
+//
+UtfUtils::DfaCounters
+UtfUtils::GetDfaCounters() noexcept
+{
+    return GetThreadCounters();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Zeroes the calling thread's DFA activity counters.
+//--------------------------------------------------------------------------------------------------
+//
+void
+UtfUtils::ResetDfaCounters() noexcept
+{
+    GetThreadCounters() = DfaCounters{};
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Steps backward over a given number of code points.
+///
+/// \details
+///     This static member function moves a pointer right-to-left by `count` code points.  It
+///     uses SSE intrinsics to count the leading (i.e., non-continuation) code units in each
+///     16-byte register, so that whole registers can be skipped when they do not contain the
+///     target position; the final register is resolved one code unit at a time.  No validation
+///     of the skipped sequences is performed; use `GetPrevCodePoint` for that.
+///
+/// \param pSrcBgn
+///     A non-null pointer defining the beginning of the code unit input range.
+/// \param pSrc
+///     A non-null pointer to the position from which to step backward.
+/// \param count
+///     The number of code points to step over.
+///
+/// \returns
+///     A pointer to the first code unit of the `count`-th code point preceding `pSrc`, or
+///     `pSrcBgn` if the range holds fewer than `count` code points.
+//--------------------------------------------------------------------------------------------------
+//
+KEWB_ALIGN_FN char8_t const*
+UtfUtils::SseRetreat(char8_t const* pSrcBgn, char8_t const* pSrc, ptrdiff_t count) noexcept
+{
+    __m128i     chunk, limit;
+    int32_t     mask, bits;
+
+    limit = _mm_set1_epi8((char) 0xBF);                     //- Highest continuation unit (signed -65)
+
+    while (count > 0  &&  (pSrc - pSrcBgn) >= (ptrdiff_t) sizeof(__m128i))
+    {
+        chunk = _mm_loadu_si128((__m128i const*) (pSrc - sizeof(__m128i)));
+        mask  = _mm_movemask_epi8(_mm_cmpgt_epi8(chunk, limit));   //- Flag ASCII and leading units
+        bits  = GetBitCount(mask);
+
+        //- If this register holds the target position, finish up one code unit at a time.
+        //
+        if (bits >= count)
+        {
+            break;
+        }
+        pSrc  -= sizeof(__m128i);
+        count -= bits;
+    }
+
+    while (count > 0  &&  pSrc > pSrcBgn)
+    {
+        if ((*--pSrc & 0xC0) != 0x80)
+        {
+            --count;
+        }
+    }
+
+    return pSrc;
+}
+
 //--------------------------------------------------------------------------------------------------
 /// \brief  Converts a sequence of ASCII UTF-8 code units to a sequence of UTF-32 code points.
 ///
@@ -1151,6 +1553,7 @@ UtfUtils::ConvertAsciiWithSse(char8_t const*& pSrc, char32_t*& pDst) noexcept
     {
         pSrc += 16;
         pDst += 16;
+        CountAscii(16);
     }
 
     //- Otherwise, the number of trailing (low-order) zero bits in the mask indicates the number
@@ -1160,6 +1563,7 @@ UtfUtils::ConvertAsciiWithSse(char8_t const*& pSrc, char32_t*& pDst) noexcept
         incr  = GetTrailingZeros(mask);
         pSrc += incr;
         pDst += incr;
+        CountAscii(incr);
     }
 }
 
@@ -1198,6 +1602,7 @@ UtfUtils::ConvertAsciiWithSse(char8_t const*& pSrc, char16_t*& pDst) noexcept
     {
         pSrc += 16;
         pDst += 16;
+        CountAscii(16);
     }
 
     //- Otherwise, the number of trailing (low-order) zero bits in the mask indicates the number
@@ -1207,6 +1612,7 @@ UtfUtils::ConvertAsciiWithSse(char8_t const*& pSrc, char16_t*& pDst) noexcept
         incr  = GetTrailingZeros(mask);
         pSrc += incr;
         pDst += incr;
+        CountAscii(incr);
     }
 }
 
@@ -1247,6 +1653,34 @@ UtfUtils::ConvertAsciiWithSse(char8_t const*& pSrc, char16_t*& pDst) noexcept
 
 #endif
 
+//--------------------------------------------------------------------------------------------------
+/// \brief  Returns the number of 1-bits in an integer.
+///
+/// \param x
+///     An `int32_t` value whose set bits are to be counted.
+///
+/// \returns
+///     the number of set bits, as an `int32_t`.
+//--------------------------------------------------------------------------------------------------
+//
+#if defined KEWB_PLATFORM_LINUX  &&  (defined KEWB_COMPILER_CLANG  ||  defined KEWB_COMPILER_GCC)
+
+    KEWB_FORCE_INLINE int32_t
+    UtfUtils::GetBitCount(int32_t x) noexcept
+    {
+        return  __builtin_popcount((unsigned int) x);
+    }
+
+#elif defined KEWB_PLATFORM_WINDOWS  &&  defined KEWB_COMPILER_MSVC
+
+    KEWB_FORCE_INLINE int32_t
+    UtfUtils::GetBitCount(int32_t x) noexcept
+    {
+        return (int32_t) __popcnt((unsigned int) x);
+    }
+
+#endif
+
 //--------------------------------------------------------------------------------------------------
 /// \brief  Prints state information for tracing versions of converters.
 ///
@@ -9,6 +9,7 @@
 #ifndef KEWB_UNICODE_UTILS_H_DEFINED
 #define KEWB_UNICODE_UTILS_H_DEFINED
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <string>
@@ -59,6 +60,16 @@
     #error "Unsupported combination of compiler and platform"
 #endif
 
+//- Define KEWB_DFA_COUNTERS to have the conversion member functions accumulate per-thread
+//  histograms of DFA activity (see UtfUtils::GetDfaCounters).  When it is not defined, the
+//  counting hooks compile to nothing.
+//
+#if defined KEWB_DFA_COUNTERS
+    #define KEWB_DFA_COUNTERS_ENABLED   true
+#else
+    #define KEWB_DFA_COUNTERS_ENABLED   false
+#endif
+
 namespace uu {
 //--------------------------------------------------------------------------------------------------
 /// \brief  Traits style class to perform conversions from UTF-8 to UTF-32/UTF-16
@@ -101,6 +112,11 @@ class UtfUtils
     static  uint32_t    GetCodeUnits(char32_t cdpt, char8_t*& pDst) noexcept;
     static  uint32_t    GetCodeUnits(char32_t cdpt, char16_t*& pDst) noexcept;
 
+    //- Right-to-left traversal; these member functions step backward from the end of a range.
+    //
+    static  bool            GetPrevCodePoint(char8_t const* pSrcBgn, char8_t const*& pSrc, char32_t& cdpt) noexcept;
+    static  char8_t const*  SseRetreat(char8_t const* pSrcBgn, char8_t const* pSrc, ptrdiff_t count) noexcept;
+
     //- Conversion to UTF-32/UTF-16 using fastest typical (lookup/computation on first code unit).
     //  These member functions are wrappers to the '*BigTableConvert' and '*SmallTableConvert'
     //  member functions declared further down.
@@ -113,6 +129,17 @@ class UtfUtils
     static  ptrdiff_t   FastConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char16_t* pDst) noexcept;
     static  ptrdiff_t   SseConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char16_t* pDst) noexcept;
 
+    //- Conversion to UTF-32/UTF-16 using whichever of the '*BigTableConvert' and
+    //  '*SmallTableConvert' member functions was fastest on a calibration sample.  The sample
+    //  is timed on first use, or when 'Tune' is called with a caller-supplied sample.
+    //
+    static  ptrdiff_t   TunedConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char32_t* pDst) noexcept;
+    static  ptrdiff_t   TunedConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char16_t* pDst) noexcept;
+
+    static  void        Tune(char8_t const* pSmpl, char8_t const* pSmplEnd) noexcept;
+    static  char const* GetTunedName(char32_t const*) noexcept;
+    static  char const* GetTunedName(char16_t const*) noexcept;
+
     //- Conversion to UTF-32/UTF-16 using pre-computed first code unit lookup table.
     //
     static  ptrdiff_t   BasicBigTableConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char32_t* pDst) noexcept;
@@ -139,6 +166,39 @@ class UtfUtils
     static  ptrdiff_t   ConvertWithTrace(char8_t const* pSrc, char8_t const* pSrcEnd, char32_t* pDst) noexcept;
     static  ptrdiff_t   ConvertWithTrace(char8_t const* pSrc, char8_t const* pSrcEnd, char16_t* pDst) noexcept;
 
+    //- Histograms of DFA activity accumulated by the calling thread.  State-indexed arrays are
+    //  indexed by the state's row number (i.e., its value divided by 12).
+    //
+    struct DfaCounters
+    {
+        uint64_t    maClassCounts[12];      //- Code units read, by character class
+        uint64_t    maStateCounts[9];       //- Transitions into each state
+        uint64_t    maLengthCounts[5];      //- Valid sequences, by length in code units
+        uint64_t    maErrorCounts[9];       //- Transitions into ERR, by the state they left
+        uint64_t    mTruncations;           //- Sequences cut short by the end of the input
+    };
+
+    static  bool        HasDfaCounters() noexcept;
+    static  DfaCounters GetDfaCounters() noexcept;
+    static  void        ResetDfaCounters() noexcept;
+
+    //- Variants of UTF-8 accepted by the 'ProfileConvert' member functions.
+    //
+    enum class Profile : uint8_t
+    {
+        Utf8         = 0,   //- Strict UTF-8, as accepted by all other conversion functions
+        Cesu8        = 1,   //- CESU-8; supplementary code points only as 3+3-unit surrogate pairs
+        ModifiedUtf8 = 2,   //- Java Modified UTF-8; CESU-8 plus C0 80 for U+0000, no raw 00
+        Wtf8         = 3,   //- WTF-8; UTF-8 plus lone (i.e., unpaired) surrogates
+    };
+
+    static  ptrdiff_t   ProfileConvert(Profile prof, char8_t const* pSrc, char8_t const* pSrcEnd, char32_t* pDst) noexcept;
+    static  ptrdiff_t   ProfileConvert(Profile prof, char8_t const* pSrc, char8_t const* pSrcEnd, char16_t* pDst) noexcept;
+
+    //- Resumable decoding of UTF-8 that arrives in arbitrary fragments.
+    //
+    class Decoder;
+
   private:
     enum CharClass : uint8_t
     {
@@ -180,6 +240,31 @@ class UtfUtils
         err = ERR,  //- For readability in the state transition table
     };
 
+    //- States of the reverse DFA, which reads a sequence from its last code unit back to its
+    //  first.  The letter suffix records the range of the most recently read (i.e., lowest
+    //  addressed) continuation unit, since that is the one the leading unit must agree with.
+    //
+    enum ReverseState : uint8_t
+    {
+        RBG = 0,    //- Start
+        RER = 12,   //- Invalid sequence
+                    //
+        R1A = 24,   //- One continuation unit read, lowest in 80..8F
+        R1B = 36,   //- One continuation unit read, lowest in 90..9F
+        R1C = 48,   //- One continuation unit read, lowest in A0..BF
+                    //
+        R2A = 60,   //- Two continuation units read, lowest in 80..8F
+        R2B = 72,   //- Two continuation units read, lowest in 90..9F
+        R2C = 84,   //- Two continuation units read, lowest in A0..BF
+                    //
+        R3A = 96,   //- Three continuation units read, lowest in 80..8F
+        R3B = 108,  //- Three continuation units read, lowest in 90..9F
+        R3C = 120,  //- Three continuation units read, lowest in A0..BF
+                    //
+        REN = RBG,  //- Start and End are the same state!
+        rer = RER,  //- For readability in the state transition table
+    };
+
     struct FirstUnitInfo
     {
         char8_t     mFirstOctet;
@@ -194,24 +279,269 @@ class UtfUtils
         std::uint8_t    maFirstOctetMask[16];
     };
 
+    //- The grammar from which the lookup tables are generated.  Each rule describes one form of
+    //  well-formed sequence: a range of leading units, and the range of each trailing unit.
+    //
+    struct ByteRange
+    {
+        uint8_t     mLo;
+        uint8_t     mHi;
+    };
+
+    struct SequenceRule
+    {
+        ByteRange   mLead;
+        uint8_t     mTrailCount;
+        ByteRange   maTrail[3];
+    };
+
+    using Convert32Fn = ptrdiff_t (*)(char8_t const*, char8_t const*, char32_t*) noexcept;
+    using Convert16Fn = ptrdiff_t (*)(char8_t const*, char8_t const*, char16_t*) noexcept;
+
+    template<class FnT>
+    struct TunedEntry
+    {
+        FnT             mpConvert;
+        char const*     mpName;
+    };
+
   private:
     static  LookupTables const  smTables;
+    static  LookupTables const  smProfileTables[4];
+    static  ReverseState const  smReverseTransitions[132];
     static  char const*         smClassNames[12];
     static  char const*         smStateNames[9];
 
+    static  TunedEntry<Convert32Fn> const   smCandidates32[6];
+    static  TunedEntry<Convert16Fn> const   smCandidates16[6];
+    static  std::atomic<Convert32Fn>        smpTuned32;
+    static  std::atomic<Convert16Fn>        smpTuned16;
+
   private:
+    template<size_t N>
+    static  constexpr LookupTables  MakeLookupTables(SequenceRule const (&rules)[N]);
+    static  constexpr LookupTables  MakeProfileTables(Profile prof);
+
     static  int32_t AdvanceWithBigTable(char8_t const*& pSrc, char8_t const* pSrcEnd, char32_t& cdpt) noexcept;
+    static  int32_t AdvanceWithProfile(LookupTables const& tbl, char8_t const*& pSrc, char8_t const* pSrcEnd, char32_t& cdpt) noexcept;
+    static  bool    JoinSurrogates(Profile prof, LookupTables const& tbl, char8_t const*& pSrc, char8_t const* pSrcEnd, char32_t& cdpt) noexcept;
     static  int32_t AdvanceWithSmallTable(char8_t const*& pSrc, char8_t const* pSrcEnd, char32_t& cdpt) noexcept;
     static  State   AdvanceWithTrace(char8_t const*& pSrc, char8_t const* pSrcEnd, char32_t& cdpt) noexcept;
+    static  int32_t RetreatWithTable(char8_t const* pSrcBgn, char8_t const*& pSrc, char32_t& cdpt) noexcept;
 
     static  void    ConvertAsciiWithSse(char8_t const*& pSrc, char32_t*& pDst) noexcept;
     static  int32_t ConvertAsciiWithSseX(char8_t const*& pSrc, char32_t*& pDst) noexcept;
     static  void    ConvertAsciiWithSse(char8_t const*& pSrc, char16_t*& pDst) noexcept;
     static  int32_t GetTrailingZeros(int32_t x) noexcept;
+    static  int32_t GetBitCount(int32_t x) noexcept;
+
+    static  ptrdiff_t   CalibrateAndConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char32_t* pDst) noexcept;
+    static  ptrdiff_t   CalibrateAndConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char16_t* pDst) noexcept;
 
     static  void    PrintStateData(State curr, CharClass type, uint32_t unit, State next);
+
+    static  constexpr bool  smCountersEnabled = KEWB_DFA_COUNTERS_ENABLED;
+
+    static  DfaCounters&    GetThreadCounters() noexcept;
+    static  void    CountFirstUnit(char32_t unit, int32_t next) noexcept;
+    static  void    CountTransition(int32_t curr, int32_t type, int32_t next) noexcept;
+    static  void    CountSequence(ptrdiff_t len) noexcept;
+    static  void    CountTruncation() noexcept;
+    static  void    CountAscii(ptrdiff_t len) noexcept;
 };
 
+//--------------------------------------------------------------------------------------------------
+/// \brief  Incremental decoder of UTF-8 to UTF-32, resumable at any code unit boundary.
+///
+/// \details
+///     This class holds the DFA state and the partially-accumulated code point between calls,
+///     so that a sequence split across input fragments is decoded without the caller having
+///     to buffer and re-scan it.  Input may be supplied one code unit at a time, or as a range
+///     of code units; the two may be freely interleaved.
+///
+///     When an invalid sequence is found, the decoder returns to its initial state and the
+///     error is reported.  The code unit that revealed it is consumed with it, unless that unit
+///     is not a continuation byte and so cannot belong to it; such a unit is left unconsumed to
+///     begin the next sequence.  Either way, decoding may then simply continue with the first
+///     code unit not consumed.
+//--------------------------------------------------------------------------------------------------
+//
+class UtfUtils::Decoder
+{
+  public:
+    struct Result
+    {
+        ptrdiff_t   mConsumed;      //- Code units read from the input range
+        ptrdiff_t   mWritten;       //- Code points written to the output range
+        bool        mError;         //- Whether decoding stopped at an invalid sequence
+    };
+
+  public:
+    Decoder() noexcept;
+
+    int32_t     Next(char8_t unit, char32_t& cdpt) noexcept;
+    Result      Next(char8_t const* pSrc, char8_t const* pSrcEnd, char32_t* pDst, char32_t* pDstEnd) noexcept;
+
+    bool        IsPending() const noexcept;
+    void        Reset() noexcept;
+
+  private:
+    char32_t    mCdpt;      //- The code point accumulated so far
+    int32_t     mState;     //- The current DFA state
+};
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Constructs a decoder in the initial state.
+//--------------------------------------------------------------------------------------------------
+//
+inline
+UtfUtils::Decoder::Decoder() noexcept
+:   mCdpt(0)
+,   mState(BGN)
+{}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Feeds one code unit to the decoder.
+///
+/// \param unit
+///     The next code unit of the input.
+/// \param cdpt
+///     A reference to a char32_t variable which receives the code point, if one is completed.
+///
+/// \returns
+///     1 if `unit` completed a code point, which has been written to `cdpt`; 0 if more code
+///     units are needed; -1 if `unit` revealed an invalid sequence and was consumed with it;
+///     or -2 if `unit` cut short the pending sequence, which is invalid, and was not consumed:
+///     it must be fed again.
+//--------------------------------------------------------------------------------------------------
+//
+KEWB_FORCE_INLINE int32_t
+UtfUtils::Decoder::Next(char8_t unit, char32_t& cdpt) noexcept
+{
+    if (mState == BGN)
+    {
+        FirstUnitInfo const&    info = smTables.maFirstUnitTable[unit];
+
+        mCdpt  = info.mFirstOctet;
+        mState = info.mNextState;
+    }
+    else if ((unit & 0xC0) != 0x80)
+    {
+        mState = BGN;
+        return -2;
+    }
+    else
+    {
+        mCdpt  = (mCdpt << 6) | (unit & 0x3F);
+        mState = smTables.maTransitions[mState + smTables.maOctetCategory[unit]];
+    }
+
+    if (mState == BGN)
+    {
+        cdpt = mCdpt;
+        return 1;
+    }
+    else if (mState == ERR)
+    {
+        mState = BGN;
+        return -1;
+    }
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Feeds a range of code units to the decoder.
+///
+/// \details
+///     This member function decodes code units until the input is exhausted, the output is
+///     full, or an invalid sequence is found.  A sequence left incomplete at the end of the
+///     input is held in the decoder and completed by the next call.  Complete sequences that
+///     lie wholly within the input are decoded with the same DFA traversal used by the
+///     '*BigTableConvert' member functions.
+///
+/// \param pSrc
+///     A non-null pointer defining the beginning of the code unit input range.
+/// \param pSrcEnd
+///     A non-null past-the-end pointer defining the end of the code unit input range.
+/// \param pDst
+///     A non-null pointer defining the beginning of the code point output range.
+/// \param pDstEnd
+///     A non-null past-the-end pointer defining the end of the code point output range.
+///
+/// \returns
+///     The number of code units consumed and code points written, and whether an invalid
+///     sequence was found; if so, it ends at the last code unit consumed, and the next code
+///     unit, if any, is where decoding resumes.
+//--------------------------------------------------------------------------------------------------
+//
+inline UtfUtils::Decoder::Result
+UtfUtils::Decoder::Next
+(char8_t const* pSrc, char8_t const* pSrcEnd, char32_t* pDst, char32_t* pDstEnd) noexcept
+{
+    char8_t const* const    pSrcOrig = pSrc;
+    char32_t* const         pDstOrig = pDst;
+    int32_t                 status;
+
+    while (pSrc < pSrcEnd  &&  pDst < pDstEnd)
+    {
+        //- At the start of a sequence with room for the longest one, no resumption is needed.
+        //
+        if (mState == BGN  &&  (pSrcEnd - pSrc) >= 4)
+        {
+            char8_t const* const    pSeq = pSrc;
+
+            if (AdvanceWithBigTable(pSrc, pSrcEnd, *pDst) == ERR)
+            {
+                //- A unit past the first that is not a continuation byte begins the next sequence.
+                //
+                if (pSrc - pSeq > 1  &&  (pSrc[-1] & 0xC0) != 0x80)
+                {
+                    --pSrc;
+                }
+                return Result{pSrc - pSrcOrig, pDst - pDstOrig, true};
+            }
+            ++pDst;
+        }
+        else if ((status = Next(*pSrc, *pDst)) != 0)
+        {
+            if (status < 0)
+            {
+                pSrc += (status == -1);
+                return Result{pSrc - pSrcOrig, pDst - pDstOrig, true};
+            }
+            ++pSrc;
+            ++pDst;
+        }
+        else
+        {
+            ++pSrc;
+        }
+    }
+
+    return Result{pSrc - pSrcOrig, pDst - pDstOrig, false};
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Reports whether the decoder holds an incomplete sequence.
+//--------------------------------------------------------------------------------------------------
+//
+inline bool
+UtfUtils::Decoder::IsPending() const noexcept
+{
+    return mState != BGN;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Discards any incomplete sequence and returns the decoder to its initial state.
+//--------------------------------------------------------------------------------------------------
+//
+inline void
+UtfUtils::Decoder::Reset() noexcept
+{
+    mCdpt  = 0;
+    mState = BGN;
+}
+
 //--------------------------------------------------------------------------------------------------
 /// \brief  Converts a sequence of UTF-8 code units to a UTF-32 code point.
 ///
@@ -232,6 +562,39 @@ UtfUtils::GetCodePoint(char8_t const* pSrc, char8_t const* const pSrcEnd, char32
     return (pSrc < pSrcEnd) ? (AdvanceWithSmallTable(pSrc, pSrcEnd, cdpt) != ERR) : false;
 }
 
+//--------------------------------------------------------------------------------------------------
+/// \brief  Converts the sequence of UTF-8 code units ending at a given position to a UTF-32
+///         code point.
+///
+/// \details
+///     This static member function reads backward from `pSrc` using the reverse DFA, so that
+///     callers can step right-to-left through a range of code units.  On success, `pSrc` is
+///     moved back to the first code unit of the decoded sequence; on failure it is unchanged.
+///
+/// \param pSrcBgn
+///     A non-null pointer defining the beginning of the code unit input range.
+/// \param pSrc
+///     A reference to a non-null past-the-end pointer for the sequence to be decoded.
+/// \param cdpt
+///     A mutable reference to a char32_t variable which will receive the code point.
+///
+/// \returns
+///     Boolean value `true` on success.
+//--------------------------------------------------------------------------------------------------
+//
+KEWB_FORCE_INLINE bool
+UtfUtils::GetPrevCodePoint(char8_t const* const pSrcBgn, char8_t const*& pSrc, char32_t& cdpt) noexcept
+{
+    char8_t const*  pPrev = pSrc;
+
+    if (pPrev > pSrcBgn  &&  RetreatWithTable(pSrcBgn, pPrev, cdpt) != RER)
+    {
+        pSrc = pPrev;
+        return true;
+    }
+    return false;
+}
+
 //--------------------------------------------------------------------------------------------------
 /// \brief  Converts a UTF-32 code point to a sequence of one to four UTF-8 code units.
 ///
@@ -438,6 +801,58 @@ UtfUtils::SseConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char16_t* pDst
     return SseBigTableConvert(pSrc, pSrcEnd, pDst);
 }
 
+//--------------------------------------------------------------------------------------------------
+/// \brief  Converts a sequence of UTF-8 code units to a sequence of UTF-32 code points.
+///
+/// \details
+///     This static member function forwards to the conversion function selected by the most
+///     recent calibration.  Until a calibration has been run, the dispatch pointer refers to
+///     a function that calibrates on a built-in sample before performing the conversion.
+///
+/// \param pSrc
+///     A non-null pointer defining the beginning of the code unit input range.
+/// \param pSrcEnd
+///     A non-null past-the-end pointer defining the end of the code unit input range.
+/// \param pDst
+///     A non-null pointer defining the beginning of the code point output range.
+///
+/// \returns
+///     If successful, the number of UTF-32 code points written; otherwise -1 is returned to
+///     indicate an error was encountered.
+//--------------------------------------------------------------------------------------------------
+//
+KEWB_FORCE_INLINE ptrdiff_t
+UtfUtils::TunedConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char32_t* pDst) noexcept
+{
+    return smpTuned32.load(std::memory_order_relaxed)(pSrc, pSrcEnd, pDst);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Converts a sequence of UTF-8 code units to a sequence of UTF-16 code units.
+///
+/// \details
+///     This static member function forwards to the conversion function selected by the most
+///     recent calibration.  Until a calibration has been run, the dispatch pointer refers to
+///     a function that calibrates on a built-in sample before performing the conversion.
+///
+/// \param pSrc
+///     A non-null pointer defining the beginning of the code unit input range.
+/// \param pSrcEnd
+///     A non-null past-the-end pointer defining the end of the code unit input range.
+/// \param pDst
+///     A non-null pointer defining the beginning of the code unit output range.
+///
+/// \returns
+///     If successful, the number of UTF-16 code units written; otherwise -1 is returned to
+///     indicate an error was encountered.
+//--------------------------------------------------------------------------------------------------
+//
+KEWB_FORCE_INLINE ptrdiff_t
+UtfUtils::TunedConvert(char8_t const* pSrc, char8_t const* pSrcEnd, char16_t* pDst) noexcept
+{
+    return smpTuned16.load(std::memory_order_relaxed)(pSrc, pSrcEnd, pDst);
+}
+
 //--------------------------------------------------------------------------------------------------
 /// \brief  Converts a sequence of UTF-8 code units to a UTF-32 code point.
 ///
@@ -466,9 +881,12 @@ UtfUtils::AdvanceWithBigTable(char8_t const*& pSrc, char8_t const* const pSrcEnd
     int32_t         type;   //- The current code unit's character class
     int32_t         curr;   //- The current DFA state
 
+    char8_t const* const    pSeq = pSrc;
+
     info = smTables.maFirstUnitTable[*pSrc++];              //- Look up the first code unit descriptor
     cdpt = info.mFirstOctet;                                //- From it, get the initial code point value
     curr = info.mNextState;                                 //- From it, get the second state
+    CountFirstUnit(*pSeq, curr);
 
     while (curr > ERR)
     {
@@ -477,13 +895,16 @@ UtfUtils::AdvanceWithBigTable(char8_t const*& pSrc, char8_t const* const pSrcEnd
             unit = *pSrc++;                                 //- Cache the current code unit
             cdpt = (cdpt << 6) | (unit & 0x3F);             //- Adjust code point with continuation bits
             type = smTables.maOctetCategory[unit];          //- Look up the code unit's character class
+            CountTransition(curr, type, smTables.maTransitions[curr + type]);
             curr = smTables.maTransitions[curr + type];     //- Look up the next state
         }
         else
         {
+            CountTruncation();
             return ERR;
         }
     }
+    if (curr == END) CountSequence(pSrc - pSeq);
     return curr;
 }
 
@@ -514,10 +935,13 @@ UtfUtils::AdvanceWithSmallTable(char8_t const*& pSrc, char8_t const* const pSrcE
     int32_t     type;   //- The current code unit's character class
     int32_t     curr;   //- The current DFA state
 
+    char8_t const* const    pSeq = pSrc;
+
     unit = *pSrc++;                                         //- Cache the first code unit
     type = smTables.maOctetCategory[unit];                  //- Get the first code unit's character class
     cdpt = smTables.maFirstOctetMask[type] & unit;          //- Apply the first octet mask 
     curr = smTables.maTransitions[type];                    //- Look up the second state
+    CountTransition(BGN, type, curr);
 
     while (curr > ERR)
     {
@@ -526,9 +950,63 @@ UtfUtils::AdvanceWithSmallTable(char8_t const*& pSrc, char8_t const* const pSrcE
             unit = *pSrc++;                                 //- Cache the current code unit
             cdpt = (cdpt << 6) | (unit & 0x3F);             //- Adjust code point with continuation bits
             type = smTables.maOctetCategory[unit];          //- Look up the code unit's character class
+            CountTransition(curr, type, smTables.maTransitions[curr + type]);
             curr = smTables.maTransitions[curr + type];     //- Look up the next state
         }
         else
+        {
+            CountTruncation();
+            return ERR;
+        }
+    }
+    if (curr == END) CountSequence(pSrc - pSeq);
+    return curr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Converts a sequence of UTF-8 code units to a UTF-32 code point.
+///
+/// \details
+///     This static member function is identical to `AdvanceWithBigTable`, except that it
+///     traverses the DFA described by the given lookup tables rather than `smTables`.  It is
+///     used by the `ProfileConvert` member functions to decode the variants of UTF-8.
+///
+/// \param tbl
+///     A reference to the lookup tables generated for the profile being decoded.
+/// \param pSrc
+///     A reference to a non-null pointer defining the beginning of the code unit input range.
+/// \param pSrcEnd
+///     A non-null past-the-end pointer defining the end of the code unit input range.
+/// \param cdpt
+///     A reference to the output code point.
+///
+/// \returns
+///     An internal flag describing the current DFA state.
+//--------------------------------------------------------------------------------------------------
+//
+KEWB_FORCE_INLINE int32_t
+UtfUtils::AdvanceWithProfile
+(LookupTables const& tbl, char8_t const*& pSrc, char8_t const* const pSrcEnd, char32_t& cdpt) noexcept
+{
+    FirstUnitInfo   info;   //- The descriptor for the first code unit
+    char32_t        unit;   //- The current UTF-8 code unit
+    int32_t         type;   //- The current code unit's character class
+    int32_t         curr;   //- The current DFA state
+
+    info = tbl.maFirstUnitTable[*pSrc++];                   //- Look up the first code unit descriptor
+    cdpt = info.mFirstOctet;                                //- From it, get the initial code point value
+    curr = info.mNextState;                                 //- From it, get the second state
+
+    while (curr > ERR)
+    {
+        if (pSrc < pSrcEnd)
+        {
+            unit = *pSrc++;                                 //- Cache the current code unit
+            cdpt = (cdpt << 6) | (unit & 0x3F);             //- Adjust code point with continuation bits
+            type = tbl.maOctetCategory[unit];               //- Look up the code unit's character class
+            curr = tbl.maTransitions[curr + type];          //- Look up the next state
+        }
+        else
         {
             return ERR;
         }
@@ -536,6 +1014,58 @@ UtfUtils::AdvanceWithSmallTable(char8_t const*& pSrc, char8_t const* const pSrcE
     return curr;
 }
 
+//--------------------------------------------------------------------------------------------------
+/// \brief  Converts a sequence of UTF-8 code units, read backward, to a UTF-32 code point.
+///
+/// \details
+///     This static member function reads input octets from the end of a sequence toward its
+///     beginning and uses them to traverse the reverse DFA.  Continuation units are consumed
+///     first and accumulated from the low-order bits upward; the leading unit is validated
+///     against the lowest continuation unit, exactly mirroring the checks of the forward DFA.
+///
+/// \param pSrcBgn
+///     A non-null pointer defining the beginning of the code unit input range.
+/// \param pSrc
+///     A reference to a non-null past-the-end pointer for the sequence to be decoded.
+/// \param cdpt
+///     A reference to the output code point.
+///
+/// \returns
+///     An internal flag describing the current reverse DFA state.
+//--------------------------------------------------------------------------------------------------
+//
+KEWB_FORCE_INLINE int32_t
+UtfUtils::RetreatWithTable(char8_t const* const pSrcBgn, char8_t const*& pSrc, char32_t& cdpt) noexcept
+{
+    char32_t    unit;   //- The current UTF-8 code unit
+    int32_t     type;   //- The current code unit's character class
+    int32_t     curr;   //- The current reverse DFA state
+    int32_t     shft;   //- The bit position of the current code unit's payload
+
+    unit = *--pSrc;                                         //- Cache the last code unit
+    type = smTables.maOctetCategory[unit];                  //- Get the last code unit's character class
+    cdpt = smTables.maFirstOctetMask[type] & unit;          //- Apply the octet mask
+    curr = smReverseTransitions[type];                      //- Look up the second state
+    shft = 6;
+
+    while (curr > RER)
+    {
+        if (pSrc > pSrcBgn)
+        {
+            unit  = *--pSrc;                                //- Cache the current code unit
+            type  = smTables.maOctetCategory[unit];         //- Look up the code unit's character class
+            cdpt |= (smTables.maFirstOctetMask[type] & unit) << shft;  //- Prepend its payload bits
+            curr  = smReverseTransitions[curr + type];      //- Look up the next state
+            shft += 6;
+        }
+        else
+        {
+            return RER;
+        }
+    }
+    return curr;
+}
+
 //--------------------------------------------------------------------------------------------------
 /// \brief  Converts a sequence of UTF-8 code units to a UTF-32 code point.
 ///
@@ -590,5 +1120,89 @@ UtfUtils::AdvanceWithTrace(char8_t const*& pSrc, char8_t const* pSrcEnd, char32_
     return next;
 }
 
+//--------------------------------------------------------------------------------------------------
+/// \brief  Returns the calling thread's DFA activity counters.
+///
+/// \details
+///     The counters live in thread-local storage, so the conversion member functions can
+///     update them without synchronization.  The counting member functions below are only
+///     called from the DFA traversal paths; each one compiles to nothing unless
+///     KEWB_DFA_COUNTERS is defined.
+//--------------------------------------------------------------------------------------------------
+//
+inline UtfUtils::DfaCounters&
+UtfUtils::GetThreadCounters() noexcept
+{
+    static thread_local DfaCounters     counters{};
+    return counters;
+}
+
+//--------------
+//
+KEWB_FORCE_INLINE void
+UtfUtils::CountFirstUnit(char32_t unit, int32_t next) noexcept
+{
+    if constexpr (smCountersEnabled)
+    {
+        CountTransition(BGN, smTables.maOctetCategory[unit], next);
+    }
+}
+
+//--------------
+//
+KEWB_FORCE_INLINE void
+UtfUtils::CountTransition(int32_t curr, int32_t type, int32_t next) noexcept
+{
+    if constexpr (smCountersEnabled)
+    {
+        DfaCounters&    counters = GetThreadCounters();
+
+        ++counters.maClassCounts[type];
+        ++counters.maStateCounts[next / 12];
+
+        if (next == ERR)
+        {
+            ++counters.maErrorCounts[curr / 12];
+        }
+    }
+}
+
+//--------------
+//
+KEWB_FORCE_INLINE void
+UtfUtils::CountSequence(ptrdiff_t len) noexcept
+{
+    if constexpr (smCountersEnabled)
+    {
+        ++GetThreadCounters().maLengthCounts[len];
+    }
+}
+
+//--------------
+//
+KEWB_FORCE_INLINE void
+UtfUtils::CountTruncation() noexcept
+{
+    if constexpr (smCountersEnabled)
+    {
+        ++GetThreadCounters().mTruncations;
+    }
+}
+
+//--------------
+//
+KEWB_FORCE_INLINE void
+UtfUtils::CountAscii(ptrdiff_t len) noexcept
+{
+    if constexpr (smCountersEnabled)
+    {
+        DfaCounters&    counters = GetThreadCounters();
+
+        counters.maClassCounts[ASC]  += (uint64_t) len;
+        counters.maStateCounts[0]    += (uint64_t) len;
+        counters.maLengthCounts[1]   += (uint64_t) len;
+    }
+}
+
 }       //- namespace uu
 #endif  //- KEWB_UNICODE_UTILS_H_DEFINED
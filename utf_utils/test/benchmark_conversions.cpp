@@ -0,0 +1,251 @@
+﻿#include "test_main.h"
+
+#include <map>
+
+#include <benchmark/benchmark.h>
+
+using namespace std;
+using namespace uu;
+
+namespace
+{
+//- One copy of each input file and of its iconv() conversions, shared by every engine that is
+//  benchmarked on it.  The iconv() results are the answers the other engines are checked against.
+//
+struct Corpus
+{
+    string      u8src;
+    u16string   u16answer;
+    u32string   u32answer;
+};
+
+string  dataDir;
+
+//--------------
+//
+template<class TestFn>
+TestFn
+FindConverter(vector<Converter<TestFn>> const& converters, char const* name)
+{
+    auto    it = find_if(converters.begin(), converters.end(),
+                         [name](Converter<TestFn> const& conv) { return strcmp(conv.name, name) == 0; });
+
+    return (it != converters.end()) ? it->fn : nullptr;
+}
+
+//--------------
+//
+Corpus const&
+LoadCorpus(string const& fname)
+{
+    static map<string, Corpus>  corpora;
+
+    auto    it = corpora.find(fname);
+
+    if (it == corpora.end())
+    {
+        Corpus  corpus;
+
+        corpus.u8src = LoadFile(MakeFilePath(dataDir, fname));
+
+        corpus.u16answer.resize(corpus.u8src.size(), 0);
+        corpus.u16answer.resize((size_t) FindConverter(Converters16(), "iconv")(corpus.u8src, 1, corpus.u16answer));
+
+        corpus.u32answer.resize(corpus.u8src.size(), 0);
+        corpus.u32answer.resize((size_t) FindConverter(Converters32(), "iconv")(corpus.u8src, 1, corpus.u32answer));
+
+        it = corpora.emplace(fname, std::move(corpus)).first;
+    }
+    return it->second;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// \brief  Google Benchmark fixture timing one engine on one input file
+///
+/// \details
+///     Each iteration performs one conversion with an engine from Converters16()/Converters32().
+///     The case is named "utf8_to_utf16/<file>/<engine>" (or utf8_to_utf32), so that
+///     --benchmark_filter can select by file, by engine or by both.
+//--------------------------------------------------------------------------------------------------
+//
+template<class CharT, class TestFn>
+class ConversionBenchmark : public benchmark::Fixture
+{
+  public:
+    ConversionBenchmark(char const* prefix, string const& fname, Converter<TestFn> const& conv);
+
+  protected:
+    void    BenchmarkCase(benchmark::State& state) override;
+
+  private:
+    using dst_string = basic_string<CharT>;
+
+    static dst_string const&    Answer(Corpus const& corpus);
+
+    string              mFile;
+    Converter<TestFn>   mConverter;
+};
+
+template<class CharT, class TestFn>
+ConversionBenchmark<CharT, TestFn>::ConversionBenchmark
+(char const* prefix, string const& fname, Converter<TestFn> const& conv)
+:   mFile(fname)
+,   mConverter(conv)
+{
+    SetName((string(prefix) + "/" + fname + "/" + conv.name).c_str());
+}
+
+template<class CharT, class TestFn>
+auto
+ConversionBenchmark<CharT, TestFn>::Answer(Corpus const& corpus) -> dst_string const&
+{
+    if constexpr (sizeof(CharT) == sizeof(char16_t))
+    {
+        return corpus.u16answer;
+    }
+    else
+    {
+        return corpus.u32answer;
+    }
+}
+
+template<class CharT, class TestFn>
+void
+ConversionBenchmark<CharT, TestFn>::BenchmarkCase(benchmark::State& state)
+{
+    Corpus const&   corpus = LoadCorpus(mFile);
+    string const&   u8src  = corpus.u8src;
+    ptrdiff_t       dstLen = 0;
+
+    if (u8src.size() == 0)
+    {
+        state.SkipWithError("file is non-existent or empty");
+        return;
+    }
+
+    //- Same sizing as TestOneConversion16/32.
+    //
+    dst_string  dst((sizeof(CharT) == sizeof(char16_t) ? 4 : 1) * u8src.size(), 0u);
+
+    if (mConverter.tuned)
+    {
+        //- Calibrate on this file's contents outside the timed region.
+        //
+        UtfUtils::Tune((char8_t const*) u8src.data(), (char8_t const*) u8src.data() + u8src.size());
+        state.SetLabel(UtfUtils::GetTunedName((CharT const*) nullptr));
+    }
+
+    for (auto _ : state)
+    {
+        dstLen = mConverter.fn(u8src, 1, dst);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+
+    dst.resize((dstLen >= 0) ? (size_t) dstLen : 0u);
+
+    if (dst != Answer(corpus))
+    {
+        state.SkipWithError("result differs from iconv()");
+        return;
+    }
+
+    state.SetBytesProcessed((int64_t) (state.iterations() * u8src.size()));
+    state.SetItemsProcessed((int64_t) (state.iterations() * dst.size()));
+    state.counters["input_bytes"] = (double) u8src.size();
+}
+
+//--------------
+//
+template<class CharT, class TestFn>
+void
+RegisterConversions(char const* prefix, vector<Converter<TestFn>> const& converters, file_list const& files)
+{
+    for (auto const& fname : files)
+    {
+        for (auto const& conv : converters)
+        {
+            benchmark::internal::RegisterBenchmarkInternal(new ConversionBenchmark<CharT, TestFn>(prefix, fname, conv));
+        }
+    }
+}
+
+}   //- namespace
+
+//--------------
+//
+void
+PrintHelp()
+{
+    printf("usage: utf_utils_benchmark [option]... [--benchmark_...]...\n");
+    printf("  -h              Print help\n");
+    printf("  -dd <data_dir>  Specify directory containing test input files\n");
+    printf("\n");
+    printf("Runs every engine of utf_utils_test -t16/-t32 (including the -tct table variants) on every\n");
+    printf("test file.  Unless overridden, each case is repeated 5 times, only the mean, median,\n");
+    printf("stddev and cv are reported, and the results are also written as JSON to\n");
+    printf("utf_utils_benchmark.json.  Google Benchmark's own flags are listed by --help.\n");
+}
+
+//--------------
+//
+int main(int argc, char* argv[])
+{
+    //- Defaults go first, so that the same flags given on the command line override them.
+    //
+    vector<string>  args
+    {
+        argv[0],
+        "--benchmark_repetitions=5",
+        "--benchmark_report_aggregates_only=true",
+        "--benchmark_out=utf_utils_benchmark.json",
+        "--benchmark_out_format=json"
+    };
+    file_list       files;
+
+    for (int i = 1;  i < argc;  ++i)
+    {
+        string  arg(argv[i]);
+
+        if (arg == "-dd")
+        {
+            if (++i < argc)
+            {
+                dataDir = argv[i];
+            }
+        }
+        else if (arg == "-h")
+        {
+            PrintHelp();
+            return 0;
+        }
+        else
+        {
+            args.push_back(arg);
+        }
+    }
+
+    vector<char*>   argp;
+
+    for (auto& arg : args)
+    {
+        argp.push_back(&arg[0]);
+    }
+
+    int     argn = (int) argp.size();
+
+    benchmark::Initialize(&argn, argp.data());
+
+    if (benchmark::ReportUnrecognizedArguments(argn, argp.data()))
+    {
+        return 1;
+    }
+
+    MakeFileList(files);
+    RegisterConversions<char16_t>("utf8_to_utf16", Converters16(), files);
+    RegisterConversions<char32_t>("utf8_to_utf32", Converters32(), files);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
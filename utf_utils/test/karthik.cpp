@@ -1,5 +1,39 @@
+#include <cstdio>
+
 #include "karthik.h"
 
+namespace
+{
+template<typename UnicodeLL>
+void
+printPhaseStats(char const* name)
+{
+    utf::PhaseStats stats   = UnicodeLL::phase_stats();
+    double          total   = 0.0;
+
+    if (stats.calls_ == 0 || stats.units_ == 0)
+        return;
+
+    for (auto cycles : stats.cycles_)
+        total += (double) cycles;
+
+    auto share = [&stats, total](utf::Phase phase)
+        {
+            return (total > 0.0) ? 100.0 * (double) stats.cycles_[util::to_index(phase)] / total : 0.0;
+        };
+
+    printf("    %s phases: %.2f cycles/unit: magnify %.0f%%, verify %.0f%%, modify %.0f%%, qualify %.0f%%\n",
+            name, total / (double) stats.units_,
+            share(utf::Phase::Magnify), share(utf::Phase::Verify), share(utf::Phase::Modify), share(utf::Phase::Qualify));
+    printf("    %s blocks: magnify %llu ascii / %llu multibyte, modify %llu ascii / %llu multibyte\n",
+            name,
+            (unsigned long long) stats.magnify_ascii_blocks_, (unsigned long long) stats.magnify_multibyte_blocks_,
+            (unsigned long long) stats.modify_ascii_blocks_, (unsigned long long) stats.modify_multibyte_blocks_);
+
+    UnicodeLL::reset_phase_stats();
+}
+}
+
 ptrdiff_t
 unifyUtf32(char8_t const* src, size_t srcBytes, char32_t* dst)
 {
@@ -21,3 +55,15 @@ unifyUtf16(char8_t const* src, size_t srcBytes, char16_t* dst)
 
     return d - dst;
 }
+
+void
+printUnifyPhaseStats16()
+{
+    printPhaseStats<utf::UniFy<char16_t, char8_t, false, false>>("Karthik");
+}
+
+void
+printUnifyPhaseStats32()
+{
+    printPhaseStats<utf::UniFy<char32_t, char8_t, false, false>>("Karthik");
+}
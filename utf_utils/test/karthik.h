@@ -2,3 +2,7 @@
 
 ptrdiff_t   unifyUtf32(char8_t const* src, size_t srcBytes, char32_t* dst);
 ptrdiff_t   unifyUtf16(char8_t const* src, size_t srcBytes, char16_t* dst);
+
+//- Print and reset UniFy's phase timings; nothing unless built with UTF_UNIFY_PHASE_STATS.
+void        printUnifyPhaseStats16();
+void        printUnifyPhaseStats32();
@@ -140,3 +140,432 @@ TestRoundTripping()
     if (errors == 0) printf("    ... no errors found\n");
 }
 
+
+//--------------
+//
+void
+TestReverseDecoding()
+{
+    vector<array<uchar,8>>    badSeqs =
+    {
+        { { 0xC0, 0xAF } },
+        { { 0xE0, 0x9F, 0xBF } },
+        { { 0xED, 0xA0, 0x80 } },
+        { { 0xF0, 0x8F, 0xBF, 0xBF } },
+        { { 0xF4, 0x90, 0x80, 0x80 } },
+        { { 0x80, 0x80, 0x80, 0x80 } },
+        { { 0xE2, 0x82 } },
+        { { 0xF0, 0x9F, 0x98 } },
+    };
+    size_t const    badLens[] = { 2, 3, 3, 4, 4, 4, 2, 3 };
+
+    char8_t         buf[8];
+    char8_t const*  pSrc;
+    char32_t        tstCdpt;
+    size_t          len;
+    size_t          errors = 0;
+
+    printf("\ntesting reverse decoding...\n");
+
+    //- Every scalar value, encoded after a leading ASCII unit, must decode right-to-left back to
+    //  itself and leave the pointer at the first code unit of the sequence.
+    //
+    for (char32_t cdpt = 0;  cdpt < 0x110000;  ++cdpt)
+    {
+        if (0xD800 <= cdpt  &&  cdpt <= 0xDFFF)  continue;
+
+        char8_t*    pDst = &buf[1];
+
+        buf[0] = 'x';
+        len    = UtfUtils::GetCodeUnits(cdpt, pDst);
+        pSrc   = &buf[1] + len;
+
+        if (!UtfUtils::GetPrevCodePoint(&buf[0], pSrc, tstCdpt)  ||  tstCdpt != cdpt  ||  pSrc != &buf[1])
+        {
+            printf("reverse decoding error at code point 0x%X\n", (uint32_t) cdpt);
+            ++errors;
+        }
+    }
+
+    //- Ill-formed and truncated sequences must be rejected without moving the pointer.
+    //
+    for (size_t i = 0;  i < badSeqs.size();  ++i)
+    {
+        char8_t const*  pBgn = reinterpret_cast<char8_t const*>(badSeqs[i].data());
+        char8_t const*  pEnd = pBgn + badLens[i];
+
+        pSrc = pEnd;
+        if (UtfUtils::GetPrevCodePoint(pBgn, pSrc, tstCdpt)  ||  pSrc != pEnd)
+        {
+            printf("reverse decoding error: octet sequence %d accepted\n", (int) i);
+            ++errors;
+        }
+    }
+
+    //- Stepping back N code points with SseRetreat must land on the N-th leading code unit
+    //  counted from the end, for every N.
+    //
+    string                  sample;
+    vector<char8_t const*>  starts;
+
+    for (int i = 0;  i < 16;  ++i)
+    {
+        sample += reinterpret_cast<char const*>(u8"kosme κόσμε 💩 ∀x∈ℝ ");
+    }
+
+    char8_t const*  pBgn = reinterpret_cast<char8_t const*>(sample.data());
+    char8_t const*  pEnd = pBgn + sample.size();
+
+    for (pSrc = pBgn;  pSrc < pEnd;  ++pSrc)
+    {
+        if ((*pSrc & 0xC0) != 0x80)
+        {
+            starts.push_back(pSrc);
+        }
+    }
+
+    for (size_t n = 0;  n <= starts.size() + 1;  ++n)
+    {
+        char8_t const*  pExp = (n <= starts.size()) ? (n == 0 ? pEnd : starts[starts.size() - n]) : pBgn;
+
+        if (UtfUtils::SseRetreat(pBgn, pEnd, (ptrdiff_t) n) != pExp)
+        {
+            printf("retreat error stepping back %d code points\n", (int) n);
+            ++errors;
+        }
+    }
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
+
+//--------------
+//
+void
+TestTunedConversion()
+{
+    string      sample;
+    u32string   dst32, ref32;
+    u16string   dst16, ref16;
+    size_t      errors = 0;
+
+    printf("\ntesting tuned conversions...\n");
+
+    for (int i = 0;  i < 64;  ++i)
+    {
+        sample += reinterpret_cast<char const*>(u8"kosme κόσμε 日本語 💩 ∀x∈ℝ plain ascii text ");
+    }
+
+    char8_t const*  pSrc = reinterpret_cast<char8_t const*>(sample.data());
+    char8_t const*  pEnd = pSrc + sample.size();
+
+    ref32.resize(sample.size());
+    ref16.resize(sample.size());
+    ref32.resize((size_t) UtfUtils::BasicBigTableConvert(pSrc, pEnd, &ref32[0]));
+    ref16.resize((size_t) UtfUtils::BasicBigTableConvert(pSrc, pEnd, &ref16[0]));
+
+    //- The first pass goes through the calibrate-on-first-use path; the second uses the
+    //  selection made by an explicit calibration on the same sample.
+    //
+    for (int pass = 0;  pass < 2;  ++pass)
+    {
+        dst32.assign(sample.size(), 0);
+        dst16.assign(sample.size(), 0);
+        dst32.resize((size_t) UtfUtils::TunedConvert(pSrc, pEnd, &dst32[0]));
+        dst16.resize((size_t) UtfUtils::TunedConvert(pSrc, pEnd, &dst16[0]));
+
+        if (dst32 != ref32)
+        {
+            printf("tuned UTF-32 conversion (%s) differs\n", UtfUtils::GetTunedName(dst32.data()));
+            ++errors;
+        }
+        if (dst16 != ref16)
+        {
+            printf("tuned UTF-16 conversion (%s) differs\n", UtfUtils::GetTunedName(dst16.data()));
+            ++errors;
+        }
+        UtfUtils::Tune(pSrc, pEnd);
+    }
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
+
+//--------------
+//
+void
+TestDfaCounters()
+{
+    size_t  errors = 0;
+
+    printf("\ntesting DFA counters (%s)...\n", UtfUtils::HasDfaCounters() ? "enabled" : "disabled");
+
+    auto    convert = [](char const* pText, auto fn)
+    {
+        char8_t const*  pSrc = reinterpret_cast<char8_t const*>(pText);
+        u32string       dst(strlen(pText) + 1, 0);
+
+        fn(pSrc, pSrc + strlen(pText), &dst[0]);
+    };
+    auto    basic = [](char8_t const* pSrc, char8_t const* pEnd, char32_t* pDst)
+                        { return UtfUtils::BasicSmallTableConvert(pSrc, pEnd, pDst); };
+    auto    sse   = [](char8_t const* pSrc, char8_t const* pEnd, char32_t* pDst)
+                        { return UtfUtils::SseBigTableConvert(pSrc, pEnd, pDst); };
+
+    //- One sequence of each length, followed by an over-long sequence (rejected in P3A) and,
+    //  separately, a truncated one.
+    //
+    UtfUtils::ResetDfaCounters();
+    convert("a\xCE\xBA\xE6\x97\xA5\xF0\x9F\x92\xA9", basic);
+    convert("\xE0\x80\xAF", basic);
+    convert("\xE6\x97", basic);
+
+    UtfUtils::DfaCounters   counts = UtfUtils::GetDfaCounters();
+    uint64_t                units  = 0;
+
+    for (auto n : counts.maClassCounts) units += n;
+
+    if (UtfUtils::HasDfaCounters())
+    {
+        if (units != 14  ||  counts.maClassCounts[1] != 1)
+        {
+            printf("class histogram is wrong (%d units)\n", (int) units);
+            ++errors;
+        }
+        for (int len = 1;  len <= 4;  ++len)
+        {
+            if (counts.maLengthCounts[len] != 1)
+            {
+                printf("length histogram is wrong for %d-unit sequences\n", len);
+                ++errors;
+            }
+        }
+        if (counts.maErrorCounts[5] != 1  ||  counts.maStateCounts[1] != 1  ||  counts.mTruncations != 1)
+        {
+            printf("error counts are wrong\n");
+            ++errors;
+        }
+    }
+    else if (units != 0  ||  counts.mTruncations != 0)
+    {
+        printf("counters changed while disabled\n");
+        ++errors;
+    }
+
+    //- The SSE converter's ASCII short-circuit must be accounted for exactly as the plain DFA
+    //  traversal would account for it.
+    //
+    string  sample;
+
+    for (int i = 0;  i < 32;  ++i)
+    {
+        sample += reinterpret_cast<char const*>(u8"plain ascii text κόσμε 日本語 💩 ");
+    }
+
+    UtfUtils::ResetDfaCounters();
+    convert(sample.c_str(), basic);
+    UtfUtils::DfaCounters   basicCounts = UtfUtils::GetDfaCounters();
+
+    UtfUtils::ResetDfaCounters();
+    convert(sample.c_str(), sse);
+    UtfUtils::DfaCounters   sseCounts = UtfUtils::GetDfaCounters();
+
+    if (memcmp(&basicCounts, &sseCounts, sizeof(UtfUtils::DfaCounters)) != 0)
+    {
+        printf("SSE and basic conversions disagree\n");
+        ++errors;
+    }
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
+
+//--------------
+//
+void
+TestProfiles()
+{
+    using prof_t = UtfUtils::Profile;
+
+    struct Case
+    {
+        prof_t      prof;
+        char const* pText;
+        ptrdiff_t   len32;      //- Expected UTF-32 length, or -1 if the input must be rejected
+        char32_t    last;       //- Expected last code point
+    };
+
+    Case const  cases[] =
+    {
+        { prof_t::Utf8,         "a\xF0\x9F\x92\xA9",            2,  0x1F4A9 },
+        { prof_t::Utf8,         "\xED\xA0\xBD",                 -1, 0       },
+        { prof_t::Utf8,         "\xC0\x80",                     -1, 0       },
+        { prof_t::Cesu8,        "a\xED\xA0\xBD\xED\xB2\xA9",    2,  0x1F4A9 },
+        { prof_t::Cesu8,        "\xF0\x9F\x92\xA9",             -1, 0       },
+        { prof_t::Cesu8,        "\xED\xA0\xBD" "a",             -1, 0       },
+        { prof_t::ModifiedUtf8, "a\xC0\x80",                    2,  0       },
+        { prof_t::ModifiedUtf8, "\xC0\x81",                     -1, 0       },
+        { prof_t::ModifiedUtf8, "\xED\xA0\xBD\xED\xB2\xA9",     1,  0x1F4A9 },
+        { prof_t::ModifiedUtf8, "\xED\xB2\xA9",                 1,  0xDCA9  },
+        { prof_t::Wtf8,         "a\xED\xA0\xBD",                2,  0xD83D  },
+        { prof_t::Wtf8,         "\xED\xA0\xBD\xED\xB2\xA9",     -1, 0       },
+        { prof_t::Wtf8,         "\xF0\x9F\x92\xA9\xED\xB2\xA9", 2,  0xDCA9  },
+    };
+
+    char32_t    buf32[16];
+    char16_t    buf16[16];
+    size_t      errors = 0;
+
+    printf("\ntesting UTF-8 profiles...\n");
+
+    for (size_t i = 0;  i < sizeof(cases) / sizeof(cases[0]);  ++i)
+    {
+        Case const&     tc   = cases[i];
+        char8_t const*  pSrc = reinterpret_cast<char8_t const*>(tc.pText);
+        char8_t const*  pEnd = pSrc + strlen(tc.pText);
+        ptrdiff_t       len  = UtfUtils::ProfileConvert(tc.prof, pSrc, pEnd, buf32);
+
+        if (len != tc.len32  ||  (len > 0  &&  buf32[len - 1] != tc.last))
+        {
+            printf("profile case %d: UTF-32 conversion returned %d\n", (int) i, (int) len);
+            ++errors;
+        }
+        if ((UtfUtils::ProfileConvert(tc.prof, pSrc, pEnd, buf16) < 0) != (tc.len32 < 0))
+        {
+            printf("profile case %d: UTF-16 conversion disagrees\n", (int) i);
+            ++errors;
+        }
+    }
+
+    //- A CESU-8 surrogate pair must transcode to the same UTF-16 pair as its UTF-8 equivalent.
+    //
+    char8_t const   cesu[] = { 0xED, 0xA0, 0xBD, 0xED, 0xB2, 0xA9 };
+
+    if (UtfUtils::ProfileConvert(prof_t::Cesu8, cesu, cesu + 6, buf16) != 2  ||
+        buf16[0] != 0xD83D  ||  buf16[1] != 0xDCA9)
+    {
+        printf("CESU-8 to UTF-16 transcoding failed\n");
+        ++errors;
+    }
+
+    //- Every scalar value must convert identically under the strict and WTF-8 profiles.
+    //
+    for (char32_t cdpt = 0;  cdpt < 0x110000;  ++cdpt)
+    {
+        if (0xD800 <= cdpt  &&  cdpt <= 0xDFFF)  continue;
+
+        char8_t     units[4];
+        char8_t*    pDst = units;
+        uint32_t    n    = UtfUtils::GetCodeUnits(cdpt, pDst);
+
+        for (prof_t prof : { prof_t::Utf8, prof_t::Wtf8 })
+        {
+            if (UtfUtils::ProfileConvert(prof, units, units + n, buf32) != 1  ||  buf32[0] != cdpt)
+            {
+                printf("profile %d: conversion error at code point 0x%X\n", (int) prof, (uint32_t) cdpt);
+                ++errors;
+            }
+        }
+    }
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
+
+//--------------
+//
+void
+TestDecoder()
+{
+    string      sample;
+    u32string   answer, result;
+    char32_t    out[7];
+    char32_t    cdpt;
+    size_t      errors = 0;
+
+    printf("\ntesting incremental decoder...\n");
+
+    for (int i = 0;  i < 16;  ++i)
+    {
+        sample += reinterpret_cast<char const*>(u8"kosme κόσμε 日本語 💩 ∀x∈ℝ ");
+    }
+
+    char8_t const*  pSrc = reinterpret_cast<char8_t const*>(sample.data());
+    char8_t const*  pEnd = pSrc + sample.size();
+
+    answer.resize(sample.size());
+    answer.resize((size_t) UtfUtils::SseConvert(pSrc, pEnd, &answer[0]));
+
+    //- Feed one code unit at a time.
+    //
+    UtfUtils::Decoder   dec;
+
+    for (char8_t const* p = pSrc;  p < pEnd;  ++p)
+    {
+        int32_t     status = dec.Next(*p, cdpt);
+
+        if (status < 0)  ++errors;
+        if (status > 0)  result.push_back(cdpt);
+    }
+    if (result != answer  ||  dec.IsPending())
+    {
+        printf("byte-at-a-time decoding differs\n");
+        ++errors;
+    }
+
+    //- Feed fragments of every size from 1 to 9 units into a small output buffer, so that both
+    //  input and output boundaries fall in every possible position within a sequence.
+    //
+    for (ptrdiff_t frag = 1;  frag <= 9;  ++frag)
+    {
+        result.clear();
+        dec.Reset();
+
+        for (char8_t const* p = pSrc;  p < pEnd;  )
+        {
+            char8_t const*  pFragEnd = std::min(p + frag, pEnd);
+
+            while (p < pFragEnd)
+            {
+                UtfUtils::Decoder::Result   res = dec.Next(p, pFragEnd, out, out + 7);
+
+                if (res.mError)  ++errors;
+                result.append(out, (size_t) res.mWritten);
+                p += res.mConsumed;
+            }
+        }
+        if (result != answer  ||  dec.IsPending())
+        {
+            printf("decoding in %d-unit fragments differs\n", (int) frag);
+            ++errors;
+        }
+    }
+
+    //- An invalid sequence is reported where it is found, and decoding resumes afterward with
+    //  the unit that cut it short, which is not consumed.
+    //
+    char8_t const   bad[] = { 'a', 0xE2, 0x82, 'b', 0xE2, 0x82, 0xAC };
+
+    dec.Reset();
+    UtfUtils::Decoder::Result   res = dec.Next(bad, bad + 7, out, out + 7);
+
+    if (!res.mError  ||  res.mConsumed != 3  ||  res.mWritten != 1)
+    {
+        printf("invalid sequence not reported correctly\n");
+        ++errors;
+    }
+    res = dec.Next(bad + 3, bad + 7, out, out + 7);
+    if (res.mError  ||  res.mConsumed != 4  ||  res.mWritten != 2  ||  out[0] != 'b'  ||  out[1] != 0x20AC)
+    {
+        printf("decoding did not resume after an invalid sequence\n");
+        ++errors;
+    }
+
+    //- The same, one code unit at a time: the unit that cuts the sequence short is fed again.
+    //
+    dec.Reset();
+    if (dec.Next(bad[0], cdpt) != 1  ||  dec.Next(bad[1], cdpt) != 0  ||  dec.Next(bad[2], cdpt) != 0  ||
+        dec.Next(bad[3], cdpt) != -2  ||  dec.Next(bad[3], cdpt) != 1  ||  cdpt != 'b')
+    {
+        printf("invalid sequence not reported correctly by the unit decoder\n");
+        ++errors;
+    }
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
@@ -0,0 +1,2165 @@
+﻿#include "test_main.h"
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "util/async_logger.hpp"
+#include "util/buffer_telemetry.hpp"
+#include "util/char_stream.hpp"
+#include "util/datagram_receiver.hpp"
+#include "util/record_ring.hpp"
+#include "util/ring_buffer.hpp"
+#include "util/shared_ring_buffer.hpp"
+#include "util/transcoding_stage.hpp"
+#include "util/transit_buffer.hpp"
+#include "util/unify.hpp"
+
+using namespace std;
+using namespace util;
+
+//- Random text of ASCII, Cyrillic, CJK and emoji, so that every UTF-8 and UTF-16 sequence length
+//  occurs.  Alongside the UTF-8 comes its transcoding to CharT, and for every byte offset into the
+//  UTF-8 the number of CharT units that the code points completed before it transcode to.
+//
+template<class CharT>
+static void
+MakeText(size_t count, uint32_t seed, u8string& text, basic_string<CharT>& ref, vector<size_t>& complete)
+{
+    mt19937     rng(seed);
+
+    text.clear();
+    ref.clear();
+    complete.assign(1, 0);
+
+    for (size_t i = 0;  i < count;  ++i)
+    {
+        uint32_t    kind = rng() % 4;
+        char32_t    cdpt = (kind == 0) ? 0x41 + rng() % 26
+                         : (kind == 1) ? 0x400 + rng() % 0x100
+                         : (kind == 2) ? 0x4E00 + rng() % 0x1000
+                         :               0x1F600 + rng() % 0x40;
+        size_t      before = ref.size();
+
+        if (cdpt < 0x80)
+        {
+            text.push_back((char8_t) cdpt);
+        }
+        else if (cdpt < 0x800)
+        {
+            text.push_back((char8_t) (0xC0 | (cdpt >> 6)));
+            text.push_back((char8_t) (0x80 | (cdpt & 0x3F)));
+        }
+        else if (cdpt < 0x10000)
+        {
+            text.push_back((char8_t) (0xE0 | (cdpt >> 12)));
+            text.push_back((char8_t) (0x80 | ((cdpt >> 6) & 0x3F)));
+            text.push_back((char8_t) (0x80 | (cdpt & 0x3F)));
+        }
+        else
+        {
+            text.push_back((char8_t) (0xF0 | (cdpt >> 18)));
+            text.push_back((char8_t) (0x80 | ((cdpt >> 12) & 0x3F)));
+            text.push_back((char8_t) (0x80 | ((cdpt >> 6) & 0x3F)));
+            text.push_back((char8_t) (0x80 | (cdpt & 0x3F)));
+        }
+
+        if (sizeof(CharT) == 4  ||  cdpt < 0x10000)
+        {
+            ref.push_back((CharT) cdpt);
+        }
+        else
+        {
+            ref.push_back((CharT) (0xD800 | ((cdpt - 0x10000) >> 10)));
+            ref.push_back((CharT) (0xDC00 | ((cdpt - 0x10000) & 0x3FF)));
+        }
+
+        complete.resize(text.size(), before);
+        complete.push_back(ref.size());
+    }
+}
+
+//- One thread writes a count into the buffer, the other reads it back; first through reservations
+//  and read blocks, then through move() and read().
+//
+template<class Buffer>
+static size_t
+StressStream(char const* name)
+{
+    auto            buffer = make_unique<Buffer>();
+    uint64_t const  count  = 30000;
+    atomic<size_t>  errors{0};
+
+    thread  producer([&]()
+    {
+        for (uint64_t value = 0;  value < count;  )
+        {
+            auto        handle = buffer->buffer(37);
+            uint32_t    size   = handle.capacity();
+
+            if (size == 0)  this_thread::yield();
+            if (size > count - value)  size = (uint32_t) (count - value);
+
+            for (uint32_t i = 0;  i < size;  ++i)  handle.data()[i] = value++;
+
+            handle.size(size);
+            buffer->commit(handle);
+        }
+
+        uint64_t    values[13];
+
+        for (uint64_t value = 0;  value < count;  value += 13)
+        {
+            for (uint64_t i = 0;  i < 13;  ++i)  values[i] = value + i;
+
+            buffer->move(values, 13);
+        }
+    });
+
+    for (uint64_t value = 0;  value < count;  )
+    {
+        auto        handle = buffer->read_block(29);
+        uint32_t    size   = handle.capacity();
+
+        if (size == 0)  this_thread::yield();
+        if (size > count - value)  size = (uint32_t) (count - value);
+
+        for (uint32_t i = 0;  i < size;  ++i)
+        {
+            if (handle.data()[i] != value++)  ++errors;
+        }
+        handle.size(size);
+        buffer->release(handle);
+    }
+
+    uint64_t    values[17];
+
+    for (uint64_t value = 0;  value < (count + 12) / 13 * 13;  )
+    {
+        uint32_t    size = buffer->read(values, 17);
+
+        if (size == 0)  this_thread::yield();
+
+        for (uint32_t i = 0;  i < size;  ++i)
+        {
+            if (values[i] != value++)  ++errors;
+        }
+    }
+    producer.join();
+
+    if (errors > 0)  printf("%s: values read back out of order\n", name);
+
+    return errors;
+}
+
+//- As above, through vectored reservations and reads of random sizes mixed with plain ones, so that
+//  both one- and two-span handles are filled and drained.
+//
+template<class Buffer>
+static size_t
+StressVectored(char const* name)
+{
+    auto            buffer = make_unique<Buffer>();
+    uint64_t const  count  = 20000;
+    atomic<size_t>  errors{0};
+
+    thread  producer([&]()
+    {
+        minstd_rand     rng(1);
+
+        for (uint64_t value = 0;  value < count;  )
+        {
+            if (rng() % 3 != 0)
+            {
+                auto        handle   = buffer->reserve_vectored(1 + rng() % 300);
+                uint32_t    capacity = handle.capacity();
+
+                if (capacity == 0)
+                {
+                    this_thread::yield();
+                    continue;
+                }
+
+                uint32_t    size = rng() % (capacity + 1);
+                uint32_t    done = 0;
+
+                if (size > count - value)  size = (uint32_t) (count - value);
+
+                for (int span = 0;  span < handle.iov_count()  &&  done < size;  ++span)
+                {
+                    uint64_t*   units = static_cast<uint64_t*>(handle.iov()[span].iov_base);
+                    size_t      len   = handle.iov()[span].iov_len / sizeof(uint64_t);
+
+                    for (size_t i = 0;  i < len  &&  done < size;  ++i, ++done)  units[i] = value++;
+                }
+                handle.size(size);
+                buffer->commit(handle);
+            }
+            else
+            {
+                auto        handle = buffer->buffer(17);
+                uint32_t    size   = handle.capacity();
+
+                if (size == 0)  this_thread::yield();
+                if (size > count - value)  size = (uint32_t) (count - value);
+
+                for (uint32_t i = 0;  i < size;  ++i)  handle.data()[i] = value++;
+
+                handle.size(size);
+                buffer->commit(handle);
+            }
+        }
+    });
+
+    minstd_rand     rng(7);
+
+    for (uint64_t value = 0;  value < count;  )
+    {
+        if (rng() % 2 != 0)
+        {
+            auto        handle   = buffer->read_vectored(1 + rng() % 400);
+            uint32_t    capacity = handle.capacity();
+
+            if (capacity == 0)
+            {
+                this_thread::yield();
+                continue;
+            }
+
+            uint32_t    size = rng() % (capacity + 1);
+            uint32_t    done = 0;
+
+            for (int span = 0;  span < handle.iov_count()  &&  done < size;  ++span)
+            {
+                uint64_t const* units = static_cast<uint64_t const*>(handle.iov()[span].iov_base);
+                size_t          len   = handle.iov()[span].iov_len / sizeof(uint64_t);
+
+                for (size_t i = 0;  i < len  &&  done < size;  ++i, ++done)
+                {
+                    if (units[i] != value++)  ++errors;
+                }
+            }
+            handle.size(size);
+            buffer->release(handle);
+        }
+        else
+        {
+            uint64_t    values[13];
+            uint32_t    size = buffer->read(values, 13);
+
+            if (size == 0)  this_thread::yield();
+
+            for (uint32_t i = 0;  i < size;  ++i)
+            {
+                if (values[i] != value++)  ++errors;
+            }
+        }
+    }
+    producer.join();
+
+    if (errors > 0)  printf("%s: vectored values read back out of order\n", name);
+
+    return errors;
+}
+
+//- A random sequence of reservations, reads and read blocks on one thread, recording every capacity
+//  and every byte read.
+//
+template<class Buffer>
+static vector<uint64_t>
+TraceBuffer(uint32_t seed)
+{
+    auto                buffer = make_unique<Buffer>();
+    vector<uint64_t>    trace;
+    minstd_rand         rng(seed);
+    uint32_t            value = 0;
+
+    for (int i = 0;  i < 100000;  ++i)
+    {
+        switch (rng() % 3)
+        {
+            case 0:
+            {
+                auto        handle   = buffer->buffer(1 + rng() % 40);
+                uint32_t    capacity = handle.capacity();
+                uint32_t    size     = capacity ? rng() % (capacity + 1) : 0;
+
+                trace.push_back(capacity);
+                for (uint32_t k = 0;  k < size;  ++k)  handle.data()[k] = (char) value++;
+
+                handle.size(size);
+                buffer->commit(handle);
+                break;
+            }
+            case 1:
+            {
+                char        chars[64];
+                uint32_t    size = buffer->read(chars, 1 + rng() % 60);
+
+                trace.push_back(size);
+                for (uint32_t k = 0;  k < size;  ++k)  trace.push_back((uchar) chars[k]);
+                break;
+            }
+            default:
+            {
+                auto        handle   = buffer->read_block(1 + rng() % 50);
+                uint32_t    capacity = handle.capacity();
+                uint32_t    size     = capacity ? rng() % (capacity + 1) : 0;
+
+                trace.push_back(1000 + capacity);
+                for (uint32_t k = 0;  k < size;  ++k)  trace.push_back((uchar) handle.data()[k]);
+
+                handle.size(size);
+                buffer->release(handle);
+                break;
+            }
+        }
+    }
+
+    return trace;
+}
+
+//- FNV-1a over a trace, so that a reference trace can be kept as one number.
+//
+static uint64_t
+DigestTrace(vector<uint64_t> const& trace)
+{
+    uint64_t    hash = 14695981039346656037ull;
+
+    for (uint64_t value : trace)  hash = (hash ^ value) * 1099511628211ull;
+
+    return hash;
+}
+
+//--------------
+//
+void
+TestRingBuffers()
+{
+    size_t  errors = 0;
+
+    printf("\ntesting ring and transit buffers...\n");
+
+    errors += StressStream<RingBuffer<uint64_t, uint32_t, 1000, SpscPolicy>>("spsc ring");
+    errors += StressStream<TransitBuffer<uint64_t, uint32_t, 1000, SpscPolicy>>("spsc transit");
+    errors += StressStream<RingBuffer<uint64_t, uint32_t, 1000>>("locked ring");
+    errors += StressStream<TransitBuffer<uint64_t, uint32_t, 1000>>("locked transit");
+    errors += StressStream<RingBuffer<uint64_t, uint32_t, 1000, SpscPolicy, MirroredPolicy>>("mirrored ring");
+    errors += StressStream<TransitBuffer<uint64_t, uint32_t, 1000, SpscPolicy, MirroredPolicy>>("mirrored transit");
+    errors += StressStream<RingBuffer<uint64_t, uint32_t, 1000, SpscPolicy, FutexWait>>("futex ring");
+    errors += StressStream<TransitBuffer<uint64_t, uint32_t, 1000, SpscPolicy, FutexWait>>("futex transit");
+    errors += StressStream<RingBuffer<uint64_t, uint32_t, 1000, SpscPolicy, EventFdWait>>("eventfd ring");
+    errors += StressStream<TransitBuffer<uint64_t, uint32_t, 1000, SpscPolicy, MirroredPolicy, EventFdWait>>("eventfd transit");
+
+    errors += StressVectored<RingBuffer<uint64_t, uint32_t, 1000, SpscPolicy>>("spsc ring");
+    errors += StressVectored<TransitBuffer<uint64_t, uint32_t, 1000, SpscPolicy>>("spsc transit");
+    errors += StressVectored<RingBuffer<uint64_t, uint32_t, 1000, SpscPolicy, MirroredPolicy>>("mirrored ring");
+
+    //- The readable eventfd of a ring, watched through epoll as a caller multiplexing it with
+    //  sockets would.  It is signalled only by a commit that finds the waiter armed, i.e. one that
+    //  takes the ring from empty to non-empty after arm(), and drain() clears it again.
+    //
+    {
+        using Ring = RingBuffer<char, uint32_t, 64, SpscPolicy, EventFdWait>;
+
+        Ring        ring;
+        auto&       waiter   = ring.readable_waiter();
+        int         epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        epoll_event event    = {};
+        char        chars[4];
+        size_t      wrong    = 0;
+
+        event.events = EPOLLIN;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, waiter.fd(), &event);
+
+        auto    signalled = [&]() { return epoll_wait(epoll_fd, &event, 1, 0) == 1; };
+        auto    ready     = [&]()
+        {
+            auto    block    = ring.read_block();
+            bool    readable = block.capacity() > 0;
+
+            block.size(0);
+            ring.release(block);
+            return readable;
+        };
+
+        wrong += !waiter.arm(ready);            //- empty, so armed
+        wrong += signalled();
+        ring.move("a", 1);                      //- empty -> non-empty while armed
+        wrong += !signalled();
+        waiter.drain();
+        wrong += signalled();
+        ring.move("b", 1);                      //- non-empty -> non-empty
+        wrong += signalled();
+        wrong += waiter.arm(ready);             //- already readable, so not armed
+        ring.move("c", 1);
+        wrong += signalled();
+        for (uint32_t size = 0;  size < 3;  )  size += ring.read(chars, 4);
+        ring.move("d", 1);                      //- empty -> non-empty, but never armed
+        wrong += signalled();
+        for (uint32_t size = 0;  size < 1;  )  size += ring.read(chars, 4);
+        wrong += !waiter.arm(ready);            //- empty again, so armed
+
+        //- A consumer that sleeps in epoll_wait() between blocks, against a producer that moves
+        //  values in small steps; every wake-up must arrive, or the wait times out.
+        //
+        auto            buffer = make_unique<RingBuffer<uint32_t, uint32_t, 256, SpscPolicy, EventFdWait>>();
+        auto&           values_waiter = buffer->readable_waiter();
+        uint32_t const  count  = 50000;
+
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, waiter.fd(), nullptr);
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, values_waiter.fd(), &event);
+
+        thread  producer([&]()
+        {
+            for (uint32_t value = 0;  value < count;  ++value)
+            {
+                buffer->move(&value, 1);
+                if (value % 64 == 0)  this_thread::yield();
+            }
+        });
+
+        for (uint32_t value = 0;  value < count;  )
+        {
+            auto    block = buffer->read_block();
+
+            if (block.capacity() == 0)
+            {
+                auto    probe = [&]() { return block = buffer->read_block(), block.capacity() > 0; };
+
+                if (values_waiter.arm(probe))
+                {
+                    if (epoll_wait(epoll_fd, &event, 1, 1000) != 1)  ++wrong;
+                    values_waiter.drain();
+                }
+                continue;
+            }
+
+            for (uint32_t i = 0;  i < block.capacity();  ++i)
+            {
+                if (block.data()[i] != value++)  ++wrong;
+            }
+            block.size(block.capacity());
+            buffer->release(block);
+        }
+        producer.join();
+        close(epoll_fd);
+
+        if (wrong > 0)
+        {
+            printf("eventfd of a ring signalled %d times out of turn\n", (int) wrong);
+            errors += wrong;
+        }
+    }
+
+    //- A mirrored ring hands out its free room as one span, across the wrap point.
+    //
+    {
+        auto    ring = make_unique<RingBuffer<char, uint16_t, 100, SpscPolicy, MirroredPolicy>>();
+        char    chars[3000] = {};
+        bool    contiguous  = true;
+
+        ring->move(chars, 3000);
+        (void) ring->read(chars, 3000);
+
+        auto    handle   = ring->buffer();
+        auto    capacity = handle.capacity();
+
+        for (unsigned i = 0;  i < capacity;  ++i)  handle.data()[i] = (char) i;
+        handle.size(capacity);
+        ring->commit(handle);
+
+        auto    block = ring->read_block();
+
+        contiguous = (block.capacity() == capacity);
+        for (unsigned i = 0;  contiguous  &&  i < block.capacity();  ++i)  contiguous = (block.data()[i] == (char) i);
+        block.size(block.capacity());
+        ring->release(block);
+
+        if (!contiguous)
+        {
+            printf("mirrored ring did not read back its whole room as one block\n");
+            ++errors;
+        }
+    }
+
+    //- Scatter/gather I/O straight from and into a ring whose free room wraps.
+    //
+    {
+        RingBuffer<char, uint32_t, 64, SpscPolicy>  ring;
+        char const  message[] = "the quick brown fox jumps over the lazy dog 0123456789";
+        size_t      length    = sizeof(message) - 1;
+        char        chars[64] = {};
+        int         fds[2];
+
+        ring.move(chars, 50);
+        (void) ring.read(chars, 50);
+
+        if (pipe(fds) == 0)
+        {
+            string  echoed;
+
+            if (write(fds[1], message, length) == (ssize_t) length)
+            {
+                auto    handle = ring.reserve_vectored((uint32_t) length);
+                ssize_t size   = readv(fds[0], handle.iov(), handle.iov_count());
+
+                handle.size(size > 0 ? (uint32_t) size : 0);
+                ring.commit(handle);
+            }
+            {
+                auto    handle = ring.read_vectored();
+                ssize_t size   = writev(fds[1], handle.iov(), handle.iov_count());
+
+                handle.size(size > 0 ? (uint32_t) size : 0);
+                ring.release(handle);
+
+                echoed.resize(size > 0 ? (size_t) size : 0);
+                if (!echoed.empty()  &&  read(fds[0], &echoed[0], echoed.size()) != (ssize_t) echoed.size())  echoed.clear();
+            }
+            close(fds[0]);
+            close(fds[1]);
+
+            if (echoed != message)
+            {
+                printf("readv/writev through a wrapped ring differs\n");
+                ++errors;
+            }
+        }
+    }
+
+    //- The general buffers replay a fixed trace exactly as they did when their states were
+    //  dispatched through tables of std::function.
+    //
+    {
+        uint64_t    ring    = DigestTrace(TraceBuffer<RingBuffer<char, uint32_t, 301>>(1));
+        uint64_t    transit = DigestTrace(TraceBuffer<TransitBuffer<char, uint32_t, 301>>(2));
+
+        if (ring != 0xAA0473BEFF26408Cull  ||  transit != 0x4E6DB6BCF35D0383ull)
+        {
+            printf("general buffers no longer replay their reference trace\n");
+            ++errors;
+        }
+    }
+
+    //- Storage from mmap, with or without huge pages, NUMA binding or zero-filling, behaves exactly
+    //  like storage from the heap.
+    //
+    {
+        auto    base   = TraceBuffer<RingBuffer<char, uint32_t, 301>>(1);
+        auto    spsc   = TraceBuffer<RingBuffer<char, uint32_t, 301, SpscPolicy>>(3);
+        auto    tbase  = TraceBuffer<TransitBuffer<char, uint32_t, 301>>(2);
+        auto    tspsc  = TraceBuffer<TransitBuffer<char, uint32_t, 301, SpscPolicy>>(4);
+        size_t  differ = 0;
+
+        differ += base  != TraceBuffer<RingBuffer<char, uint32_t, 301, HugePagePolicy<>>>(1);
+        differ += base  != TraceBuffer<RingBuffer<char, uint32_t, 301, HugePagePolicy<HugePages::Transparent>, NumaNodePolicy<0>>>(1);
+        differ += base  != TraceBuffer<RingBuffer<char, uint32_t, 301, NoZeroInitPolicy>>(1);
+        differ += spsc  != TraceBuffer<RingBuffer<char, uint32_t, 301, SpscPolicy, HugePagePolicy<HugePages::Size1G>, NoZeroInitPolicy>>(3);
+        differ += tbase != TraceBuffer<TransitBuffer<char, uint32_t, 301, HugePagePolicy<>, NumaNodePolicy<0>>>(2);
+        differ += tspsc != TraceBuffer<TransitBuffer<char, uint32_t, 301, SpscPolicy, NoZeroInitPolicy>>(4);
+
+        if (differ > 0)
+        {
+            printf("%d mapped buffers behave differently from heap ones\n", (int) differ);
+            errors += differ;
+        }
+
+        errors += StressStream<RingBuffer<uint64_t, uint32_t, 1000, SpscPolicy, HugePagePolicy<>, NoZeroInitPolicy>>("mapped ring");
+        errors += StressStream<TransitBuffer<uint64_t, uint32_t, 1000, SpscPolicy, NumaNodePolicy<0>>>("mapped transit");
+    }
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
+
+//--------------
+//
+void
+TestMpmcBuffer()
+{
+    using Buffer = RingBuffer<uint64_t, uint32_t, 1024, MpmcPolicy>;
+
+    int const       producers = 3;
+    int const       consumers = 2;
+    uint64_t const  count     = 100000;
+    auto            buffer    = make_unique<Buffer>();
+    atomic<uint64_t>    taken{0};
+    atomic<size_t>      errors{0};
+    vector<vector<uint8_t>> seen(producers, vector<uint8_t>(count, 0));
+    vector<thread>          threads;
+
+    printf("\ntesting the MPMC ring buffer...\n");
+
+    //- Every value is tagged with its producer; each must come out exactly once.  The last
+    //  producer goes through move(), the others through reservations of random sizes.
+    //
+    for (int p = 0;  p < producers;  ++p)
+    {
+        threads.emplace_back([&, p]()
+        {
+            minstd_rand     rng(p + 1);
+            uint64_t const  tag = (uint64_t) p << 40;
+
+            for (uint64_t value = 0;  value < count;  )
+            {
+                if (p == producers - 1)
+                {
+                    uint64_t    values[5];
+                    uint32_t    size = 0;
+
+                    for ( ;  size < 5  &&  value + size < count;  ++size)  values[size] = tag | (value + size);
+
+                    buffer->move(values, size);
+                    value += size;
+                    continue;
+                }
+
+                auto        handle   = buffer->buffer(1 + rng() % 50);
+                uint32_t    capacity = handle.capacity();
+
+                if (capacity == 0)
+                {
+                    this_thread::yield();
+                    continue;
+                }
+
+                uint32_t    size = rng() % (capacity + 1);
+
+                if (size > count - value)  size = (uint32_t) (count - value);
+
+                for (uint32_t i = 0;  i < size;  ++i)  handle.data()[i] = tag | value++;
+
+                handle.size(size);
+                buffer->commit(handle);
+            }
+        });
+    }
+
+    //- One consumer reads through read blocks, the other through read().  Each slot of seen[] is
+    //  written by whichever consumer got its value, once.
+    //
+    for (int c = 0;  c < consumers;  ++c)
+    {
+        threads.emplace_back([&, c]()
+        {
+            uint64_t    values[33];
+
+            while (taken.load() < producers * count)
+            {
+                uint32_t    size;
+
+                if (c == 0)
+                {
+                    auto    handle = buffer->read_block(33);
+
+                    size = handle.capacity();
+                    for (uint32_t i = 0;  i < size;  ++i)  values[i] = handle.data()[i];
+
+                    handle.size(size);
+                    buffer->release(handle);
+                }
+                else
+                {
+                    size = buffer->read(values, 33);
+                }
+
+                if (size == 0)
+                {
+                    this_thread::yield();
+                    continue;
+                }
+
+                for (uint32_t i = 0;  i < size;  ++i)
+                {
+                    uint64_t    p     = values[i] >> 40;
+                    uint64_t    value = values[i] & ((1ull << 40) - 1);
+
+                    if (p >= producers  ||  value >= count  ||  seen[p][value]++ != 0)  ++errors;
+                }
+                taken += size;
+            }
+        });
+    }
+
+    for (auto& t : threads)  t.join();
+
+    for (auto const& values : seen)
+    {
+        errors += (size_t) std::count(values.begin(), values.end(), (uint8_t) 0);
+    }
+
+    if (errors > 0)  printf("%d values lost or duplicated\n", (int) errors.load());
+
+    //- Move-assigning over a live reservation must commit it first, or the ring stalls at
+    //  its slot and neither block can be read.
+    //
+    {
+        auto        ring = make_unique<Buffer>();
+        uint64_t    values[16];
+
+        {
+            auto    first  = ring->buffer(8);
+            auto    second = ring->buffer(8);
+
+            for (uint64_t i = 0;  i < 8;  ++i)  first.data()[i]  = i;
+            for (uint64_t i = 0;  i < 8;  ++i)  second.data()[i] = 8 + i;
+
+            first.size(8);
+            second.size(8);
+            first = std::move(second);
+        }
+
+        uint32_t    size = ring->read(values, 16);
+
+        if (size != 16)
+        {
+            printf("read %u values after move-assign, expected 16\n", size);
+            ++errors;
+        }
+        for (uint32_t i = 0;  i < size;  ++i)
+        {
+            if (values[i] != i)  ++errors;
+        }
+    }
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
+
+//- A "\r\n" delimiter whose "\r" is the last element before the wrap point and whose "\n" is the
+//  first after it.  The ring is filled to four short of its end and two elements are drained, so
+//  the message goes in through a reservation that stops at the wrap and one that starts over the
+//  front; a mirrored buffer takes it as a single span across the wrap instead.
+//
+template<class Buffer>
+static size_t
+StraddleDelimiter(char const* name)
+{
+    auto            buffer   = make_unique<Buffer>();
+    uint32_t        capacity = 64;
+    char const      message[] = "abc\r\n";
+    vector<char>    filler;
+    vector<uint32_t>    reserved;
+    char            chars[64];
+    size_t          errors   = 0;
+
+    if constexpr (requires { buffer->capacity(); })  capacity = buffer->capacity();
+
+    filler.assign(capacity, 'f');
+    buffer->move(filler.data(), capacity - 4);
+    for (uint32_t size = 0;  size < 2;  )  size += buffer->read(filler.data(), 2 - size);
+
+    for (uint32_t size = 0;  size < 5;  )
+    {
+        auto        handle  = buffer->buffer(5 - size);
+        uint32_t    reserve = handle.capacity();
+
+        if (reserve == 0)  break;
+
+        for (uint32_t i = 0;  i < reserve;  ++i)  handle.data()[i] = message[size + i];
+
+        handle.size(reserve);
+        buffer->commit(handle);
+        reserved.push_back(reserve);
+        size += reserve;
+    }
+
+    for (uint32_t size = 0;  size < capacity - 6;  )  size += buffer->read(filler.data(), capacity - 6 - size);
+
+    auto [size, found] = buffer->read(chars, 64, "\r\n", 2);
+
+    if (reserved.empty()  ||  (reserved[0] != 4  &&  reserved[0] != 5))
+    {
+        printf("%s: message did not go in across the wrap point\n", name);
+        ++errors;
+    }
+    if (size != 5  ||  !found  ||  memcmp(chars, message, 5) != 0)
+    {
+        printf("%s: delimiter across the wrap point not found\n", name);
+        ++errors;
+    }
+
+    return errors;
+}
+
+//- Counts its calls and turns down the first 'reject' matches.
+//
+struct RejectDelimiter
+{
+    int     reject;
+    int*    calls;
+
+    bool operator()(const char*, const char*, const uint32_t) const
+    {
+        return ++*calls > reject;
+    }
+};
+
+//--------------
+//
+void
+TestDelimiterScan()
+{
+    size_t  errors = 0;
+
+    printf("\ntesting delimiter scans...\n");
+
+    //- Every offset of the match from 0 to 40, from aligned and unaligned starts and in ranges
+    //  that end just past it, so that the match is found by the 32-byte, the 16-byte and the
+    //  scalar loop in turn.
+    //
+    {
+        char    chars[128];
+
+        for (size_t start = 0;  start < 2;  ++start)
+        {
+            for (size_t offset = 0;  offset <= 40;  ++offset)
+            {
+                for (size_t length = offset + 1;  length <= offset + 48;  ++length)
+                {
+                    char const* first = chars + start;
+                    char const* last  = first + length;
+
+                    memset(chars, 'x', sizeof(chars));
+                    chars[start + offset] = '\n';
+                    if (find_value(first, last, '\n') != first + offset)  ++errors;
+
+                    chars[start + offset] = 'x';
+                    if (find_value(first, last, '\n') != last)  ++errors;
+                }
+            }
+        }
+
+        if (errors > 0)  printf("find_value missed or misplaced a match\n");
+    }
+
+    //- The same offsets through a delimited read, with a stray "\n" ahead of the "\r\n" that
+    //  must be passed over.
+    //
+    {
+        RingBuffer<char, uint32_t, 256, SpscPolicy>     ring;
+        char        chars[64];
+        string      message;
+
+        for (size_t offset = 0;  offset <= 40;  ++offset)
+        {
+            message.assign(offset, 'x');
+            if (offset > 0)  message[offset / 2] = '\n';
+            message += "\r\n";
+
+            ring.move(message.data(), (uint32_t) message.size());
+
+            auto [size, found] = ring.read(chars, 64, "\r\n", 2);
+
+            if (size != message.size()  ||  !found  ||  string(chars, size) != message)
+            {
+                printf("delimiter at offset %d not found\n", (int) offset);
+                ++errors;
+            }
+        }
+    }
+
+    errors += StraddleDelimiter<RingBuffer<char, uint32_t, 64>>("locked ring");
+    errors += StraddleDelimiter<RingBuffer<char, uint32_t, 64, SpscPolicy>>("spsc ring");
+    errors += StraddleDelimiter<RingBuffer<char, uint32_t, 64, SpscPolicy, MirroredPolicy>>("mirrored ring");
+    errors += StraddleDelimiter<TransitBuffer<char, uint32_t, 64>>("locked transit");
+    errors += StraddleDelimiter<TransitBuffer<char, uint32_t, 64, SpscPolicy>>("spsc transit");
+    errors += StraddleDelimiter<TransitBuffer<char, uint32_t, 64, SpscPolicy, MirroredPolicy>>("mirrored transit");
+
+    //- A predicate that turns down the first match makes the read run on to the second, through
+    //  the functor overload and the std::function one alike; one that turns down every match
+    //  reads until the destination is full.
+    //
+    {
+        using Ring = RingBuffer<char, uint32_t, 64>;
+
+        Ring        ring;
+        char        chars[64];
+        int         calls = 0;
+
+        ring.move("ab\r\ncd\r\n", 8);
+
+        auto [size, found] = ring.read(chars, 64, "\r\n", 2, RejectDelimiter{1, &calls});
+
+        if (size != 8  ||  !found  ||  calls != 2)
+        {
+            printf("rejected delimiter ended the read\n");
+            ++errors;
+        }
+
+        calls = 0;
+        ring.move("ab\r\ncd\r\n", 8);
+
+        auto [size2, found2] = ring.read(chars, 64, "\r\n", 2, Ring::CheckDelimiter(RejectDelimiter{1, &calls}));
+
+        if (size2 != 8  ||  !found2  ||  calls != 2)
+        {
+            printf("rejected delimiter ended the std::function read\n");
+            ++errors;
+        }
+
+        calls = 0;
+        ring.move("ab\r\ncd\r\n", 8);
+
+        auto [size3, found3] = ring.read(chars, 8, "\r\n", 2, RejectDelimiter{2, &calls});
+
+        if (size3 != 8  ||  found3  ||  calls != 2)
+        {
+            printf("read with every delimiter rejected did not stop at a full destination\n");
+            ++errors;
+        }
+    }
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
+
+//- Runs body in a child process, which leaves with _exit() so that nothing of the parent's is
+//  destroyed or flushed twice; exit status 0 means body returned true.  A body that must die
+//  with handles still open calls _exit() itself.
+//
+template<class Body>
+static pid_t
+ForkChild(Body&& body)
+{
+    pid_t   child = fork();
+
+    if (child == 0)
+    {
+        bool    ok = false;
+
+        try
+        {
+            ok = body();
+        }
+        catch (...)
+        {}
+        _exit(ok ? 0 : 1);
+    }
+    return child;
+}
+
+static bool
+ReapChild(pid_t child)
+{
+    int     status = 0;
+
+    return child > 0  &&  waitpid(child, &status, 0) == child  &&  WIFEXITED(status)  &&  WEXITSTATUS(status) == 0;
+}
+
+//- Whether attach() throws std::system_error with the given error code.
+//
+template<class Attach>
+static size_t
+CheckAttachFails(Attach&& attach, int error, char const* what)
+{
+    try
+    {
+        attach();
+    }
+    catch (system_error const& e)
+    {
+        if (e.code().value() == error)  return 0;
+    }
+
+    printf("attaching %s did not fail with %s\n", what, strerror(error));
+    return 1;
+}
+
+//--------------
+//
+void
+TestSharedRingBuffer()
+{
+    using Shared = SharedRingBuffer<uint32_t, uint32_t, 1024>;
+    using Role   = Shared::Role;
+
+    size_t  errors = 0;
+
+    printf("\ntesting shared ring buffers...\n");
+
+    //- A child process produces through the inherited memfd, the parent consumes.
+    //
+    {
+        Shared          ring;
+        uint32_t const  count = 100000;
+
+        ring.claim(Role::Consumer);
+
+        pid_t   child = ForkChild([&]()
+        {
+            Shared  peer(ring.fd());
+
+            if (!peer.claim(Role::Producer))  return false;
+
+            for (uint32_t value = 0;  value < count;  )
+            {
+                auto        handle = peer.buffer(37);
+                uint32_t    size   = handle.capacity();
+
+                if (size == 0)  this_thread::yield();
+                if (size > count - value)  size = count - value;
+
+                for (uint32_t i = 0;  i < size;  ++i)  handle.data()[i] = value++;
+
+                handle.size(size);
+                peer.commit(handle);
+            }
+            return true;
+        });
+
+        for (uint32_t value = 0;  value < count  &&  child > 0;  )
+        {
+            auto        block = ring.read_block(29);
+            uint32_t    size  = block.capacity();
+
+            if (size == 0)  this_thread::yield();
+
+            for (uint32_t i = 0;  i < size;  ++i)
+            {
+                if (block.data()[i] != value++)  ++errors;
+            }
+            block.size(size);
+            ring.release(block);
+        }
+
+        if (!ReapChild(child))
+        {
+            printf("shared ring producer process failed\n");
+            ++errors;
+        }
+    }
+
+    //- A producer that dies holding a reservation: its role cannot be claimed while it lives,
+    //  and is taken over once it is gone.  What it committed stays readable; the reservation it
+    //  left open is dropped, so that the new producer's reservations start where it stopped.
+    //
+    {
+        Shared      ring;
+        int         ready[2];
+        int         go[2];
+        char        byte  = 0;
+        size_t      wrong = 0;
+
+        if (pipe(ready) != 0  ||  pipe(go) != 0)
+        {
+            printf("pipe: %s\n", strerror(errno));
+            return;
+        }
+
+        pid_t   child = ForkChild([&]()
+        {
+            Shared  peer(ring.fd());
+
+            if (!peer.claim(Role::Producer))  return false;
+
+            auto    handle = peer.buffer(10);
+
+            for (uint32_t i = 0;  i < 10;  ++i)  handle.data()[i] = i;
+
+            handle.size(10);
+            peer.commit(handle);
+
+            auto    open = peer.buffer(20);
+
+            for (uint32_t i = 0;  i < open.capacity();  ++i)  open.data()[i] = 0xDEAD;
+
+            open.size(open.capacity());
+
+            //- Leave with the reservation open, before its handle's destructor can commit it.
+            //
+            bool    ok = write(ready[1], &byte, 1) == 1  &&  read(go[0], &byte, 1) == 1;
+
+            _exit(ok ? 0 : 1);
+            return ok;
+        });
+
+        wrong += read(ready[0], &byte, 1) != 1;
+        wrong += !ring.alive(Role::Producer);
+        wrong += ring.claim(Role::Producer);
+        wrong += write(go[1], &byte, 1) != 1;
+        wrong += !ReapChild(child);
+        wrong += ring.alive(Role::Producer);
+        wrong += !ring.claim(Role::Producer);
+        wrong += !ring.claim(Role::Consumer);
+
+        {
+            auto    block = ring.read_block();
+
+            wrong += block.capacity() != 10;
+            for (uint32_t i = 0;  i < block.capacity();  ++i)  wrong += block.data()[i] != i;
+            block.size(block.capacity());
+            ring.release(block);
+        }
+        {
+            auto    handle = ring.buffer(5);
+
+            wrong += handle.capacity() != 5;
+            for (uint32_t i = 0;  i < handle.capacity();  ++i)  handle.data()[i] = 10 + i;
+            handle.size(handle.capacity());
+            ring.commit(handle);
+        }
+        {
+            auto    block = ring.read_block();
+
+            wrong += block.capacity() != 5;
+            for (uint32_t i = 0;  i < block.capacity();  ++i)  wrong += block.data()[i] != 10 + i;
+            block.size(block.capacity());
+            ring.release(block);
+        }
+
+        for (int fd : {ready[0], ready[1], go[0], go[1]})  close(fd);
+
+        if (wrong > 0)
+        {
+            printf("dead producer not taken over cleanly\n");
+            errors += wrong;
+        }
+    }
+
+    //- abandon() on its own: the producer's open reservation is forgotten, so that the next one
+    //  starts at the same place.
+    //
+    {
+        SpscIndices<uint32_t>   indices(64, false);
+
+        auto [first, first_size]   = indices.reserve(10);
+        auto [busy, busy_size]     = indices.reserve(10);
+
+        indices.abandon();
+
+        auto [again, again_size]   = indices.reserve(10);
+
+        indices.commit(4);
+
+        auto [read, read_size]     = indices.readable(64);
+
+        if (first != 0  ||  first_size != 10  ||  busy_size != 0  ||  again != 0  ||  again_size != 10  ||  read != 0  ||  read_size != 4)
+        {
+            printf("abandon() did not drop the open reservation\n");
+            ++errors;
+        }
+    }
+
+    //- A consumer that dies between reading a block and releasing it: the next consumer gets
+    //  the block again, from the last release on.
+    //
+    {
+        Shared      ring;
+        size_t      wrong = 0;
+
+        ring.claim(Role::Producer);
+        {
+            auto    handle = ring.buffer(20);
+
+            for (uint32_t i = 0;  i < 20;  ++i)  handle.data()[i] = i;
+
+            handle.size(20);
+            ring.commit(handle);
+        }
+
+        pid_t   child = ForkChild([&]()
+        {
+            Shared  peer(ring.fd());
+            bool    ok = peer.claim(Role::Consumer);
+
+            {
+                auto    block = peer.read_block(5);
+
+                ok = ok  &&  block.capacity() == 5;
+                block.size(5);
+                peer.release(block);
+            }
+
+            auto    block = peer.read_block(8);
+
+            ok = ok  &&  block.capacity() == 8  &&  block.data()[0] == 5;
+
+            //- Leave without releasing the block.
+            //
+            _exit(ok ? 0 : 1);
+            return ok;
+        });
+
+        wrong += !ReapChild(child);
+        wrong += !ring.claim(Role::Consumer);
+
+        auto    block = ring.read_block();
+
+        wrong += block.capacity() != 15;
+        for (uint32_t i = 0;  i < block.capacity();  ++i)  wrong += block.data()[i] != 5 + i;
+        block.size(block.capacity());
+        ring.release(block);
+
+        if (wrong > 0)
+        {
+            printf("block held by a dead consumer not delivered again\n");
+            errors += wrong;
+        }
+    }
+
+    //- Segments that do not fit the attaching type are refused with EINVAL, and a missing named
+    //  segment with ENOENT.
+    //
+    {
+        Shared  ring;
+        int     blank = memfd_create("utf_utils_test", MFD_CLOEXEC);
+
+        errors += CheckAttachFails([&]() { SharedRingBuffer<uint32_t, uint32_t, 2048> peer(ring.fd()); }, EINVAL, "a segment too small");
+        errors += CheckAttachFails([&]() { SharedRingBuffer<uint32_t, uint32_t, 512> peer(ring.fd()); }, EINVAL, "a segment of another capacity");
+        errors += CheckAttachFails([&]() { SharedRingBuffer<uint64_t, uint32_t, 512> peer(ring.fd()); }, EINVAL, "a segment of another element size");
+
+        if (blank >= 0  &&  ftruncate(blank, 1 << 16) == 0)
+        {
+            errors += CheckAttachFails([&]() { Shared peer(blank); }, EINVAL, "a segment never initialized");
+        }
+        if (blank >= 0)  close(blank);
+
+        errors += CheckAttachFails([&]() { Shared peer("/utf_utils_test_no_such_ring"); }, ENOENT, "a missing named segment");
+    }
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
+
+//- Whether every counter of a snapshot is as expected.
+//
+static size_t
+CheckSnapshot(TelemetrySnapshot const& got, TelemetrySnapshot const& expected, char const* when)
+{
+    if (memcmp(&got, &expected, sizeof(TelemetrySnapshot)) == 0)  return 0;
+
+    printf("telemetry %s: occupancy %llu/%llu committed %llu released %llu reservations %llu wraps %llu short %llu empty %llu reads %llu empty %llu\n",
+           when, (unsigned long long) got.occupancy, (unsigned long long) got.peak_occupancy,
+           (unsigned long long) got.committed, (unsigned long long) got.released,
+           (unsigned long long) got.reservations, (unsigned long long) got.wraps,
+           (unsigned long long) got.short_reservations, (unsigned long long) got.empty_reservations,
+           (unsigned long long) got.reads, (unsigned long long) got.empty_reads);
+    return 1;
+}
+
+//--------------
+//
+void
+TestBufferTelemetry()
+{
+    using Ring = RingBuffer<char, uint32_t, 64, SpscPolicy, TelemetryPolicy>;
+
+    size_t  errors = 0;
+
+    printf("\ntesting buffer telemetry...\n");
+
+    //- One thread drives an SPSC ring of 64 (63 usable) through a short reservation at the
+    //  back, a wrap, a full ring and an empty read, so that every counter has an exact value.
+    //
+    {
+        Ring    ring;
+        auto&   telemetry = ring.telemetry();
+
+        auto    fill = [&](uint32_t requested)
+        {
+            auto        handle   = ring.buffer(requested);
+            uint32_t    capacity = handle.capacity();
+
+            handle.size(capacity);
+            if (capacity > 0)  ring.commit(handle);
+            return capacity;
+        };
+        auto    drain = [&](uint32_t requested)
+        {
+            auto        block    = ring.read_block(requested);
+            uint32_t    capacity = block.capacity();
+
+            block.size(capacity);
+            if (capacity > 0)  ring.release(block);
+            return capacity;
+        };
+
+        size_t  wrong = 0;
+
+        wrong += fill(40) != 40;            //- [0, 40)
+        wrong += drain(30) != 30;           //- 10 left
+        wrong += fill(40) != 24;            //- short: only [40, 64) at the back
+        wrong += fill(10) != 10;            //- wraps to [0, 10); 44 held, the peak
+        wrong += fill(30) != 19;            //- short: up to read - 1; 63 held, full
+        wrong += fill(5) != 0;              //- empty: the producer would stall
+
+        if (wrong > 0)  printf("telemetry ring filled differently than expected\n");
+
+        errors += wrong;
+        errors += CheckSnapshot(telemetry.snapshot(), TelemetrySnapshot{63, 63, 93, 30, 5, 1, 2, 1, 1, 0}, "when full");
+
+        wrong  = drain(64) != 10;           //- [30, 40), as far as the consumer last looked
+        wrong += drain(64) != 24;           //- the rest of the back, [40, 64)
+        wrong += drain(64) != 29;           //- the front, [0, 29)
+        wrong += drain(64) != 0;            //- empty read
+
+        if (wrong > 0)  printf("telemetry ring drained differently than expected\n");
+
+        errors += wrong;
+        errors += CheckSnapshot(telemetry.snapshot(true), TelemetrySnapshot{0, 63, 93, 93, 5, 1, 2, 1, 5, 1}, "when drained");
+
+        //- The peak started over from the occupancy of the previous snapshot.
+        //
+        fill(5);
+        errors += CheckSnapshot(telemetry.snapshot(), TelemetrySnapshot{5, 5, 98, 93, 6, 1, 2, 1, 5, 1}, "after a reset peak");
+
+        //- A sampler reports once more when it goes, here only then, and samples with the
+        //  peak reset as well.
+        //
+        vector<TelemetrySnapshot>   reports;
+
+        fill(10);
+        drain(15);
+        {
+            TelemetrySampler    sampler(telemetry, chrono::hours(1), [&](TelemetrySnapshot const& report) { reports.push_back(report); });
+        }
+
+        if (reports.size() != 1)
+        {
+            printf("telemetry sampler reported %d times, expected once\n", (int) reports.size());
+            ++errors;
+        }
+        else
+        {
+            errors += CheckSnapshot(reports[0], TelemetrySnapshot{0, 15, 108, 108, 7, 1, 2, 1, 6, 1}, "from the sampler");
+        }
+        errors += CheckSnapshot(telemetry.snapshot(), TelemetrySnapshot{0, 0, 108, 108, 7, 1, 2, 1, 6, 1}, "after the sampler");
+    }
+
+    //- Producers racing on an MPMC ring lose no count.
+    //
+    {
+        auto            ring    = make_unique<RingBuffer<uint32_t, uint32_t, 4096, MpmcPolicy, TelemetryPolicy>>();
+        vector<thread>  threads;
+
+        for (int t = 0;  t < 2;  ++t)
+        {
+            threads.emplace_back([&]()
+            {
+                for (uint32_t i = 0;  i < 1000;  ++i)
+                {
+                    auto    handle = ring->buffer(1);
+
+                    handle.data()[0] = i;
+                    handle.size(1);
+                    ring->commit(handle);
+                }
+            });
+        }
+        for (auto& t : threads)  t.join();
+
+        auto    counters = ring->telemetry().snapshot();
+
+        if (counters.reservations != 2000  ||  counters.committed != 2000  ||  counters.empty_reservations != 0)
+        {
+            printf("MPMC telemetry counted %llu reservations and %llu committed of 2000\n",
+                   (unsigned long long) counters.reservations, (unsigned long long) counters.committed);
+            ++errors;
+        }
+    }
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
+
+//--------------
+//
+template<class Ring>
+static size_t
+StressRecords(char const* name)
+{
+    auto            ring     = make_unique<Ring>();
+    uint32_t const  count    = 100000;
+    size_t          errors   = 0;
+    uint32_t        next     = 0;
+    minstd_rand     expected(3);
+    RecordRing<Ring>    records(*ring);
+
+    //- Record i is i itself followed by bytes derived from it, 4 to 299 bytes in all.
+    //
+    thread  producer([&]()
+    {
+        minstd_rand         rng(3);
+        vector<uint8_t>     payload(300);
+
+        for (uint32_t i = 0;  i < count;  ++i)
+        {
+            size_t  size = std::max<size_t>(rng() % 300, 4);
+
+            memcpy(payload.data(), &i, 4);
+            for (size_t k = 4;  k < size;  ++k)  payload[k] = (uint8_t) (i + k);
+
+            while (!records.push_record(span<uint8_t const>(payload.data(), size)))  this_thread::yield();
+        }
+    });
+
+    auto    check = [&](span<uint8_t const> payload)
+    {
+        size_t      size = std::max<size_t>(expected() % 300, 4);
+        uint32_t    i;
+
+        memcpy(&i, payload.data(), 4);
+        if (i != next  ||  payload.size() != size)  ++errors;
+
+        for (size_t k = 4;  k < payload.size();  ++k)
+        {
+            if (payload[k] != (uint8_t) (i + k))
+            {
+                ++errors;
+                break;
+            }
+        }
+        ++next;
+    };
+
+    while (next < count)
+    {
+        if (next % 3 == 0)
+        {
+            auto    payload = records.peek_record();
+
+            if (payload.data() != nullptr)
+            {
+                check(payload);
+                records.pop_record();
+            }
+            else
+            {
+                this_thread::yield();
+            }
+        }
+        else if (records.consume_records(check, 7) == 0)
+        {
+            this_thread::yield();
+        }
+    }
+    producer.join();
+
+    if (errors > 0)  printf("%s: records read back wrong\n", name);
+
+    return errors;
+}
+
+void
+TestRecordRing()
+{
+    size_t  errors = 0;
+
+    printf("\ntesting record rings...\n");
+
+    errors += StressRecords<RingBuffer<uint8_t, uint32_t, 4096, SpscPolicy, MirroredPolicy>>("mirrored ring");
+    errors += StressRecords<RingBuffer<uint8_t, uint32_t, 4096, SpscPolicy>>("spsc ring");
+    errors += StressRecords<RingBuffer<uint8_t, uint32_t, 4000, SpscPolicy>>("spsc ring of 4000");
+    errors += StressRecords<TransitBuffer<uint8_t, uint32_t, 4096, SpscPolicy>>("spsc transit");
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
+
+//--------------
+//
+static size_t
+CheckFormat(auto value, string const& expected)
+{
+    char                buf[64];
+    CharStream<char*>   stream(buf, 64);
+
+    stream << value;
+    if (string(buf, stream.length()) == expected)  return 0;
+
+    printf("formatted [%.*s], expected [%s]\n", (int) stream.length(), buf, expected.c_str());
+    return 1;
+}
+
+//- One thread inserts slices of the text and numbers into the ring through a CharStream, the other
+//  drains it.  The producer holds back until the ring has room for its next insertion, since a
+//  CharStream drops what doesn't fit.
+//
+template<class Ring>
+static size_t
+StressCharStream(char const* name)
+{
+    using CharT = typename Ring::value_type;
+
+    u8string                text;
+    basic_string<CharT>     ref, expected, result;
+    vector<size_t>          complete;
+    auto                    ring = make_unique<Ring>();
+    atomic<size_t>          drained{0};
+    atomic<bool>            done{false};
+    size_t const            room = ring->capacity() / 2;
+
+    MakeText(50000, 7, text, ref, complete);
+
+    thread  producer([&]()
+    {
+        CharStream<Ring>    stream(*ring);
+        minstd_rand         rng(11);
+
+        auto    wait_for = [&](size_t units)
+        {
+            while (expected.size() + units - drained.load(memory_order_acquire) > room)  this_thread::yield();
+        };
+
+        for (size_t pos = 0;  pos < text.size();  )
+        {
+            //- Numbers go in only between code points.
+            //
+            if (rng() % 8 == 0  &&  (text[pos] & 0xC0) != 0x80)
+            {
+                int64_t     number = (int64_t) rng() - (int64_t) rng();
+                string      digits = to_string(number);
+
+                wait_for(digits.size());
+                stream << number;
+                expected.append(digits.begin(), digits.end());
+                continue;
+            }
+
+            size_t  end = std::min(pos + 1 + rng() % 90, text.size());
+
+            wait_for(complete[end] - complete[pos]);
+            stream << u8string_view(text.data() + pos, end - pos);
+            expected.append(ref, complete[pos], complete[end] - complete[pos]);
+            pos = end;
+        }
+        done.store(true, memory_order_release);
+    });
+
+    for (;;)
+    {
+        bool    last  = done.load(memory_order_acquire);
+        auto    block = ring->read_block();
+        auto    size  = block.capacity();
+
+        result.append(block.data(), size);
+        drained.store(result.size(), memory_order_release);
+        block.size(size);
+        ring->release(block);
+
+        if (last  &&  size == 0)  break;
+        if (size == 0)  this_thread::yield();
+    }
+    producer.join();
+
+    if (result == expected)  return 0;
+
+    printf("%s: streamed text differs\n", name);
+    return 1;
+}
+
+void
+TestCharStream()
+{
+    mt19937_64  rng(5);
+    size_t      errors = 0;
+
+    printf("\ntesting character streams...\n");
+
+    for (int i = 0;  i < 200000;  ++i)
+    {
+        uint64_t    u = rng() >> (rng() % 64);
+        int64_t     s = (int64_t) rng() >> (rng() % 64);
+
+        errors += CheckFormat(u, to_string(u));
+        errors += CheckFormat(s, to_string(s));
+        errors += CheckFormat((int) s, to_string((int) s));
+        errors += CheckFormat((unsigned short) u, to_string((unsigned short) u));
+    }
+    errors += CheckFormat(INT64_MIN, to_string(INT64_MIN));
+    errors += CheckFormat(UINT64_MAX, to_string(UINT64_MAX));
+    errors += CheckFormat(0, "0");
+    errors += CheckFormat(0.1, "0.1");
+    errors += CheckFormat(1e300, "1e+300");
+    errors += CheckFormat(-2.5f, "-2.5");
+    errors += CheckFormat(FixedPoint<4>{1234500}, "123.4500");
+    errors += CheckFormat(FixedPoint<4>{-5}, "-0.0005");
+    errors += CheckFormat(FixedPoint<2>{INT64_MIN}, "-92233720368547758.08");
+    errors += CheckFormat(FixedPoint<19, uint64_t>{UINT64_MAX}, "1.8446744073709551615");
+
+    //- Doubles must read back exactly.
+    //
+    for (int i = 0;  i < 20000;  ++i)
+    {
+        char                buf[64];
+        CharStream<char*>   stream(buf, 63);
+        uint64_t            bits = rng();
+        double              value;
+
+        memcpy(&value, &bits, sizeof(value));
+        if (value != value)  continue;
+
+        stream << value;
+        buf[stream.length()] = 0;
+        if (strtod(buf, nullptr) != value)
+        {
+            printf("double formatted as [%s] does not read back\n", buf);
+            ++errors;
+        }
+    }
+
+    //- A char* stream cuts what doesn't fit.
+    //
+    {
+        char                buf[8];
+        CharStream<char*>   stream(buf, 5);
+
+        stream << "ab" << 123456;
+        if (string(buf, stream.length()) != "ab123")
+        {
+            printf("char* stream not cut at its end\n");
+            ++errors;
+        }
+    }
+
+    //- Mixed appends through a 64-byte ring, drained after each one, so that strings and numbers
+    //  keep meeting the wrap point.
+    //
+    {
+        using Ring = RingBuffer<char, uint32_t, 64, SpscPolicy>;
+
+        auto                ring = make_unique<Ring>();
+        CharStream<Ring>    stream(*ring);
+        string              expected, result;
+        char                chars[64];
+
+        for (int i = 0;  i < 10000;  ++i)
+        {
+            if (rng() % 2 == 0)
+            {
+                int64_t     number = (int64_t) rng() >> (rng() % 64);
+
+                stream << number;
+                expected += to_string(number);
+            }
+            else
+            {
+                string  piece(1 + rng() % 40, (char) ('a' + i % 26));
+
+                stream << piece;
+                expected += piece;
+            }
+
+            for (uint32_t size;  (size = ring->read(chars, 64)) > 0;  )  result.append(chars, size);
+        }
+
+        if (result != expected)
+        {
+            printf("appends across the wrap of a ring differ\n");
+            ++errors;
+        }
+    }
+
+    errors += StressCharStream<RingBuffer<char16_t, uint32_t, 256, SpscPolicy>>("char16_t ring");
+    errors += StressCharStream<RingBuffer<char32_t, uint32_t, 256, SpscPolicy>>("char32_t ring");
+    errors += StressCharStream<TransitBuffer<char16_t, uint32_t, 257, SpscPolicy>>("char16_t transit");
+    errors += StressCharStream<RingBuffer<char16_t, uint32_t, 4096, SpscPolicy, MirroredPolicy>>("mirrored char16_t ring");
+    errors += StressCharStream<RingBuffer<char32_t, uint32_t, 4096, SpscPolicy, MirroredPolicy>>("mirrored char32_t ring");
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
+
+//--------------
+//
+void
+TestUniFyInPlace()
+{
+    size_t  errors = 0;
+
+    printf("\ntesting UniFy in place...\n");
+
+    //- UniFy works in place in its output, as char32_t; it must not touch anything past the
+    //  transcoder's worst case, which may be ring memory not yet read.  The guard looks like UTF-8
+    //  leading bytes when read as char32_t.
+    //
+    for (int64_t size = 1;  size <= 64;  ++size)
+    {
+        u8string            units(size, u8'k');
+        vector<char32_t>    area(size + 16, 0x000000E2);
+        auto [written, consumed] = UniFy<char16_t, char8_t, false, false>::transcode(reinterpret_cast<char16_t*>(area.data()), units.data(), size);
+
+        if (written != size  ||  consumed != size  ||  std::count(area.begin() + size, area.end(), 0x000000E2) != 16)
+        {
+            printf("transcoding %d units wrote past the output\n", (int) size);
+            ++errors;
+        }
+    }
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
+
+//--------------
+//
+void
+TestTranscodingStage()
+{
+    using In    = TransitBuffer<char8_t, uint32_t, 4096, SpscPolicy>;
+    using Out   = TransitBuffer<char16_t, uint32_t, 4096, SpscPolicy>;
+    using Stage = TranscodingStage<In, Out, UniFy<char16_t, char8_t, false, false>>;
+
+    u8string        text;
+    u16string       ref, result;
+    vector<size_t>  complete;
+    auto            input  = make_unique<In>();
+    auto            output = make_unique<Out>();
+    size_t          errors = 0;
+
+    printf("\ntesting the transcoding stage...\n");
+
+    MakeText(200000, 1, text, ref, complete);
+
+    //- The producer writes the text in chunks that cut sequences anywhere; the stage runs on this
+    //  thread, between the producer and the drain.
+    //
+    thread  producer([&]()
+    {
+        minstd_rand     rng(1);
+
+        for (size_t sent = 0;  sent < text.size();  )
+        {
+            auto        handle = input->buffer((uint32_t) std::min<size_t>(1 + rng() % 1500, text.size() - sent));
+            uint32_t    size   = handle.capacity();
+
+            if (size == 0)  this_thread::yield();
+
+            memcpy(handle.data(), text.data() + sent, size);
+            sent += size;
+            handle.size(size);
+            input->commit(handle);
+        }
+    });
+
+    Stage           stage(*input, *output);
+    minstd_rand     rng(2);
+
+    while (result.size() < ref.size())
+    {
+        auto [consumed, produced] = stage.pump();
+
+        for (;;)
+        {
+            auto    block = output->read_block(1 + rng() % 700);
+
+            if (block.capacity() == 0)  break;
+
+            result.append(block.data(), block.capacity());
+            block.size(block.capacity());
+            output->release(block);
+        }
+
+        if (consumed == 0  &&  produced == 0)  this_thread::yield();
+    }
+    producer.join();
+
+    if (result != ref  ||  stage.carried() != 0)
+    {
+        printf("transcoded text differs\n");
+        ++errors;
+    }
+
+    //- A carried sequence is completed as soon as the output has room for its code point, however
+    //  much of the next block is waiting behind it.
+    //
+    {
+        using SmallIn  = TransitBuffer<char8_t, uint32_t, 64, SpscPolicy>;
+        using SmallOut = TransitBuffer<char16_t, uint32_t, 64, SpscPolicy>;
+
+        auto        in     = make_unique<SmallIn>();
+        auto        out    = make_unique<SmallOut>();
+        char8_t     head[] = { 'x', 0xF0, 0x9F };
+        char8_t     tail[] = { 0x98, 0x80, 'y', 'z', 'w' };
+        u16string   text;
+
+        TranscodingStage<SmallIn, SmallOut, UniFy<char16_t, char8_t, false, false>>  small(*in, *out);
+
+        in->move(head, 3);
+        (void) small.pump();
+        in->move(tail, 5);
+
+        //- Leave two units free in the output, behind the 'x' and the filler: enough for the
+        //  surrogate pair alone.
+        //
+        {
+            auto    filler = out->buffer();
+
+            filler.size(filler.capacity() - 2);
+            out->commit(filler);
+        }
+
+        auto [consumed, produced] = small.step();
+
+        if (consumed != 2  ||  produced != 2  ||  small.carried() != 0)
+        {
+            printf("carried sequence not completed into a nearly full output\n");
+            ++errors;
+        }
+
+        for (;;)
+        {
+            auto    block = out->read_block();
+
+            if (block.capacity() == 0)  break;
+
+            text.append(block.data(), block.capacity());
+            block.size(block.capacity());
+            out->release(block);
+            (void) small.pump();
+        }
+
+        if (text.size() < 6  ||  text[0] != u'x'  ||  text.compare(text.size() - 5, 5, u"\U0001F600yzw") != 0)
+        {
+            printf("text carried across a nearly full output differs\n");
+            ++errors;
+        }
+    }
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
+
+//--------------
+//
+template<class OutT, uint32_t t_Ring_Size>
+static size_t
+StressLogger(char const* name, int threads, int records, bool lossless)
+{
+    FILE*       file = tmpfile();
+    uint64_t    dropped;
+    size_t      errors = 0;
+
+    if (file == nullptr)  return 0;
+
+    {
+        AsyncLogger<OutT, t_Ring_Size, 8>   logger(fileno(file));
+        vector<thread>                      loggers;
+
+        for (int t = 0;  t < threads;  ++t)
+        {
+            loggers.emplace_back([&, t]()
+            {
+                (void) logger.attach();
+
+                for (int i = 0;  i < records;  ++i)
+                {
+                    logger.log() << "t" << t << " i=" << i << " px=" << FixedPoint<2>{i} << " ж";
+                }
+            });
+        }
+        for (auto& t : loggers)  t.join();
+
+        logger.flush();
+        dropped = logger.dropped();
+        errors += logger.write_errors();
+    }
+
+    //- Every line that was not dropped comes out whole, and each thread's lines in order.
+    //
+    basic_string<OutT>  contents;
+    vector<int>         last(threads, -1);
+    size_t              lines = 0;
+
+    fseek(file, 0, SEEK_END);
+    contents.resize((size_t) ftell(file) / sizeof(OutT));
+    rewind(file);
+    if (fread(&contents[0], sizeof(OutT), contents.size(), file) != contents.size())  ++errors;
+    fclose(file);
+
+    for (size_t pos = 0;  pos < contents.size();  ++lines)
+    {
+        size_t  end = contents.find(OutT('\n'), pos);
+
+        if (end == basic_string<OutT>::npos)
+        {
+            ++errors;
+            break;
+        }
+
+        string  line;
+
+        for (size_t k = pos;  k < end;  ++k)  line.push_back(contents[k] < 0x80 ? (char) contents[k] : '?');
+        pos = end + 1;
+
+        int     t, i, whole, cents, length = 0;
+
+        if (sscanf(line.c_str(), "t%d i=%d px=%d.%d %n", &t, &i, &whole, &cents, &length) != 4  ||
+            t < 0  ||  t >= threads  ||  i <= last[t]  ||  whole != i / 100  ||  cents != i % 100  ||
+            line.size() != (size_t) length + (sizeof(OutT) == 1 ? 2 : 1))
+        {
+            ++errors;
+            continue;
+        }
+        last[t] = i;
+    }
+
+    if (lines + dropped != (size_t) threads * records  ||  (lossless  &&  dropped != 0))
+    {
+        printf("%s: %zu lines written and %zu dropped of %d\n", name, lines, (size_t) dropped, threads * records);
+        ++errors;
+    }
+    else if (errors > 0)
+    {
+        printf("%s: log lines garbled or out of order\n", name);
+    }
+
+    return errors;
+}
+
+void
+TestAsyncLogger()
+{
+    size_t  errors = 0;
+
+    printf("\ntesting the asynchronous logger...\n");
+
+    errors += StressLogger<char8_t, (1u << 16)>("UTF-8 log", 2, 20000, false);
+    errors += StressLogger<char16_t, (1u << 16)>("UTF-16 log", 2, 20000, false);
+
+    //- Six threads logging 50,000 records each as fast as they can: rings sized for the whole
+    //  burst lose nothing, however far the writer falls behind.
+    //
+    errors += StressLogger<char8_t, (1u << 22)>("six-thread UTF-8 log", 6, 50000, true);
+    errors += StressLogger<char16_t, (1u << 22)>("six-thread UTF-16 log", 6, 50000, true);
+
+    //- Threads that alternate between two loggers keep one ring in each; with room for just two
+    //  threads per logger, nothing may be lost to taking more.
+    //
+    {
+        FILE*       files[2] = { tmpfile(), tmpfile() };
+        uint64_t    dropped  = 0;
+        int const   records  = 1000;
+
+        if (files[0] != nullptr  &&  files[1] != nullptr)
+        {
+            {
+                AsyncLogger<char8_t, (1u << 16), 2>     first(fileno(files[0]));
+                AsyncLogger<char8_t, (1u << 16), 2>     second(fileno(files[1]));
+                vector<thread>                          loggers;
+
+                for (int t = 0;  t < 2;  ++t)
+                {
+                    loggers.emplace_back([&, t]()
+                    {
+                        for (int i = 0;  i < records;  ++i)
+                        {
+                            ((i % 2 == 0) ? first : second).log() << "t" << t << " i=" << i;
+                            if (i % 64 == 63)  this_thread::yield();
+                        }
+                    });
+                }
+                for (auto& t : loggers)  t.join();
+
+                first.flush();
+                second.flush();
+                dropped = first.dropped() + second.dropped();
+            }
+
+            size_t  lines = 0;
+
+            for (FILE* file : files)
+            {
+                rewind(file);
+                for (int c;  (c = fgetc(file)) != EOF;  )  lines += (c == '\n');
+            }
+
+            if (dropped != 0  ||  lines != 2 * records)
+            {
+                printf("alternating loggers: %zu lines written and %zu dropped of %d\n", lines, (size_t) dropped, 2 * records);
+                ++errors;
+            }
+        }
+
+        for (FILE* file : files)
+        {
+            if (file != nullptr)  fclose(file);
+        }
+    }
+
+    //- A record stamped first but committed last still comes out first, however many drains
+    //  pass while it is held open: the writer holds back the other thread's newer record.
+    //
+    {
+        FILE*           file = tmpfile();
+        atomic<int>     step{0};
+
+        if (file != nullptr)
+        {
+            {
+                AsyncLogger<char8_t, (1u << 16), 4>     logger(fileno(file), chrono::microseconds(50));
+
+                thread  older([&]()
+                {
+                    auto    record = logger.log();
+
+                    record << "older";
+                    step.store(1);
+                    while (step.load() < 2)  this_thread::yield();
+                    this_thread::sleep_for(chrono::milliseconds(20));
+                });
+                thread  newer([&]()
+                {
+                    while (step.load() < 1)  this_thread::yield();
+                    logger.log() << "newer";
+                    step.store(2);
+                });
+
+                older.join();
+                newer.join();
+                logger.flush();
+            }
+
+            char    text[32] = {};
+
+            rewind(file);
+            if (fread(text, 1, sizeof(text) - 1, file) != 12  ||  string(text) != "older\nnewer\n")
+            {
+                printf("record held open was written after a newer one\n");
+                ++errors;
+            }
+            fclose(file);
+        }
+    }
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
+
+//--------------
+//
+void
+TestDatagramReceiver()
+{
+    using In       = TransitBuffer<char8_t, uint32_t, 1500, SpscPolicy>;
+    using Out      = TransitBuffer<char16_t, uint32_t, (1u << 16), SpscPolicy>;
+    using Hook     = TranscodeHook<Out, UniFy<char16_t, char8_t, false, false>>;
+    using Receiver = DatagramReceiver<In, Hook, 4, 512>;
+
+    int             rx = socket(AF_INET, SOCK_DGRAM, 0);
+    int             tx = socket(AF_INET, SOCK_DGRAM, 0);
+    int             rcvbuf = 1 << 22;
+    sockaddr_in     addr{};
+    socklen_t       addrlen = sizeof(addr);
+    size_t          errors = 0;
+
+    printf("\ntesting the datagram receiver...\n");
+
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (rx < 0  ||  tx < 0  ||
+        setsockopt(rx, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf)) != 0  ||
+        bind(rx, (sockaddr*) &addr, sizeof(addr)) != 0  ||
+        getsockname(rx, (sockaddr*) &addr, &addrlen) != 0)
+    {
+        printf("    ... no loopback socket, skipped\n");
+        if (rx >= 0)  close(rx);
+        if (tx >= 0)  close(tx);
+        return;
+    }
+
+    //- The input holds fewer than three slots, so receive() keeps meeting a region shorter than
+    //  one slot and has to wait for the larger one; a second thread drains both buffers, the
+    //  input one record, i.e. one datagram, at a time.
+    //
+    auto                input  = make_unique<In>();
+    auto                output = make_unique<Out>();
+    Receiver            receiver(*input, rx, Hook(*output));
+    RecordRing<In>      records(*input);
+    vector<u8string>    expected, received;
+    u16string           expected16, received16;
+    atomic<bool>        done{false};
+
+    thread  consumer([&]()
+    {
+        for (;;)
+        {
+            bool    last   = done.load(memory_order_acquire);
+            auto    popped = records.consume_records([&](span<char8_t const> datagram)
+                             {
+                                 received.emplace_back(datagram.begin(), datagram.end());
+                             });
+            auto    units  = output->read_block();
+            bool    empty  = popped == 0  &&  records.peek_record().empty()  &&  units.capacity() == 0;
+
+            received16.append(units.data(), units.capacity());
+            units.size(units.capacity());
+            output->release(units);
+
+            if (last  &&  empty)  break;
+            if (empty)  this_thread::yield();
+        }
+    });
+
+    int const   count = 3000;
+    size_t      sent  = 0;
+    size_t      taken = 0;
+
+    for (int i = 0;  i < count  &&  errors == 0;  ++i)
+    {
+        u8string    message;
+        u16string   message16;
+
+        for (int k = 0;  k <= i % 40;  ++k)
+        {
+            message   += (k % 3 == 0) ? u8"ж" : (k % 3 == 1) ? u8"x" : u8"中";
+            message16 += (k % 3 == 0) ? u"ж"  : (k % 3 == 1) ? u"x"  : u"中";
+        }
+
+        //- Now and then one too long for a slot, which is discarded.
+        //
+        if (i % 500 == 7)
+        {
+            message.assign(600, u8'a');
+            message16.clear();
+        }
+        else
+        {
+            expected.push_back(message);
+            expected16 += message16;
+        }
+
+        if (sendto(tx, message.data(), message.size(), 0, (sockaddr*) &addr, sizeof(addr)) == (ssize_t) message.size())
+        {
+            ++sent;
+        }
+
+        if (i % 20 != 19  &&  i != count - 1)  continue;
+
+        auto    deadline = chrono::steady_clock::now() + chrono::seconds(10);
+
+        while (taken + receiver.truncated() < sent)
+        {
+            auto [datagrams, bytes] = receiver.receive();
+
+            taken += datagrams;
+            if (datagrams == 0)  this_thread::yield();
+
+            if (chrono::steady_clock::now() > deadline)
+            {
+                printf("receiver stalled after %zu of %zu datagrams\n", taken, sent);
+                ++errors;
+                break;
+            }
+        }
+    }
+
+    done.store(true, memory_order_release);
+    consumer.join();
+    close(rx);
+    close(tx);
+
+    if (errors == 0  &&  (received != expected  ||  receiver.truncated() != (size_t) (count + 492) / 500))
+    {
+        printf("received datagrams differ\n");
+        ++errors;
+    }
+    if (errors == 0  &&  (received16 != expected16  ||  receiver.hook().dropped() != 0  ||  receiver.hook().malformed() != 0))
+    {
+        printf("transcoded datagrams differ\n");
+        ++errors;
+    }
+
+    if (errors == 0) printf("    ... no errors found\n");
+}
@@ -3,8 +3,6 @@
 using namespace std;
 using namespace uu;
 
-using TestFn16 = ptrdiff_t (*)(string const&, size_t, u16string&);
-
 //--------------
 //
 ptrdiff_t
@@ -336,6 +334,55 @@ Convert16_KewbSse(string const& src, size_t reps, u16string& dst)
     return dstLen;
 }
 
+//--------------
+//
+ptrdiff_t
+Convert16_KewbTuned(string const& src, size_t reps, u16string& dst)
+{
+    char8_t const*  pSrcBuf = (char8_t const*) &src[0]; //- Pointer to source buffer
+    char8_t const*  pSrcEnd = pSrcBuf + src.size();     //- Pointer to end of source buffer
+    char16_t*       pDstBuf = &dst[0];                  //- Pointer to destination buffer
+    ptrdiff_t       dstLen  = 0;
+
+    for (uint64_t i = 0;  i < reps;  ++i)
+    {
+        dstLen = UtfUtils::TunedConvert(pSrcBuf, pSrcEnd, pDstBuf);
+    }
+
+    return dstLen;
+}
+
+//--------------
+//
+converter_list16 const&
+Converters16()
+{
+    static converter_list16 const   converters =
+    {
+        { "iconv",                   &Convert16_Iconv,           ConverterSet::Common,   false },
+        { "llvm",                    &Convert16_Llvm,            ConverterSet::Common,   false },
+#ifdef KEWB_COMPILER_MSVC
+        { "win32-mbtowc",            &Convert16_MS,              ConverterSet::Common,   false },
+#endif
+        { "std::codecvt",            &Convert16_Codecvt,         ConverterSet::Common,   false },
+        { "Boost.Text",              &Convert16_BoostText,       ConverterSet::Common,   false },
+        { "Hoehrmann",               &Convert16_Hoehrmann,       ConverterSet::Common,   false },
+        { "Karthik",                 &Convert16_Karthik,         ConverterSet::Common,   false },
+        { "kewb-basic-small-table",  &Convert16_KewbBasicSmTab,  ConverterSet::TableCmp, false },
+        { "kewb-basic-big-table",    &Convert16_KewbBasicBgTab,  ConverterSet::TableCmp, false },
+        { "kewb-fast-small-table",   &Convert16_KewbFastSmTab,   ConverterSet::TableCmp, false },
+        { "kewb-fast-big-table",     &Convert16_KewbFastBgTab,   ConverterSet::TableCmp, false },
+        { "kewb-sse-small-table",    &Convert16_KewbSseSmTab,    ConverterSet::TableCmp, false },
+        { "kewb-sse-big-table",      &Convert16_KewbSseBgTab,    ConverterSet::TableCmp, false },
+        { "kewb-basic",              &Convert16_KewbBasic,       ConverterSet::Default,  false },
+        { "kewb-fast",               &Convert16_KewbFast,        ConverterSet::Default,  false },
+        { "kewb-sse",                &Convert16_KewbSse,         ConverterSet::Default,  false },
+        { "kewb-tuned",              &Convert16_KewbTuned,       ConverterSet::Default,  true  }
+    };
+
+    return converters;
+}
+
 //--------------------------------------------------------------------------------------------------
 //
 int64_t
@@ -347,7 +394,8 @@ TestOneConversion16
     tm_pt       start, finish;
     int64_t     tmdiff;
     ptrdiff_t   dstLen;
-    u16string   dst(2 * src.size(), 0u);
+    u16string   dst(4 * src.size(), 0u);    //- UniFy works in 32-bit slots, and runs over twice
+                                            //  that when the input ends in ASCII
 
     start  = chrono::high_resolution_clock::now();
     dstLen = fn(src, reps, dst);
@@ -410,76 +458,27 @@ TestAllConversions16(string const& fname, bool isFile, size_t repShift, bool tbl
 
     //- Run the individual tests.
     //
-    tdiff = TestOneConversion16(&Convert16_Iconv, u8src, reps, u16answer, "iconv");
-    times.push_back(tdiff);
-    algos.emplace_back("iconv");
-
-    tdiff = TestOneConversion16(&Convert16_Llvm, u8src, reps, u16answer, "llvm");
-    times.push_back(tdiff);
-    algos.emplace_back("llvm");
-
-#ifdef KEWB_COMPILER_MSVC
-    tdiff = TestOneConversion16(&Convert16_MS, u8src, reps, u16answer, "win32-mbtowc");
-    times.push_back(tdiff);
-    algos.emplace_back("win32-mbtowc");
-#endif
-
-    tdiff = TestOneConversion16(&Convert16_Codecvt, u8src, reps, u16answer, "std::codecvt");
-    times.push_back(tdiff);
-    algos.emplace_back("std::codecvt");
-
-    tdiff = TestOneConversion16(&Convert16_BoostText, u8src, reps, u16answer, "Boost.Text");
-    times.push_back(tdiff);
-    algos.emplace_back("Boost.Text");
-
-    tdiff = TestOneConversion16(&Convert16_Hoehrmann, u8src, reps, u16answer, "hoehrmann");
-    times.push_back(tdiff);
-    algos.emplace_back("Hoehrmann");
-
-    tdiff = TestOneConversion16(&Convert16_Karthik, u8src, reps, u16answer, "karthik");
-    times.push_back(tdiff);
-    algos.emplace_back("Karthik");
-
-    if (tblCmp)
+    for (auto const& conv : Converters16())
     {
-        tdiff = TestOneConversion16(&Convert16_KewbBasicSmTab, u8src, reps, u16answer, "kewb-basic-small-table");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-basic-small-table");
-
-        tdiff = TestOneConversion16(&Convert16_KewbBasicBgTab, u8src, reps, u16answer, "kewb-basic-big-table");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-basic-big-table");
-
-        tdiff = TestOneConversion16(&Convert16_KewbFastSmTab, u8src, reps, u16answer, "kewb-fast-small-table");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-fast-small-table");
-
-        tdiff = TestOneConversion16(&Convert16_KewbFastBgTab, u8src, reps, u16answer, "kewb-fast-big-table");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-fast-big-table");
+        if (!conv.InSet(tblCmp))
+        {
+            continue;
+        }
 
-        tdiff = TestOneConversion16(&Convert16_KewbSseSmTab, u8src, reps, u16answer, "kewb-sse-small-table");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-sse-small-table");
+        if (conv.tuned)
+        {
+            //- Calibrate on this file's contents outside the timed region.
+            //
+            UtfUtils::Tune((char8_t const*) u8src.data(), (char8_t const*) u8src.data() + u8src.size());
+            printf("    kewb-tuned selected: %s\n", UtfUtils::GetTunedName((char16_t const*) nullptr));
+        }
 
-        tdiff = TestOneConversion16(&Convert16_KewbSseBgTab, u8src, reps, u16answer, "kewb-sse-big-table");
+        tdiff = TestOneConversion16(conv.fn, u8src, reps, u16answer, conv.name);
         times.push_back(tdiff);
-        algos.emplace_back("kewb-sse-big-table");
+        algos.emplace_back(conv.name);
     }
-    else
-    {
-        tdiff = TestOneConversion16(&Convert16_KewbBasic, u8src, reps, u16answer, "kewb-basic");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-basic");
-
-        tdiff = TestOneConversion16(&Convert16_KewbFast, u8src, reps, u16answer, "kewb-fast");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-fast");
 
-        tdiff = TestOneConversion16(&Convert16_KewbSse, u8src, reps, u16answer, "kewb-sse");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-sse");
-    }
+    printUnifyPhaseStats16();
 
     return tuple<name_list, time_list>(algos, times);
 }
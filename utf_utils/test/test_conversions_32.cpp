@@ -3,8 +3,6 @@
 using namespace std;
 using namespace uu;
 
-using TestFn32 = ptrdiff_t (*)(string const&, size_t, u32string&);
-
 //--------------
 //
 ptrdiff_t
@@ -334,6 +332,53 @@ Convert32_KewbSse(string const& src, size_t reps, u32string& dst)
     return dstLen;
 }
 
+//--------------
+//
+ptrdiff_t
+Convert32_KewbTuned(string const& src, size_t reps, u32string& dst)
+{
+    char8_t const*  pSrcBuf = (char8_t const*) &src[0]; //- Pointer to source buffer
+    char8_t const*  pSrcEnd = pSrcBuf + src.size();     //- Pointer to end of source buffer
+    char32_t*       pDstBuf = &dst[0];                  //- Pointer to destination buffer
+    ptrdiff_t       dstLen  = 0;
+
+    for (uint64_t i = 0;  i < reps;  ++i)
+    {
+        dstLen = UtfUtils::TunedConvert(pSrcBuf, pSrcEnd, pDstBuf);
+    }
+
+    return dstLen;
+}
+
+//--------------
+//
+converter_list32 const&
+Converters32()
+{
+    static converter_list32 const   converters =
+    {
+        { "iconv",                   &Convert32_Iconv,           ConverterSet::Common,   false },
+        { "llvm",                    &Convert32_Llvm,            ConverterSet::Common,   false },
+        { "av",                      &Convert32_Av,              ConverterSet::Common,   false },
+        { "std::codecvt",            &Convert32_Codecvt,         ConverterSet::Common,   false },
+        { "Boost.Text",              &Convert32_BoostText,       ConverterSet::Common,   false },
+        { "Hoehrmann",               &Convert32_Hoehrmann,       ConverterSet::Common,   false },
+        { "Karthik",                 &Convert32_Karthik,         ConverterSet::Common,   false },
+        { "kewb-basic-small-table",  &Convert32_KewbBasicSmTab,  ConverterSet::TableCmp, false },
+        { "kewb-basic-big-table",    &Convert32_KewbBasicBgTab,  ConverterSet::TableCmp, false },
+        { "kewb-fast-small-table",   &Convert32_KewbFastSmTab,   ConverterSet::TableCmp, false },
+        { "kewb-fast-big-table",     &Convert32_KewbFastBgTab,   ConverterSet::TableCmp, false },
+        { "kewb-sse-small-table",    &Convert32_KewbSseSmTab,    ConverterSet::TableCmp, false },
+        { "kewb-sse-big-table",      &Convert32_KewbSseBgTab,    ConverterSet::TableCmp, false },
+        { "kewb-basic",              &Convert32_KewbBasic,       ConverterSet::Default,  false },
+        { "kewb-fast",               &Convert32_KewbFast,        ConverterSet::Default,  false },
+        { "kewb-sse",                &Convert32_KewbSse,         ConverterSet::Default,  false },
+        { "kewb-tuned",              &Convert32_KewbTuned,       ConverterSet::Default,  true  }
+    };
+
+    return converters;
+}
+
 //--------------------------------------------------------------------------------------------------
 //
 int64_t
@@ -408,74 +453,27 @@ TestAllConversions32(string const& fname, bool isFile, size_t repShift, bool tbl
 
     //- Run the individual tests.
     //
-    tdiff = TestOneConversion32(&Convert32_Iconv, u8src, reps, u32answer, "iconv");
-    times.push_back(tdiff);
-    algos.emplace_back("iconv");
-
-    tdiff = TestOneConversion32(&Convert32_Llvm, u8src, reps, u32answer, "llvm");
-    times.push_back(tdiff);
-    algos.emplace_back("llvm");
-
-    tdiff = TestOneConversion32(&Convert32_Av, u8src, reps, u32answer, "av");
-    times.push_back(tdiff);
-    algos.emplace_back("av");
-
-    tdiff = TestOneConversion32(&Convert32_Codecvt, u8src, reps, u32answer, "std::codecvt");
-    times.push_back(tdiff);
-    algos.emplace_back("std::codecvt");
-
-    tdiff = TestOneConversion32(&Convert32_BoostText, u8src, reps, u32answer, "Boost.Text");
-    times.push_back(tdiff);
-    algos.emplace_back("Boost.Text");
-
-    tdiff = TestOneConversion32(&Convert32_Hoehrmann, u8src, reps, u32answer, "hoehrmann");
-    times.push_back(tdiff);
-    algos.emplace_back("Hoehrmann");
-
-    tdiff = TestOneConversion32(&Convert32_Karthik, u8src, reps, u32answer, "karthik");
-    times.push_back(tdiff);
-    algos.emplace_back("Karthik");
-
-    if (tblCmp)
+    for (auto const& conv : Converters32())
     {
-        tdiff = TestOneConversion32(&Convert32_KewbBasicSmTab, u8src, reps, u32answer, "kewb-basic-small-table");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-basic-small-table");
-
-        tdiff = TestOneConversion32(&Convert32_KewbBasicBgTab, u8src, reps, u32answer, "kewb-basic-big-table");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-basic-big-table");
-
-        tdiff = TestOneConversion32(&Convert32_KewbFastSmTab, u8src, reps, u32answer, "kewb-fast-small-table");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-fast-small-table");
-
-        tdiff = TestOneConversion32(&Convert32_KewbFastBgTab, u8src, reps, u32answer, "kewb-fast-big-table");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-fast-big-table");
+        if (!conv.InSet(tblCmp))
+        {
+            continue;
+        }
 
-        tdiff = TestOneConversion32(&Convert32_KewbSseSmTab, u8src, reps, u32answer, "kewb-sse-small-table");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-sse-small-table");
+        if (conv.tuned)
+        {
+            //- Calibrate on this file's contents outside the timed region.
+            //
+            UtfUtils::Tune((char8_t const*) u8src.data(), (char8_t const*) u8src.data() + u8src.size());
+            printf("    kewb-tuned selected: %s\n", UtfUtils::GetTunedName((char32_t const*) nullptr));
+        }
 
-        tdiff = TestOneConversion32(&Convert32_KewbSseBgTab, u8src, reps, u32answer, "kewb-sse-big-table");
+        tdiff = TestOneConversion32(conv.fn, u8src, reps, u32answer, conv.name);
         times.push_back(tdiff);
-        algos.emplace_back("kewb-sse-big-table");
+        algos.emplace_back(conv.name);
     }
-    else
-    {
-        tdiff = TestOneConversion32(&Convert32_KewbBasic, u8src, reps, u32answer, "kewb-basic");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-basic");
-
-        tdiff = TestOneConversion32(&Convert32_KewbFast, u8src, reps, u32answer, "kewb-fast");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-fast");
 
-        tdiff = TestOneConversion32(&Convert32_KewbSse, u8src, reps, u32answer, "kewb-sse");
-        times.push_back(tdiff);
-        algos.emplace_back("kewb-sse");
-    }
+    printUnifyPhaseStats32();
 
     return tuple<name_list, time_list>(algos, times);
 }
@@ -0,0 +1,95 @@
+﻿#include "test_main.h"
+
+using namespace std;
+
+#if defined KEWB_PLATFORM_LINUX
+    #define KEWB_PATH_SEP   '/'
+#elif defined KEWB_PLATFORM_WINDOWS
+    #define KEWB_PATH_SEP   '\\'
+#endif
+
+
+//--------------
+//
+vector<string>
+LoadFileLines(string const& filename)
+{
+    string          line;
+    vector<string>  lines;
+    ifstream        in(filename, ios::in | ios::binary);
+
+    lines.reserve(1000);
+
+    if (in)
+    {
+        while (!in.eof())
+        {
+            getline(in, line);
+            if (line.size() > 0)
+            {
+                lines.push_back(line);
+            }
+        }
+        in.close();
+    }
+    return lines;
+}
+
+string
+LoadFile(string const& filename)
+{
+    string      line;
+    ifstream    in(filename, ios::in | ios::binary);
+
+    if (in)
+    {
+        in.seekg(0, ios_base::end);
+        line.resize((size_t) in.tellg());   //- Cast is there to make 32-bit Windows happy
+        in.seekg(0, ios_base::beg);
+        in.read(&line[0], line.size());
+        in.close();
+    }
+    return line;
+}
+
+string
+MakeFilePath(std::string const& dir, std::string const& filename)
+{
+    string  path;
+
+    if (dir.size() > 0)
+    {
+        path.assign(dir);
+
+        if (path.back() != KEWB_PATH_SEP)
+        {
+            path.append(1u, KEWB_PATH_SEP);
+        }
+    }
+    path.append(filename);
+
+    return path;
+}
+
+void
+MakeFileList(file_list& files)
+{
+    files.clear();
+
+    files.emplace_back("english_wiki.txt");
+    files.emplace_back("chinese_wiki.txt");
+    files.emplace_back("hindi_wiki.txt");
+    files.emplace_back("japanese_wiki.txt");
+    files.emplace_back("korean_wiki.txt");
+    files.emplace_back("portuguese_wiki.txt");
+    files.emplace_back("russian_wiki.txt");
+    files.emplace_back("swedish_wiki.txt");
+    files.emplace_back("stress_test_0.txt");
+    files.emplace_back("stress_test_1.txt");
+    files.emplace_back("stress_test_2.txt");
+    files.emplace_back("hindi_wiki_in_english.txt");
+    files.emplace_back("hindi_wiki_in_russian.txt");
+    files.emplace_back("kermit.txt");
+    files.emplace_back("z1_kosme.txt");
+    files.emplace_back("z1_ascii.txt");
+}
@@ -12,6 +12,7 @@
 #include <tuple>
 #include <vector>
 
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -38,15 +39,63 @@ using file_list  = std::vector<std::string>;
 using name_list  = std::vector<std::string>;
 using time_list  = std::vector<std::int64_t>;
 using time_table = std::vector<time_list>;
+using TestFn16   = std::ptrdiff_t (*)(std::string const&, size_t, std::u16string&);
+using TestFn32   = std::ptrdiff_t (*)(std::string const&, size_t, std::u32string&);
+
+//- The engines compared by the UTF-8 to UTF-16/32 conversion tests and by utf_utils_benchmark.
+//  The small/big table variants make up the -tct comparison, in place of the kewb defaults.
+//
+enum class ConverterSet : std::uint8_t
+{
+    Common,         //- Always run
+    Default,        //- Run unless comparing tables
+    TableCmp        //- Run only when comparing tables
+};
+
+template<class TestFn>
+struct Converter
+{
+    char const*     name;
+    TestFn          fn;
+    ConverterSet    set;
+    bool            tuned;      //- Calibrate UtfUtils::Tune() on the input before timing
+
+    bool    InSet(bool tblCmp) const
+            {
+                return set == ConverterSet::Common || (set == ConverterSet::TableCmp) == tblCmp;
+            }
+};
+
+using converter_list16 = std::vector<Converter<TestFn16>>;
+using converter_list32 = std::vector<Converter<TestFn32>>;
 
 name_list       LoadFileLines(std::string const& filename);
 std::string     LoadFile(std::string const& filename);
 std::string     MakeFilePath(std::string const& dir, std::string const& filename);
 void            MakeFileList(file_list& files);
 
+converter_list16 const&     Converters16();
+converter_list32 const&     Converters32();
+
 void    TestTrace();
 void    TestBadSequences();
 void    TestRoundTripping();
+void    TestReverseDecoding();
+void    TestTunedConversion();
+void    TestDfaCounters();
+void    TestProfiles();
+void    TestDecoder();
+void    TestRingBuffers();
+void    TestMpmcBuffer();
+void    TestDelimiterScan();
+void    TestSharedRingBuffer();
+void    TestBufferTelemetry();
+void    TestRecordRing();
+void    TestCharStream();
+void    TestUniFyInPlace();
+void    TestTranscodingStage();
+void    TestAsyncLogger();
+void    TestDatagramReceiver();
 void    TestFiles16(std::string const& dataDir, size_t repShift, file_list const& files, bool tblCmp);
 void    TestFiles32(std::string const& dataDir, size_t repShift, file_list const& files, bool tblCmp);
 